@@ -0,0 +1,72 @@
+/**
+ * Copyright (c) 2014 rxi (https://github.com/rxi/vec)
+ *
+ * v0.3.x modifications (c) 2022 Jacob Repp (https://github.com/jrepp/vec)
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the MIT license. See https://github.com/rxi/vec/LICENSE for details.
+ */
+
+#ifndef INCLUDED_VEC_BENCH_HELP_H
+#define INCLUDED_VEC_BENCH_HELP_H
+
+// Override the allocators with the counting bench allocators
+#define VEC_CONFIG_H "vec_config_bench.h"
+#include "vec.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+// A single measurement, one row of output
+typedef struct {
+  const char *op;
+  const char *type;
+  size_t elem_size;
+  size_t length;
+  size_t ops;
+  uint64_t elapsed_ns;
+  size_t bytes;
+  uint64_t start_ns;
+  size_t start_bytes;
+} bench_t;
+
+// counters maintained by the bench allocator (see bench_mem.c)
+extern size_t bench_alloc_bytes;
+extern size_t bench_alloc_calls;
+
+// minimum number of element operations per measurement (--min-work)
+extern size_t bench_min_work;
+
+// largest thread count of the vec_par suite (--threads), 0 for one per online CPU
+extern int bench_max_threads;
+
+// written by benchmarks so the optimizer can't discard the measured work
+extern volatile uint64_t bench_sink;
+
+uint64_t bench_now_ns(void);
+
+// True when the op and type pass the --op and --type filters
+int bench_enabled(const char *op, const char *type);
+
+// Iterate the requested lengths: 10, 100, 1000, ... bounded by --min-length and --max-length
+size_t bench_first_length(void);
+size_t bench_next_length(size_t length);
+
+// Number of repetitions so that `rounds * work` covers at least bench_min_work
+size_t bench_rounds(size_t work);
+
+// Deterministic pseudo random sequence for filling inputs
+uint64_t bench_rand(uint64_t *state);
+
+// Measurement lifecycle, only the time and allocations between resume and pause are counted
+void bench_begin(bench_t *b, const char *op, const char *type, size_t elem_size, size_t length);
+void bench_resume(bench_t *b);
+void bench_pause(bench_t *b, size_t ops);
+void bench_end(bench_t *b);
+
+#define bench_foreach_length(n) \
+  for ((n) = bench_first_length(); (n) != 0; (n) = bench_next_length(n))
+
+#endif // INCLUDED_VEC_BENCH_HELP_H
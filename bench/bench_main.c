@@ -0,0 +1,236 @@
+/**
+ * Copyright (c) 2014 rxi (https://github.com/rxi/vec)
+ *
+ * v0.3.x modifications (c) 2022 Jacob Repp (https://github.com/jrepp/vec)
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the MIT license. See https://github.com/rxi/vec/LICENSE for details.
+ */
+
+#if !defined(_WIN32)
+#define _POSIX_C_SOURCE 199309L
+#include <time.h>
+#else
+#include <windows.h>
+#endif
+
+#include "bench_help.h"
+
+extern void bench_vec_ops(void);
+extern void bench_vec_par(void);
+
+typedef void (*bench_func)(void);
+
+typedef struct {
+  const char *name;
+  bench_func func;
+} bench_suite_t;
+
+bench_suite_t suites[] = {
+  { "vec_ops", bench_vec_ops },
+  { "vec_par", bench_vec_par },
+};
+
+typedef enum {
+  BENCH_FORMAT_CSV,
+  BENCH_FORMAT_JSON
+} bench_format_t;
+
+size_t bench_min_work = (size_t)1 << 20;
+int bench_max_threads = 0;
+volatile uint64_t bench_sink = 0;
+
+static bench_format_t format = BENCH_FORMAT_CSV;
+static size_t min_length = 10;
+static size_t max_length = 1000000;
+static const char *op_filter = NULL;
+static const char *type_filter = NULL;
+static size_t rows = 0;
+
+uint64_t bench_now_ns(void) {
+#if defined(_WIN32)
+  LARGE_INTEGER freq, count;
+  QueryPerformanceFrequency(&freq);
+  QueryPerformanceCounter(&count);
+  return (uint64_t)((double)count.QuadPart * 1e9 / (double)freq.QuadPart);
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+// Filters are comma separated lists of exact names
+static int filter_match(const char *filter, const char *name) {
+  size_t len = strlen(name);
+  while (filter != NULL && *filter) {
+    const char *end = strchr(filter, ',');
+    size_t n = end ? (size_t)(end - filter) : strlen(filter);
+    if (n == len && 0 == strncmp(filter, name, n)) {
+      return 1;
+    }
+    filter = end ? end + 1 : NULL;
+  }
+  return 0;
+}
+
+int bench_enabled(const char *op, const char *type) {
+  return (op_filter == NULL || filter_match(op_filter, op)) &&
+         (type_filter == NULL || filter_match(type_filter, type));
+}
+
+size_t bench_first_length(void) {
+  size_t n = 10;
+  while (n < min_length) n *= 10;
+  return n <= max_length ? n : 0;
+}
+
+size_t bench_next_length(size_t length) {
+  size_t n = length * 10;
+  return n <= max_length ? n : 0;
+}
+
+size_t bench_rounds(size_t work) {
+  if (work == 0 || work >= bench_min_work) {
+    return 1;
+  }
+  return (bench_min_work + work - 1) / work;
+}
+
+uint64_t bench_rand(uint64_t *state) {
+  // xorshift64*
+  uint64_t x = *state;
+  x ^= x >> 12;
+  x ^= x << 25;
+  x ^= x >> 27;
+  *state = x;
+  return x * 0x2545f4914f6cdd1dull;
+}
+
+void bench_begin(bench_t *b, const char *op, const char *type, size_t elem_size, size_t length) {
+  memset(b, 0, sizeof(bench_t));
+  b->op = op;
+  b->type = type;
+  b->elem_size = elem_size;
+  b->length = length;
+}
+
+void bench_resume(bench_t *b) {
+  b->start_bytes = bench_alloc_bytes;
+  b->start_ns = bench_now_ns();
+}
+
+void bench_pause(bench_t *b, size_t ops) {
+  b->elapsed_ns += bench_now_ns() - b->start_ns;
+  b->bytes += bench_alloc_bytes - b->start_bytes;
+  b->ops += ops;
+}
+
+void bench_end(bench_t *b) {
+  double ns_per_op = b->ops ? (double)b->elapsed_ns / (double)b->ops : 0.0;
+  double bytes_per_op = b->ops ? (double)b->bytes / (double)b->ops : 0.0;
+  if (format == BENCH_FORMAT_JSON) {
+    printf("%s  {\"op\": \"%s\", \"type\": \"%s\", \"elem_size\": %zu, \"length\": %zu, "
+           "\"ops\": %zu, \"ns_per_op\": %.3f, \"bytes_per_op\": %.3f}",
+           rows ? ",\n" : "",
+           b->op, b->type, b->elem_size, b->length, b->ops, ns_per_op, bytes_per_op);
+  } else {
+    printf("%s,%s,%zu,%zu,%zu,%.3f,%.3f\n",
+           b->op, b->type, b->elem_size, b->length, b->ops, ns_per_op, bytes_per_op);
+  }
+  fflush(stdout);
+  rows++;
+}
+
+static void usage(const char *name) {
+  fprintf(stderr,
+          "usage: %s [options]\n"
+          "  --format csv|json     output format (default csv)\n"
+          "  --min-length N        smallest vector length (default 10)\n"
+          "  --max-length N        largest vector length (default 1000000)\n"
+          "  --min-work N          element operations per measurement (default 1048576)\n"
+          "  --op a,b,...          only run the named operations\n"
+          "  --type a,b,...        only run the named element types\n"
+          "  --suite a,b,...       only run the named suites\n"
+          "  --threads N           largest thread count of the vec_par suite (default one per CPU)\n"
+          "  --simd none|sse2|avx2 limit the SIMD level of the vector kernels\n",
+          name);
+}
+
+static int parse_size(const char *s, size_t *out) {
+  char *end = NULL;
+  unsigned long long value = strtoull(s, &end, 10);
+  if (end == s || *end != '\0') {
+    return -1;
+  }
+  *out = (size_t)value;
+  return 0;
+}
+
+int main(int argc, char **argv) {
+  const char *suite_filter = NULL;
+  for (int i = 1; i < argc; ++i) {
+    const char *arg = argv[i];
+    const char *value = (i + 1 < argc) ? argv[i + 1] : NULL;
+    int ok = value != NULL;
+    if (0 == strcmp(arg, "--format") && ok) {
+      if (0 == strcmp(value, "json")) {
+        format = BENCH_FORMAT_JSON;
+      } else if (0 == strcmp(value, "csv")) {
+        format = BENCH_FORMAT_CSV;
+      } else {
+        ok = 0;
+      }
+    } else if (0 == strcmp(arg, "--min-length") && ok) {
+      ok = 0 == parse_size(value, &min_length);
+    } else if (0 == strcmp(arg, "--max-length") && ok) {
+      ok = 0 == parse_size(value, &max_length);
+    } else if (0 == strcmp(arg, "--min-work") && ok) {
+      ok = 0 == parse_size(value, &bench_min_work);
+    } else if (0 == strcmp(arg, "--op") && ok) {
+      op_filter = value;
+    } else if (0 == strcmp(arg, "--type") && ok) {
+      type_filter = value;
+    } else if (0 == strcmp(arg, "--suite") && ok) {
+      suite_filter = value;
+    } else if (0 == strcmp(arg, "--threads") && ok) {
+      size_t threads = 0;
+      ok = 0 == parse_size(value, &threads) && threads > 0 && threads <= 4096;
+      bench_max_threads = (int)threads;
+    } else if (0 == strcmp(arg, "--simd") && ok) {
+      if (0 == strcmp(value, "none")) {
+        vec_simd_set_level(VEC_SIMD_NONE);
+      } else if (0 == strcmp(value, "sse2")) {
+        vec_simd_set_level(VEC_SIMD_SSE2);
+      } else if (0 == strcmp(value, "avx2")) {
+        vec_simd_set_level(VEC_SIMD_AVX2);
+      } else {
+        ok = 0;
+      }
+    } else {
+      ok = 0;
+    }
+    if (!ok) {
+      usage(argv[0]);
+      return -1;
+    }
+    ++i;
+  }
+
+  if (format == BENCH_FORMAT_JSON) {
+    printf("[\n");
+  } else {
+    printf("op,type,elem_size,length,ops,ns_per_op,bytes_per_op\n");
+  }
+
+  for (size_t i = 0; i < vec_countof(suites); ++i) {
+    if (suite_filter == NULL || filter_match(suite_filter, suites[i].name)) {
+      suites[i].func();
+    }
+  }
+
+  if (format == BENCH_FORMAT_JSON) {
+    printf("\n]\n");
+  }
+  return 0;
+}
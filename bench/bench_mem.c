@@ -0,0 +1,31 @@
+/**
+ * Copyright (c) 2014 rxi (https://github.com/rxi/vec)
+ *
+ * v0.3.x modifications (c) 2022 Jacob Repp (https://github.com/jrepp/vec)
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the MIT license. See https://github.com/rxi/vec/LICENSE for details.
+ */
+
+#include "bench_help.h"
+
+// Unlike the test allocator this does no validation, it only counts the bytes
+// requested so the benchmarks can report bytes/op without skewing ns/op.
+size_t bench_alloc_bytes = 0;
+size_t bench_alloc_calls = 0;
+
+void *bench_malloc(size_t bytes) {
+  bench_alloc_bytes += bytes;
+  bench_alloc_calls++;
+  return malloc(bytes);
+}
+
+void *bench_realloc(void *p, size_t bytes) {
+  bench_alloc_bytes += bytes;
+  bench_alloc_calls++;
+  return realloc(p, bytes);
+}
+
+void bench_free(void *p) {
+  free(p);
+}
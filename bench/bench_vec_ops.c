@@ -0,0 +1,1193 @@
+/**
+ * Copyright (c) 2014 rxi (https://github.com/rxi/vec)
+ *
+ * v0.3.x modifications (c) 2022 Jacob Repp (https://github.com/jrepp/vec)
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the MIT license. See https://github.com/rxi/vec/LICENSE for details.
+ */
+
+#include "bench_help.h"
+#include "vec_seg.h"
+#include "vec_deque.h"
+#include "vec_soa.h"
+#include "vec_bufpool.h"
+
+#define ITEM_NAME_SIZE 32
+#define BENCH_KEY_COUNT 4096
+
+// 40 byte element, the same shape as item_t in test_vec_custom.c
+typedef struct item_t {
+  int a;
+  int b;
+  char name[ITEM_NAME_SIZE];
+} item_t;
+
+// 16 byte element
+typedef struct pair_t {
+  uint64_t a;
+  uint64_t b;
+} pair_t;
+
+typedef VEC_PRE_ALIGN struct { vec_define_fields(item_t) } vec_item_t VEC_POST_ALIGN;
+typedef VEC_PRE_ALIGN struct { vec_define_fields(pair_t) } vec_pair_t VEC_POST_ALIGN;
+
+//
+// Per element type helpers, each type provides:
+//   make_<name>(i)     create an element from a sequence number
+//   key_<name>(x)      integer key of an element
+//   cmp_<name>(a, b)   qsort compatible compare on the key
+//   odd_<name>(x)      predicate that is true for every other element
+//
+static uint8_t make_u8(uint64_t i) { return (uint8_t)i; }
+static uint64_t key_u8(uint8_t x) { return x; }
+
+static int32_t make_i32(uint64_t i) { return (int32_t)i; }
+static uint64_t key_i32(int32_t x) { return (uint64_t)x; }
+
+static uint64_t make_u64(uint64_t i) { return i; }
+static uint64_t key_u64(uint64_t x) { return x; }
+
+// the key is the radix order of the float bits so cmp_f32 agrees with `<`
+static float make_f32(uint64_t i) { return (float)(int32_t)(uint32_t)i / 16.0f; }
+static uint64_t key_f32(float x) {
+  uint32_t u;
+  memcpy(&u, &x, sizeof(u));
+  return (u & 0x80000000u) ? ~u : (u | 0x80000000u);
+}
+
+static pair_t make_pair(uint64_t i) {
+  pair_t x;
+  x.a = i;
+  x.b = ~i;
+  return x;
+}
+static uint64_t key_pair(pair_t x) { return x.a; }
+
+static item_t make_item(uint64_t i) {
+  item_t x;
+  memset(&x, 0, sizeof(x));
+  x.a = (int)i;
+  x.b = (int)~i;
+  return x;
+}
+static uint64_t key_item(item_t x) { return (uint64_t)x.a; }
+
+#define BENCH_DEFINE_CMP(name, T)                           \
+  static int cmp_##name(const void *a_, const void *b_) {   \
+    uint64_t a = key_##name(*(const T *)a_);                \
+    uint64_t b = key_##name(*(const T *)b_);                \
+    return a < b ? -1 : a > b;                              \
+  }                                                         \
+  static T map_##name(T x) {                                \
+    return make_##name(key_##name(x) + 1);                  \
+  }                                                         \
+  static uint64_t fold_##name(uint64_t acc, T x) {          \
+    return acc + key_##name(x);                             \
+  }                                                         \
+  static int odd_##name(T x) {                              \
+    return (int)(key_##name(x) & 1);                        \
+  }
+
+BENCH_DEFINE_CMP(u8, uint8_t)
+BENCH_DEFINE_CMP(i32, int32_t)
+BENCH_DEFINE_CMP(u64, uint64_t)
+BENCH_DEFINE_CMP(f32, float)
+BENCH_DEFINE_CMP(pair, pair_t)
+BENCH_DEFINE_CMP(item, item_t)
+
+
+// Report a benchmark whose buffers of `n` elements can't be allocated, its row is left
+// out rather than timing writes that never happened
+static void bench_skip(const char *op, const char *type, size_t n) {
+  fprintf(stderr, "bench: unable to allocate %s %s of %zu elements, skipped\n", op, type, n);
+}
+
+
+// Fill `v` with the first `n` elements of `src`, not measured. Returns VEC_OK, or VEC_ERR
+// and an empty vector when the elements can't be allocated.
+#define bench_fill(v, src, n)                                 \
+  ( vec_init(v),                                              \
+    vec_reserve(v, n) != VEC_OK                               \
+      ? VEC_ERR                                               \
+      : (memcpy((v)->data, (src), (n) * sizeof(*(v)->data)),  \
+         (v)->length = (n), VEC_OK) )
+
+
+// Appending one element at a time including growth, ops are elements
+#define BENCH_DEFINE_PUSH(name, V, T)                                 \
+  static void bench_push_##name(T *src, size_t n) {                   \
+    bench_t b;                                                        \
+    V v;                                                              \
+    int ok = 1;                                                       \
+    bench_begin(&b, "push", #name, sizeof(T), n);                     \
+    for (size_t r = bench_rounds(n); ok && r > 0; --r) {              \
+      vec_init(&v);                                                   \
+      bench_resume(&b);                                               \
+      for (size_t i = 0; i < n; ++i) {                                \
+        ok &= VEC_OK == vec_push(&v, src[i]);                         \
+      }                                                               \
+      bench_pause(&b, n);                                             \
+      vec_deinit(&v);                                                 \
+    }                                                                 \
+    if (!ok) {                                                        \
+      bench_skip("push", #name, n);                                   \
+      return;                                                         \
+    }                                                                 \
+    bench_end(&b);                                                    \
+  }
+
+
+// Reference for push, storing into a preallocated array, ops are elements
+#define BENCH_DEFINE_STORE(name, V, T)                                \
+  static void bench_store_##name(T *src, size_t n) {                  \
+    bench_t b;                                                        \
+    T *volatile dst = malloc(n * sizeof(T));                          \
+    T *d = dst;                                                       \
+    if (d == NULL) {                                                  \
+      bench_skip("store", #name, n);                                  \
+      return;                                                         \
+    }                                                                 \
+    bench_begin(&b, "store", #name, sizeof(T), n);                    \
+    for (size_t r = bench_rounds(n); r > 0; --r) {                    \
+      bench_resume(&b);                                               \
+      for (size_t i = 0; i < n; ++i) {                                \
+        d[i] = src[i];                                                \
+      }                                                               \
+      bench_pause(&b, n);                                             \
+      d = dst;                                                        \
+    }                                                                 \
+    bench_end(&b);                                                    \
+    free(d);                                                          \
+  }
+
+
+// Insert into the middle of a vector of length `n`, ops are calls
+#define BENCH_DEFINE_INSERT(name, V, T)                               \
+  static void bench_insert_##name(T *src, size_t n) {                 \
+    bench_t b;                                                        \
+    V v;                                                              \
+    size_t rounds = bench_rounds(n);                                  \
+    if (bench_fill(&v, src, n) != VEC_OK ||                           \
+        vec_reserve(&v, n + 1) != VEC_OK) {                           \
+      vec_deinit(&v);                                                 \
+      bench_skip("insert", #name, n);                                 \
+      return;                                                         \
+    }                                                                 \
+    bench_begin(&b, "insert", #name, sizeof(T), n);                   \
+    bench_resume(&b);                                                 \
+    for (size_t r = 0; r < rounds; ++r) {                             \
+      vec_insert(&v, n >> 1, src[r % n]);                             \
+      v.length--;                                                     \
+    }                                                                 \
+    bench_pause(&b, rounds);                                          \
+    bench_end(&b);                                                    \
+    vec_deinit(&v);                                                   \
+  }
+
+
+// Remove a single element from the middle of a vector of length `n`, ops are calls
+#define BENCH_DEFINE_SPLICE(name, V, T)                               \
+  static void bench_splice_##name(T *src, size_t n) {                 \
+    bench_t b;                                                        \
+    V v;                                                              \
+    size_t rounds = bench_rounds(n);                                  \
+    if (bench_fill(&v, src, n) != VEC_OK) {                           \
+      vec_deinit(&v);                                                 \
+      bench_skip("splice", #name, n);                                 \
+      return;                                                         \
+    }                                                                 \
+    bench_begin(&b, "splice", #name, sizeof(T), n);                   \
+    bench_resume(&b);                                                 \
+    for (size_t r = 0; r < rounds; ++r) {                             \
+      vec_splice(&v, n >> 1, 1);                                      \
+      v.length++;                                                     \
+    }                                                                 \
+    bench_pause(&b, rounds);                                          \
+    bench_end(&b);                                                    \
+    vec_deinit(&v);                                                   \
+  }
+
+
+// Unordered removal from the middle of a vector of length `n`, ops are calls
+#define BENCH_DEFINE_SWAPSPLICE(name, V, T)                           \
+  static void bench_swapsplice_##name(T *src, size_t n) {             \
+    bench_t b;                                                        \
+    V v;                                                              \
+    size_t rounds = bench_rounds(1);                                  \
+    if (bench_fill(&v, src, n) != VEC_OK) {                           \
+      vec_deinit(&v);                                                 \
+      bench_skip("swapsplice", #name, n);                             \
+      return;                                                         \
+    }                                                                 \
+    bench_begin(&b, "swapsplice", #name, sizeof(T), n);               \
+    bench_resume(&b);                                                 \
+    for (size_t r = 0; r < rounds; ++r) {                             \
+      vec_swapsplice(&v, n >> 1, 1);                                  \
+      v.length++;                                                     \
+    }                                                                 \
+    bench_pause(&b, rounds);                                          \
+    bench_end(&b);                                                    \
+    vec_deinit(&v);                                                   \
+  }
+
+
+// Bulk append of an array into an empty vector, ops are elements
+#define BENCH_DEFINE_PUSHARR(name, V, T)                              \
+  static void bench_pusharr_##name(T *src, size_t n) {                \
+    bench_t b;                                                        \
+    V v;                                                              \
+    int ok = 1;                                                       \
+    bench_begin(&b, "pusharr", #name, sizeof(T), n);                  \
+    for (size_t r = bench_rounds(n); ok && r > 0; --r) {              \
+      vec_init(&v);                                                   \
+      bench_resume(&b);                                               \
+      vec_pusharr(&v, src, n);                                        \
+      bench_pause(&b, n);                                             \
+      ok &= v.length == n;                                            \
+      vec_deinit(&v);                                                 \
+    }                                                                 \
+    if (!ok) {                                                        \
+      bench_skip("pusharr", #name, n);                                \
+      return;                                                         \
+    }                                                                 \
+    bench_end(&b);                                                    \
+  }
+
+
+// Bulk insert of 64 elements into the middle of a vector of length `n`, ops are elements
+#define BENCH_DEFINE_INSERTARR(name, V, T)                            \
+  static void bench_insertarr_##name(T *src, size_t n) {              \
+    bench_t b;                                                        \
+    V v;                                                              \
+    size_t count = n < 64 ? n : 64;                                   \
+    size_t rounds = bench_rounds(n);                                  \
+    if (bench_fill(&v, src, n) != VEC_OK ||                           \
+        vec_reserve(&v, n + count) != VEC_OK) {                       \
+      vec_deinit(&v);                                                 \
+      bench_skip("insertarr", #name, n);                              \
+      return;                                                         \
+    }                                                                 \
+    bench_begin(&b, "insertarr", #name, sizeof(T), n);                \
+    bench_resume(&b);                                                 \
+    for (size_t r = 0; r < rounds; ++r) {                             \
+      vec_insertarr(&v, n >> 1, src, count);                          \
+      v.length -= count;                                              \
+    }                                                                 \
+    bench_pause(&b, rounds * count);                                  \
+    bench_end(&b);                                                    \
+    vec_deinit(&v);                                                   \
+  }
+
+
+// Bulk append of a vector into an empty vector, ops are elements
+#define BENCH_DEFINE_EXTEND(name, V, T)                               \
+  static void bench_extend_##name(T *src, size_t n) {                 \
+    bench_t b;                                                        \
+    V v, v2;                                                          \
+    vec_init_with_fixed(&v2, src, n);                                 \
+    v2.length = n;                                                    \
+    int ok = 1;                                                       \
+    bench_begin(&b, "extend", #name, sizeof(T), n);                   \
+    for (size_t r = bench_rounds(n); ok && r > 0; --r) {              \
+      vec_init(&v);                                                   \
+      bench_resume(&b);                                               \
+      vec_extend(&v, &v2);                                            \
+      bench_pause(&b, n);                                             \
+      ok &= v.length == n;                                            \
+      vec_deinit(&v);                                                 \
+    }                                                                 \
+    if (!ok) {                                                        \
+      bench_skip("extend", #name, n);                                 \
+      return;                                                         \
+    }                                                                 \
+    bench_end(&b);                                                    \
+  }
+
+
+// Linear searches for a key planted at the far end, ops are elements scanned
+#define BENCH_DEFINE_SCAN(name, V, T, op, scan)                       \
+  static void bench_##op##_##name(V *v, T key, size_t n) {            \
+    bench_t b;                                                        \
+    vec_size_t idx = 0;                                               \
+    bench_begin(&b, #op, #name, sizeof(T), n);                        \
+    for (size_t r = bench_rounds(n); r > 0; --r) {                    \
+      bench_resume(&b);                                               \
+      scan(v, key, idx);                                              \
+      bench_pause(&b, n);                                             \
+      bench_sink += idx;                                              \
+    }                                                                 \
+    bench_end(&b);                                                    \
+  }
+
+#define BENCH_DEFINE_FIND(name, V, T)                                 \
+  BENCH_DEFINE_SCAN(name, V, T, find, vec_find)                       \
+  BENCH_DEFINE_SCAN(name, V, T, rfind, vec_rfind)                     \
+  BENCH_DEFINE_SCAN(name, V, T, count, vec_count)                     \
+  static void bench_scan_##name(T *src, size_t n) {                   \
+    V v;                                                              \
+    T key = make_##name(1);                                           \
+    (void)src;                                                        \
+    int ok;                                                           \
+    vec_init(&v);                                                     \
+    ok = VEC_OK == vec_push(&v, key);                                 \
+    for (size_t i = 0; i + 1 < n; ++i) {                              \
+      ok &= VEC_OK == vec_push(&v, make_##name(0));                   \
+    }                                                                 \
+    if (!ok) {                                                        \
+      vec_deinit(&v);                                                 \
+      bench_skip("find", #name, n);                                   \
+      return;                                                         \
+    }                                                                 \
+    /* rfind scans from the back so the key is at the front */      \
+    if (bench_enabled("rfind", #name)) bench_rfind_##name(&v, key, n); \
+    v.data[0] = make_##name(0);                                       \
+    v.data[n - 1] = key;                                              \
+    if (bench_enabled("find", #name)) bench_find_##name(&v, key, n);  \
+    if (bench_enabled("count", #name)) bench_count_##name(&v, key, n); \
+    vec_deinit(&v);                                                   \
+  }
+
+
+// qsort of shuffled keys, ops are elements
+#define BENCH_DEFINE_SORT(name, V, T)                                 \
+  static void bench_sort_##name(T *src, size_t n) {                   \
+    bench_t b;                                                        \
+    V v;                                                              \
+    T *shuffled = malloc(n * sizeof(T));                              \
+    uint64_t seed = 0x9e3779b97f4a7c15ull;                            \
+    if (shuffled == NULL) {                                           \
+      bench_skip("sort", #name, n);                                   \
+      return;                                                         \
+    }                                                                 \
+    for (size_t i = 0; i < n; ++i) {                                  \
+      shuffled[i] = make_##name(bench_rand(&seed));                   \
+    }                                                                 \
+    (void)src;                                                        \
+    if (bench_fill(&v, shuffled, n) != VEC_OK) {                      \
+      vec_deinit(&v);                                                 \
+      free(shuffled);                                                 \
+      bench_skip("sort", #name, n);                                   \
+      return;                                                         \
+    }                                                                 \
+    bench_begin(&b, "sort", #name, sizeof(T), n);                     \
+    for (size_t r = bench_rounds(n); r > 0; --r) {                    \
+      memcpy(v.data, shuffled, n * sizeof(T));                        \
+      bench_resume(&b);                                               \
+      vec_sort(&v, cmp_##name);                                       \
+      bench_pause(&b, n);                                             \
+    }                                                                 \
+    bench_end(&b);                                                    \
+    vec_deinit(&v);                                                   \
+    free(shuffled);                                                   \
+  }
+
+
+// Generated sort with the key compare inlined, same input as the sort benchmark
+#define BENCH_DEFINE_SORT_INLINE(name, V, T)                          \
+  VEC_DEFINE_SORT(bench_##name, T, key_##name(*a) < key_##name(*b))   \
+  static void bench_sort_inline_##name(T *src, size_t n) {            \
+    bench_t b;                                                        \
+    V v;                                                              \
+    T *shuffled = malloc(n * sizeof(T));                              \
+    uint64_t seed = 0x9e3779b97f4a7c15ull;                            \
+    if (shuffled == NULL) {                                           \
+      bench_skip("sort_inline", #name, n);                            \
+      return;                                                         \
+    }                                                                 \
+    for (size_t i = 0; i < n; ++i) {                                  \
+      shuffled[i] = make_##name(bench_rand(&seed));                   \
+    }                                                                 \
+    (void)src;                                                        \
+    if (bench_fill(&v, shuffled, n) != VEC_OK) {                      \
+      vec_deinit(&v);                                                 \
+      free(shuffled);                                                 \
+      bench_skip("sort_inline", #name, n);                            \
+      return;                                                         \
+    }                                                                 \
+    bench_begin(&b, "sort_inline", #name, sizeof(T), n);              \
+    for (size_t r = bench_rounds(n); r > 0; --r) {                    \
+      memcpy(v.data, shuffled, n * sizeof(T));                        \
+      bench_resume(&b);                                               \
+      vec_sort_inline(&v, bench_##name);                              \
+      bench_pause(&b, n);                                             \
+    }                                                                 \
+    bench_end(&b);                                                    \
+    vec_deinit(&v);                                                   \
+    free(shuffled);                                                   \
+  }
+
+
+// Radix sort of the same input as the sort benchmark, ops are elements
+#define BENCH_DEFINE_SORT_RADIX(name, V, T)                           \
+  static void bench_sort_radix_##name(T *src, size_t n) {             \
+    bench_t b;                                                        \
+    V v;                                                              \
+    T *shuffled = malloc(n * sizeof(T));                              \
+    uint64_t seed = 0x9e3779b97f4a7c15ull;                            \
+    if (shuffled == NULL) {                                           \
+      bench_skip("sort_radix", #name, n);                             \
+      return;                                                         \
+    }                                                                 \
+    for (size_t i = 0; i < n; ++i) {                                  \
+      shuffled[i] = make_##name(bench_rand(&seed));                   \
+    }                                                                 \
+    (void)src;                                                        \
+    if (bench_fill(&v, shuffled, n) != VEC_OK) {                      \
+      vec_deinit(&v);                                                 \
+      free(shuffled);                                                 \
+      bench_skip("sort_radix", #name, n);                             \
+      return;                                                         \
+    }                                                                 \
+    bench_begin(&b, "sort_radix", #name, sizeof(T), n);               \
+    for (size_t r = bench_rounds(n); r > 0; --r) {                    \
+      memcpy(v.data, shuffled, n * sizeof(T));                        \
+      bench_resume(&b);                                               \
+      vec_sort_radix(&v);                                             \
+      bench_pause(&b, n);                                             \
+    }                                                                 \
+    bench_end(&b);                                                    \
+    vec_deinit(&v);                                                   \
+    free(shuffled);                                                   \
+  }
+
+
+// bsearch for keys present in the sorted vector, ops are lookups
+#define BENCH_DEFINE_BSEARCH(name, V, T)                              \
+  static void bench_bsearch_##name(T *src, size_t n) {                \
+    bench_t b;                                                        \
+    V v;                                                              \
+    T keys[BENCH_KEY_COUNT];                                          \
+    uint64_t seed = 0x9e3779b97f4a7c15ull;                            \
+    size_t rounds = bench_rounds(1);                                  \
+    vec_size_t idx = 0;                                               \
+    if (bench_fill(&v, src, n) != VEC_OK) {                           \
+      vec_deinit(&v);                                                 \
+      bench_skip("bsearch", #name, n);                                \
+      return;                                                         \
+    }                                                                 \
+    vec_sort(&v, cmp_##name);                                         \
+    for (size_t i = 0; i < BENCH_KEY_COUNT; ++i) {                    \
+      keys[i] = v.data[bench_rand(&seed) % n];                        \
+    }                                                                 \
+    bench_begin(&b, "bsearch", #name, sizeof(T), n);                  \
+    bench_resume(&b);                                                 \
+    for (size_t r = 0; r < rounds; ++r) {                             \
+      vec_bsearch(&v, &keys[r % BENCH_KEY_COUNT], &idx, cmp_##name);  \
+      bench_sink += idx;                                              \
+    }                                                                 \
+    bench_pause(&b, rounds);                                          \
+    bench_end(&b);                                                    \
+    vec_deinit(&v);                                                   \
+  }
+
+
+// vec_bsearch_batch for a batch of keys present in the sorted vector, the batch is
+// sorted first for the merge path, ops are lookups
+#define BENCH_DEFINE_BSEARCH_BATCH(name, V, T, op, sorted)            \
+  static void bench_##op##_##name(T *src, size_t n) {                 \
+    bench_t b;                                                        \
+    V v;                                                              \
+    T keys[BENCH_KEY_COUNT];                                          \
+    vec_size_t out[BENCH_KEY_COUNT];                                  \
+    uint64_t seed = 0x9e3779b97f4a7c15ull;                            \
+    size_t rounds = bench_rounds(BENCH_KEY_COUNT);                    \
+    if (bench_fill(&v, src, n) != VEC_OK) {                           \
+      vec_deinit(&v);                                                 \
+      bench_skip(#op, #name, n);                                      \
+      return;                                                         \
+    }                                                                 \
+    vec_sort(&v, cmp_##name);                                         \
+    for (size_t i = 0; i < BENCH_KEY_COUNT; ++i) {                    \
+      keys[i] = v.data[bench_rand(&seed) % n];                        \
+    }                                                                 \
+    if (sorted) qsort(keys, BENCH_KEY_COUNT, sizeof(T), cmp_##name);  \
+    bench_begin(&b, #op, #name, sizeof(T), n);                        \
+    bench_resume(&b);                                                 \
+    for (size_t r = 0; r < rounds; ++r) {                             \
+      bench_sink += vec_bsearch_batch(&v, keys, BENCH_KEY_COUNT, out, cmp_##name); \
+    }                                                                 \
+    bench_pause(&b, rounds * BENCH_KEY_COUNT);                        \
+    bench_end(&b);                                                    \
+    vec_deinit(&v);                                                   \
+  }
+
+
+// Binary search for keys present in the sorted vector with `search`, ops are lookups
+#define BENCH_DEFINE_BOUND(name, V, T, op, search)                    \
+  static void bench_##op##_##name(T *src, size_t n) {                 \
+    bench_t b;                                                        \
+    V v;                                                              \
+    T keys[BENCH_KEY_COUNT];                                          \
+    uint64_t seed = 0x9e3779b97f4a7c15ull;                            \
+    size_t rounds = bench_rounds(1);                                  \
+    vec_size_t idx = 0;                                               \
+    if (bench_fill(&v, src, n) != VEC_OK) {                           \
+      vec_deinit(&v);                                                 \
+      bench_skip(#op, #name, n);                                      \
+      return;                                                         \
+    }                                                                 \
+    vec_sort(&v, cmp_##name);                                         \
+    for (size_t i = 0; i < BENCH_KEY_COUNT; ++i) {                    \
+      keys[i] = v.data[bench_rand(&seed) % n];                        \
+    }                                                                 \
+    bench_begin(&b, #op, #name, sizeof(T), n);                        \
+    bench_resume(&b);                                                 \
+    for (size_t r = 0; r < rounds; ++r) {                             \
+      search(&v, keys[r % BENCH_KEY_COUNT], idx, cmp_##name);         \
+      bench_sink += idx;                                              \
+    }                                                                 \
+    bench_pause(&b, rounds);                                          \
+    bench_end(&b);                                                    \
+    vec_deinit(&v);                                                   \
+  }
+
+#define bench_lower_bound_(v, key, idx, fn) \
+  vec_lower_bound(v, key, idx)
+
+#define bench_lower_bound_cmp_(v, key, idx, fn) \
+  vec_lower_bound_cmp(v, &(key), idx, fn)
+
+
+// Search the Eytzinger layout of the sorted vector with `search`, ops are lookups
+#define BENCH_DEFINE_EYTZINGER(name, V, T, op, search)                \
+  static void bench_##op##_##name(T *src, size_t n) {                 \
+    bench_t b;                                                        \
+    V v, e;                                                           \
+    T keys[BENCH_KEY_COUNT];                                          \
+    uint64_t seed = 0x9e3779b97f4a7c15ull;                            \
+    size_t rounds = bench_rounds(1);                                  \
+    vec_size_t idx = 0;                                               \
+    if (bench_fill(&v, src, n) != VEC_OK) {                           \
+      vec_deinit(&v);                                                 \
+      bench_skip(#op, #name, n);                                      \
+      return;                                                         \
+    }                                                                 \
+    vec_sort(&v, cmp_##name);                                         \
+    vec_init(&e);                                                     \
+    if (vec_eytzinger_build(&e, &v) != VEC_OK) {                      \
+      vec_deinit(&v);                                                 \
+      bench_skip(#op, #name, n);                                      \
+      return;                                                         \
+    }                                                                 \
+    for (size_t i = 0; i < BENCH_KEY_COUNT; ++i) {                    \
+      keys[i] = v.data[bench_rand(&seed) % n];                        \
+    }                                                                 \
+    vec_deinit(&v);                                                   \
+    bench_begin(&b, #op, #name, sizeof(T), n);                        \
+    bench_resume(&b);                                                 \
+    for (size_t r = 0; r < rounds; ++r) {                             \
+      search(&e, keys[r % BENCH_KEY_COUNT], idx, cmp_##name);         \
+      bench_sink += idx;                                              \
+    }                                                                 \
+    bench_pause(&b, rounds);                                          \
+    bench_end(&b);                                                    \
+    vec_deinit(&e);                                                   \
+  }
+
+#define bench_eytzinger_(v, key, idx, fn) \
+  vec_eytzinger_search(v, key, idx)
+
+#define bench_eytzinger_cmp_(v, key, idx, fn) \
+  vec_eytzinger_search_cmp(v, &(key), idx, fn)
+
+
+// Swap random pairs of elements, ops are calls
+#define BENCH_DEFINE_SWAP(name, V, T)                                 \
+  static void bench_swap_##name(T *src, size_t n) {                   \
+    bench_t b;                                                        \
+    V v;                                                              \
+    vec_size_t idx[BENCH_KEY_COUNT];                                  \
+    uint64_t seed = 0x9e3779b97f4a7c15ull;                            \
+    size_t rounds = bench_rounds(1);                                  \
+    for (size_t i = 0; i < BENCH_KEY_COUNT; ++i) {                    \
+      idx[i] = bench_rand(&seed) % n;                                 \
+    }                                                                 \
+    if (bench_fill(&v, src, n) != VEC_OK) {                           \
+      vec_deinit(&v);                                                 \
+      bench_skip("swap", #name, n);                                   \
+      return;                                                         \
+    }                                                                 \
+    bench_begin(&b, "swap", #name, sizeof(T), n);                     \
+    bench_resume(&b);                                                 \
+    for (size_t r = 0; r < rounds; ++r) {                             \
+      vec_swap(&v, idx[r % BENCH_KEY_COUNT],                          \
+               idx[(r + 1) % BENCH_KEY_COUNT]);                       \
+    }                                                                 \
+    bench_pause(&b, rounds);                                          \
+    bench_end(&b);                                                    \
+    bench_sink += key_##name(v.data[0]);                              \
+    vec_deinit(&v);                                                   \
+  }
+
+
+// In place reverse, ops are elements
+#define BENCH_DEFINE_REVERSE(name, V, T)                              \
+  static void bench_reverse_##name(T *src, size_t n) {                \
+    bench_t b;                                                        \
+    V v;                                                              \
+    if (bench_fill(&v, src, n) != VEC_OK) {                           \
+      vec_deinit(&v);                                                 \
+      bench_skip("reverse", #name, n);                                \
+      return;                                                         \
+    }                                                                 \
+    bench_begin(&b, "reverse", #name, sizeof(T), n);                  \
+    for (size_t r = bench_rounds(n); r > 0; --r) {                    \
+      bench_resume(&b);                                               \
+      vec_reverse(&v);                                                \
+      bench_pause(&b, n);                                             \
+    }                                                                 \
+    bench_end(&b);                                                    \
+    bench_sink += key_##name(v.data[0]);                              \
+    vec_deinit(&v);                                                   \
+  }
+
+
+// Map into a second vector, ops are elements
+#define BENCH_DEFINE_MAP(name, V, T)                                  \
+  static void bench_map_##name(T *src, size_t n) {                    \
+    bench_t b;                                                        \
+    V v, v2;                                                          \
+    vec_init(&v);                                                     \
+    vec_init_with_fixed(&v2, src, n);                                 \
+    v2.length = n;                                                    \
+    int ok = 1;                                                       \
+    bench_begin(&b, "map", #name, sizeof(T), n);                      \
+    for (size_t r = bench_rounds(n); ok && r > 0; --r) {              \
+      bench_resume(&b);                                               \
+      vec_map(&v, &v2, map_##name);                                   \
+      bench_pause(&b, n);                                             \
+      ok &= v.length == n;                                            \
+    }                                                                 \
+    if (!ok) {                                                        \
+      vec_deinit(&v);                                                 \
+      bench_skip("map", #name, n);                                    \
+      return;                                                         \
+    }                                                                 \
+    bench_end(&b);                                                    \
+    bench_sink += key_##name(v.data[0]);                              \
+    vec_deinit(&v);                                                   \
+  }
+
+
+// Fold into an integer accumulator, ops are elements
+#define BENCH_DEFINE_FOLD(name, V, T)                                 \
+  static void bench_fold_##name(T *src, size_t n) {                   \
+    bench_t b;                                                        \
+    V v;                                                              \
+    uint64_t acc = 0;                                                 \
+    vec_init_with_fixed(&v, src, n);                                  \
+    v.length = n;                                                     \
+    bench_begin(&b, "fold", #name, sizeof(T), n);                     \
+    for (size_t r = bench_rounds(n); r > 0; --r) {                    \
+      bench_resume(&b);                                               \
+      vec_fold(&v, acc, fold_##name);                                 \
+      bench_pause(&b, n);                                             \
+    }                                                                 \
+    bench_end(&b);                                                    \
+    bench_sink += acc;                                                \
+  }
+
+
+// Push, index and fold a segmented vector, compare with push, store and fold. Ops are
+// elements.
+#define BENCH_DEFINE_SEG(name, V, T)                                  \
+  typedef struct { vec_seg_define_fields(T) } seg_##name##_t;         \
+                                                                      \
+  static void bench_seg_push_##name(T *src, size_t n) {               \
+    bench_t b;                                                        \
+    seg_##name##_t v;                                                 \
+    int ok = 1;                                                       \
+    bench_begin(&b, "seg_push", #name, sizeof(T), n);                 \
+    for (size_t r = bench_rounds(n); ok && r > 0; --r) {              \
+      vec_seg_init(&v);                                               \
+      bench_resume(&b);                                               \
+      for (size_t i = 0; i < n; ++i) {                                \
+        ok &= VEC_OK == vec_seg_push(&v, src[i]);                     \
+      }                                                               \
+      bench_pause(&b, n);                                             \
+      vec_seg_deinit(&v);                                             \
+    }                                                                 \
+    if (!ok) {                                                        \
+      bench_skip("seg_push", #name, n);                               \
+      return;                                                         \
+    }                                                                 \
+    bench_end(&b);                                                    \
+  }                                                                   \
+                                                                      \
+  static void bench_seg_get_##name(T *src, size_t n) {                \
+    bench_t b;                                                        \
+    seg_##name##_t v;                                                 \
+    uint64_t acc = 0;                                                 \
+    int ok = 1;                                                       \
+    vec_seg_init(&v);                                                 \
+    for (size_t i = 0; i < n; ++i) {                                  \
+      ok &= VEC_OK == vec_seg_push(&v, src[i]);                       \
+    }                                                                 \
+    if (!ok) {                                                        \
+      vec_seg_deinit(&v);                                             \
+      bench_skip("seg_get", #name, n);                                \
+      return;                                                         \
+    }                                                                 \
+    bench_begin(&b, "seg_get", #name, sizeof(T), n);                  \
+    for (size_t r = bench_rounds(n); r > 0; --r) {                    \
+      bench_resume(&b);                                               \
+      for (size_t i = 0; i < n; ++i) {                                \
+        acc += key_##name(vec_seg_get(&v, i));                        \
+      }                                                               \
+      bench_pause(&b, n);                                             \
+    }                                                                 \
+    bench_end(&b);                                                    \
+    bench_sink += acc;                                                \
+    vec_seg_deinit(&v);                                               \
+  }                                                                   \
+                                                                      \
+  static void bench_seg_fold_##name(T *src, size_t n) {               \
+    bench_t b;                                                        \
+    seg_##name##_t v;                                                 \
+    uint64_t acc = 0;                                                 \
+    int ok = 1;                                                       \
+    vec_seg_init(&v);                                                 \
+    for (size_t i = 0; i < n; ++i) {                                  \
+      ok &= VEC_OK == vec_seg_push(&v, src[i]);                       \
+    }                                                                 \
+    if (!ok) {                                                        \
+      vec_seg_deinit(&v);                                             \
+      bench_skip("seg_fold", #name, n);                               \
+      return;                                                         \
+    }                                                                 \
+    bench_begin(&b, "seg_fold", #name, sizeof(T), n);                 \
+    for (size_t r = bench_rounds(n); r > 0; --r) {                    \
+      bench_resume(&b);                                               \
+      vec_seg_fold(&v, acc, fold_##name);                             \
+      bench_pause(&b, n);                                             \
+    }                                                                 \
+    bench_end(&b);                                                    \
+    bench_sink += acc;                                                \
+    vec_seg_deinit(&v);                                               \
+  }
+
+
+// A FIFO queue of length `n`, each op dequeues the front and enqueues it at the back.
+// queue_splice dequeues with vec_splice, queue_deque with vec_deque_pop_front.
+#define BENCH_DEFINE_QUEUE(name, V, T)                                \
+  typedef struct { vec_deque_define_fields(T) } deque_##name##_t;     \
+                                                                      \
+  static void bench_queue_splice_##name(T *src, size_t n) {           \
+    bench_t b;                                                        \
+    V v;                                                              \
+    size_t rounds = bench_rounds(n);                                  \
+    if (bench_fill(&v, src, n) != VEC_OK) {                           \
+      vec_deinit(&v);                                                 \
+      bench_skip("queue_splice", #name, n);                           \
+      return;                                                         \
+    }                                                                 \
+    bench_begin(&b, "queue_splice", #name, sizeof(T), n);             \
+    bench_resume(&b);                                                 \
+    for (size_t r = 0; r < rounds; ++r) {                             \
+      T x = v.data[0];                                                \
+      vec_splice(&v, 0, 1);                                           \
+      vec_push(&v, x);                                                \
+    }                                                                 \
+    bench_pause(&b, rounds);                                          \
+    bench_end(&b);                                                    \
+    vec_deinit(&v);                                                   \
+  }                                                                   \
+                                                                      \
+  static void bench_queue_deque_##name(T *src, size_t n) {            \
+    bench_t b;                                                        \
+    deque_##name##_t d;                                               \
+    size_t rounds = bench_rounds(1);                                  \
+    vec_deque_init(&d);                                               \
+    if (vec_deque_push_back_arr(&d, src, n) != VEC_OK) {              \
+      vec_deque_deinit(&d);                                           \
+      bench_skip("queue_deque", #name, n);                            \
+      return;                                                         \
+    }                                                                 \
+    bench_begin(&b, "queue_deque", #name, sizeof(T), n);              \
+    bench_resume(&b);                                                 \
+    for (size_t r = 0; r < rounds; ++r) {                             \
+      T x = vec_deque_pop_front(&d);                                  \
+      vec_deque_push_back(&d, x);                                     \
+    }                                                                 \
+    bench_pause(&b, rounds);                                          \
+    bench_end(&b);                                                    \
+    vec_deque_deinit(&d);                                             \
+  }
+
+
+// Remove every other element in place, ops are source elements
+#define BENCH_DEFINE_REMOVE_IF(name, V, T)                            \
+  static void bench_remove_if_##name(T *src, size_t n) {              \
+    bench_t b;                                                        \
+    V v;                                                              \
+    if (bench_fill(&v, src, n) != VEC_OK) {                           \
+      vec_deinit(&v);                                                 \
+      bench_skip("remove_if", #name, n);                              \
+      return;                                                         \
+    }                                                                 \
+    bench_begin(&b, "remove_if", #name, sizeof(T), n);                \
+    for (size_t r = bench_rounds(n); r > 0; --r) {                    \
+      v.length = 0;                                                   \
+      vec_pusharr(&v, src, n);                                        \
+      bench_resume(&b);                                               \
+      vec_remove_if(&v, odd_##name);                                  \
+      bench_pause(&b, n);                                             \
+    }                                                                 \
+    bench_end(&b);                                                    \
+    bench_sink += v.length;                                           \
+    vec_deinit(&v);                                                   \
+  }
+
+
+// Remove every eighth element with one batch splice, ops are source elements
+#define BENCH_DEFINE_SPLICE_INDICES(name, V, T)                       \
+  static void bench_splice_indices_##name(T *src, size_t n) {         \
+    bench_t b;                                                        \
+    V v;                                                              \
+    vec_size_t *idx = malloc((n / 8 + 1) * sizeof(vec_size_t));       \
+    vec_size_t count = 0;                                             \
+    if (idx == NULL) {                                                \
+      bench_skip("splice_indices", #name, n);                         \
+      return;                                                         \
+    }                                                                 \
+    for (size_t i = 0; i < n; i += 8) idx[count++] = i;               \
+    if (bench_fill(&v, src, n) != VEC_OK) {                           \
+      vec_deinit(&v);                                                 \
+      free(idx);                                                      \
+      bench_skip("splice_indices", #name, n);                         \
+      return;                                                         \
+    }                                                                 \
+    bench_begin(&b, "splice_indices", #name, sizeof(T), n);           \
+    for (size_t r = bench_rounds(n); r > 0; --r) {                    \
+      v.length = 0;                                                   \
+      vec_pusharr(&v, src, n);                                        \
+      bench_resume(&b);                                               \
+      vec_splice_indices(&v, idx, count);                             \
+      bench_pause(&b, n);                                             \
+    }                                                                 \
+    bench_end(&b);                                                    \
+    bench_sink += v.length;                                           \
+    vec_deinit(&v);                                                   \
+    free(idx);                                                        \
+  }
+
+
+// Linear search of struct elements requires the byte compare kernel (see VEC_ELEM_KIND)
+#define bench_scan_none(src, n) ((void)(src), (void)(n))
+
+
+// Generate every benchmark for an element type and a runner over one length
+#define BENCH_DEFINE_TYPE(name, V, T, extra)                       \
+  BENCH_DEFINE_STORE(name, V, T)                                  \
+  BENCH_DEFINE_PUSH(name, V, T)                                   \
+  BENCH_DEFINE_INSERT(name, V, T)                                 \
+  BENCH_DEFINE_SPLICE(name, V, T)                                 \
+  BENCH_DEFINE_SWAPSPLICE(name, V, T)                             \
+  BENCH_DEFINE_PUSHARR(name, V, T)                                \
+  BENCH_DEFINE_INSERTARR(name, V, T)                              \
+  BENCH_DEFINE_EXTEND(name, V, T)                                 \
+  BENCH_DEFINE_SORT(name, V, T)                                   \
+  BENCH_DEFINE_SORT_INLINE(name, V, T)                            \
+  BENCH_DEFINE_BSEARCH(name, V, T)                                \
+  BENCH_DEFINE_BSEARCH_BATCH(name, V, T, bsearch_batch, 0)        \
+  BENCH_DEFINE_BSEARCH_BATCH(name, V, T, bsearch_batch_sorted, 1) \
+  BENCH_DEFINE_BOUND(name, V, T, lower_bound_cmp, bench_lower_bound_cmp_) \
+  BENCH_DEFINE_EYTZINGER(name, V, T, eytzinger_cmp, bench_eytzinger_cmp_) \
+  BENCH_DEFINE_SWAP(name, V, T)                                   \
+  BENCH_DEFINE_REVERSE(name, V, T)                                \
+  BENCH_DEFINE_MAP(name, V, T)                                    \
+  BENCH_DEFINE_FOLD(name, V, T)                                   \
+  BENCH_DEFINE_SEG(name, V, T)                                    \
+  BENCH_DEFINE_QUEUE(name, V, T)                                  \
+  BENCH_DEFINE_REMOVE_IF(name, V, T)                              \
+  BENCH_DEFINE_SPLICE_INDICES(name, V, T)                         \
+  static void bench_run_##name(size_t n) {                        \
+    /* the source sequence is kept outside of the bench allocator */ \
+    T *src = malloc(n * sizeof(T));                               \
+    if (src == NULL) {                                            \
+      fprintf(stderr, "bench: unable to allocate %zu %s\n", n, #name); \
+      return;                                                     \
+    }                                                             \
+    for (size_t i = 0; i < n; ++i) {                              \
+      src[i] = make_##name(i);                                    \
+    }                                                             \
+    if (bench_enabled("store", #name)) bench_store_##name(src, n); \
+    if (bench_enabled("push", #name)) bench_push_##name(src, n);  \
+    if (bench_enabled("insert", #name)) bench_insert_##name(src, n); \
+    if (bench_enabled("splice", #name)) bench_splice_##name(src, n); \
+    if (bench_enabled("swapsplice", #name)) bench_swapsplice_##name(src, n); \
+    if (bench_enabled("pusharr", #name)) bench_pusharr_##name(src, n); \
+    if (bench_enabled("insertarr", #name)) bench_insertarr_##name(src, n); \
+    if (bench_enabled("extend", #name)) bench_extend_##name(src, n); \
+    extra(src, n);                                                \
+    if (bench_enabled("sort", #name)) bench_sort_##name(src, n);  \
+    if (bench_enabled("sort_inline", #name)) bench_sort_inline_##name(src, n); \
+    if (bench_enabled("bsearch", #name)) bench_bsearch_##name(src, n); \
+    if (bench_enabled("bsearch_batch", #name)) bench_bsearch_batch_##name(src, n); \
+    if (bench_enabled("bsearch_batch_sorted", #name)) bench_bsearch_batch_sorted_##name(src, n); \
+    if (bench_enabled("lower_bound_cmp", #name)) bench_lower_bound_cmp_##name(src, n); \
+    if (bench_enabled("eytzinger_cmp", #name)) bench_eytzinger_cmp_##name(src, n); \
+    if (bench_enabled("swap", #name)) bench_swap_##name(src, n);  \
+    if (bench_enabled("reverse", #name)) bench_reverse_##name(src, n); \
+    if (bench_enabled("map", #name)) bench_map_##name(src, n);    \
+    if (bench_enabled("fold", #name)) bench_fold_##name(src, n);  \
+    if (bench_enabled("seg_push", #name)) bench_seg_push_##name(src, n); \
+    if (bench_enabled("seg_get", #name)) bench_seg_get_##name(src, n); \
+    if (bench_enabled("seg_fold", #name)) bench_seg_fold_##name(src, n); \
+    if (bench_enabled("queue_splice", #name)) bench_queue_splice_##name(src, n); \
+    if (bench_enabled("queue_deque", #name)) bench_queue_deque_##name(src, n); \
+    if (bench_enabled("remove_if", #name)) bench_remove_if_##name(src, n); \
+    if (bench_enabled("splice_indices", #name)) bench_splice_indices_##name(src, n); \
+    free(src);                                                    \
+  }
+
+// Benchmarks that only apply to the integer and floating point element types
+#if defined(VEC_ELEM_KIND)
+#define BENCH_DEFINE_PRIMITIVE(name, V, T)                        \
+  BENCH_DEFINE_FIND(name, V, T)                                   \
+  BENCH_DEFINE_SORT_RADIX(name, V, T)                             \
+  BENCH_DEFINE_BOUND(name, V, T, lower_bound, bench_lower_bound_) \
+  BENCH_DEFINE_EYTZINGER(name, V, T, eytzinger, bench_eytzinger_) \
+  static void bench_primitive_##name(T *src, size_t n) {          \
+    bench_scan_##name(src, n);                                    \
+    if (bench_enabled("sort_radix", #name)) bench_sort_radix_##name(src, n); \
+    if (bench_enabled("lower_bound", #name)) bench_lower_bound_##name(src, n); \
+    if (bench_enabled("eytzinger", #name)) bench_eytzinger_##name(src, n); \
+  }
+#else
+#define BENCH_DEFINE_PRIMITIVE(name, V, T)                        \
+  BENCH_DEFINE_FIND(name, V, T)                                   \
+  BENCH_DEFINE_BOUND(name, V, T, lower_bound, bench_lower_bound_) \
+  BENCH_DEFINE_EYTZINGER(name, V, T, eytzinger, bench_eytzinger_) \
+  static void bench_primitive_##name(T *src, size_t n) {          \
+    bench_scan_##name(src, n);                                    \
+    if (bench_enabled("lower_bound", #name)) bench_lower_bound_##name(src, n); \
+    if (bench_enabled("eytzinger", #name)) bench_eytzinger_##name(src, n); \
+  }
+#endif
+
+BENCH_DEFINE_PRIMITIVE(u8, vec_uint8_t, uint8_t)
+BENCH_DEFINE_PRIMITIVE(i32, vec_int32_t, int32_t)
+BENCH_DEFINE_PRIMITIVE(u64, vec_uint64_t, uint64_t)
+BENCH_DEFINE_PRIMITIVE(f32, vec_float_t, float)
+
+BENCH_DEFINE_TYPE(u8, vec_uint8_t, uint8_t, bench_primitive_u8)
+BENCH_DEFINE_TYPE(i32, vec_int32_t, int32_t, bench_primitive_i32)
+BENCH_DEFINE_TYPE(u64, vec_uint64_t, uint64_t, bench_primitive_u64)
+BENCH_DEFINE_TYPE(f32, vec_float_t, float, bench_primitive_f32)
+#if defined(VEC_ELEM_KIND)
+BENCH_DEFINE_FIND(pair, vec_pair_t, pair_t)
+BENCH_DEFINE_FIND(item, vec_item_t, item_t)
+BENCH_DEFINE_TYPE(pair, vec_pair_t, pair_t, bench_scan_pair)
+BENCH_DEFINE_TYPE(item, vec_item_t, item_t, bench_scan_item)
+#else
+BENCH_DEFINE_TYPE(pair, vec_pair_t, pair_t, bench_scan_none)
+BENCH_DEFINE_TYPE(item, vec_item_t, item_t, bench_scan_none)
+#endif
+
+
+// The integer fields of item_t as columns
+VEC_DEFINE_SOA(bench_soa_item, (int, a), (int, b))
+
+static uint64_t bench_add_int(uint64_t acc, int x) {
+  return acc + (uint64_t)x;
+}
+
+// Sum one field of `n` items, fold_field reads it from the vector of item_t and
+// soa_fold_field from its column. Ops are elements.
+static void bench_fold_field_item(size_t n) {
+  bench_t b;
+  vec_item_t v;
+  bench_soa_item_t soa;
+  uint64_t acc = 0;
+  int ok = 1;
+  vec_init(&v);
+  bench_soa_item_init(&soa);
+  for (size_t i = 0; i < n; ++i) {
+    item_t x = make_item(i);
+    bench_soa_item_row_t row;
+    row.a = x.a;
+    row.b = x.b;
+    ok &= VEC_OK == vec_push(&v, x);
+    ok &= VEC_OK == bench_soa_item_push(&soa, row);
+  }
+  if (!ok) {
+    bench_skip("fold_field", "item", n);
+    vec_deinit(&v);
+    bench_soa_item_deinit(&soa);
+    return;
+  }
+  if (bench_enabled("fold_field", "item")) {
+    bench_begin(&b, "fold_field", "item", sizeof(item_t), n);
+    for (size_t r = bench_rounds(n); r > 0; --r) {
+      bench_resume(&b);
+      for (size_t i = 0; i < n; ++i) {
+        acc += (uint64_t)v.data[i].a;
+      }
+      bench_pause(&b, n);
+    }
+    bench_end(&b);
+  }
+  if (bench_enabled("soa_fold_field", "item")) {
+    bench_begin(&b, "soa_fold_field", "item", sizeof(item_t), n);
+    for (size_t r = bench_rounds(n); r > 0; --r) {
+      bench_resume(&b);
+      vec_soa_fold(&soa, a, acc, bench_add_int);
+      bench_pause(&b, n);
+    }
+    bench_end(&b);
+  }
+  bench_sink += acc;
+  vec_deinit(&v);
+  bench_soa_item_deinit(&soa);
+}
+
+// Scratch vectors of a request, each round fills four vectors of `n` elements one push
+// at a time and drops them. churn/libc frees each vector, churn/arena grows them in an
+// arena and resets it, churn/pool recycles them through a buffer pool. Ops are elements.
+#define BENCH_CHURN_VECTORS 4
+
+typedef struct { vec_define_fields_alloc(uint64_t) } bench_u64_alloc_t;
+
+static void bench_churn(size_t n) {
+  bench_t b;
+  vec_uint64_t v[BENCH_CHURN_VECTORS];
+  vec_arena_t arena;
+  int ok;
+  if (bench_enabled("churn", "libc")) {
+    ok = 1;
+    bench_begin(&b, "churn", "libc", sizeof(uint64_t), n);
+    for (size_t r = bench_rounds(n * BENCH_CHURN_VECTORS); ok && r > 0; --r) {
+      bench_resume(&b);
+      for (size_t k = 0; k < BENCH_CHURN_VECTORS; ++k) {
+        vec_init(&v[k]);
+        for (size_t i = 0; i < n; ++i) {
+          vec_push(&v[k], i);
+        }
+        ok &= v[k].length == n;
+      }
+      for (size_t k = 0; k < BENCH_CHURN_VECTORS; ++k) {
+        if (ok) bench_sink += v[k].data[n - 1];
+        vec_deinit(&v[k]);
+      }
+      bench_pause(&b, n * BENCH_CHURN_VECTORS);
+    }
+    if (!ok) {
+      bench_skip("churn", "libc", n);
+    } else {
+      bench_end(&b);
+    }
+  }
+  if (bench_enabled("churn", "arena")) {
+    vec_arena_init(&arena, 0);
+    ok = 1;
+    bench_begin(&b, "churn", "arena", sizeof(uint64_t), n);
+    for (size_t r = bench_rounds(n * BENCH_CHURN_VECTORS); ok && r > 0; --r) {
+      bench_resume(&b);
+      for (size_t k = 0; k < BENCH_CHURN_VECTORS; ++k) {
+        vec_init_with_arena(&v[k], &arena);
+        for (size_t i = 0; i < n; ++i) {
+          vec_push(&v[k], i);
+        }
+        ok &= v[k].length == n;
+      }
+      for (size_t k = 0; k < BENCH_CHURN_VECTORS; ++k) {
+        if (ok) bench_sink += v[k].data[n - 1];
+      }
+      vec_arena_reset(&arena);
+      bench_pause(&b, n * BENCH_CHURN_VECTORS);
+    }
+    if (!ok) {
+      bench_skip("churn", "arena", n);
+    } else {
+      bench_end(&b);
+    }
+    vec_arena_deinit(&arena);
+  }
+  if (bench_enabled("churn", "pool")) {
+    bench_u64_alloc_t w[BENCH_CHURN_VECTORS];
+    vec_bufpool_t pool;
+    vec_bufpool_init(&pool, sizeof(uint64_t));
+    ok = 1;
+    bench_begin(&b, "churn", "pool", sizeof(uint64_t), n);
+    for (size_t r = bench_rounds(n * BENCH_CHURN_VECTORS); ok && r > 0; --r) {
+      bench_resume(&b);
+      for (size_t k = 0; k < BENCH_CHURN_VECTORS; ++k) {
+        vec_init_with_allocator(&w[k], vec_bufpool_allocator(&pool));
+        for (size_t i = 0; i < n; ++i) {
+          vec_push(&w[k], i);
+        }
+        ok &= w[k].length == n;
+      }
+      for (size_t k = 0; k < BENCH_CHURN_VECTORS; ++k) {
+        if (ok) bench_sink += w[k].data[n - 1];
+        vec_deinit(&w[k]);
+      }
+      bench_pause(&b, n * BENCH_CHURN_VECTORS);
+    }
+    if (!ok) {
+      bench_skip("churn", "pool", n);
+    } else {
+      bench_end(&b);
+    }
+    vec_bufpool_deinit(&pool);
+  }
+}
+
+// Growth of one large vector of 16 byte pairs one push at a time, grow/libc reallocates
+// through VEC_REALLOC and grow/mapped keeps the storage above vec_map_threshold in a page
+// mapping grown by mremap. --op grow --min-length 1000000000 grows each to 16 GB. Ops are
+// elements.
+static void bench_grow(size_t n) {
+  bench_t b;
+  vec_pair_t v;
+  pair_t x;
+  const char *types[] = { "libc", "mapped" };
+  for (size_t t = 0; t < vec_countof(types); ++t) {
+    int ok = 1;
+    if (!bench_enabled("grow", types[t])) {
+      continue;
+    }
+    bench_begin(&b, "grow", types[t], sizeof(pair_t), n);
+    for (size_t r = bench_rounds(n); ok && r > 0; --r) {
+      if (t == 0) {
+        vec_init(&v);
+      } else {
+        vec_init_mapped(&v);
+      }
+      bench_resume(&b);
+      for (size_t i = 0; i < n; ++i) {
+        x.a = i;
+        x.b = n - i;
+        ok &= VEC_OK == vec_push(&v, x);
+      }
+      bench_pause(&b, n);
+      if (ok) {
+        bench_sink += v.data[n - 1].a;
+      }
+      vec_deinit(&v);
+    }
+    // a row timing failed pushes would be misleading, drop it
+    if (!ok) {
+      fprintf(stderr, "bench: unable to grow %zu %s\n", n, types[t]);
+      continue;
+    }
+    bench_end(&b);
+  }
+}
+
+void bench_vec_ops(void) {
+  size_t n;
+  bench_foreach_length(n) {
+    bench_run_u8(n);
+    bench_run_i32(n);
+    bench_run_u64(n);
+    bench_run_f32(n);
+    bench_run_pair(n);
+    bench_run_item(n);
+    bench_fold_field_item(n);
+    bench_churn(n);
+    bench_grow(n);
+  }
+}
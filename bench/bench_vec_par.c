@@ -0,0 +1,208 @@
+/**
+ * Copyright (c) 2014 rxi (https://github.com/rxi/vec)
+ *
+ * v0.3.x modifications (c) 2022 Jacob Repp (https://github.com/jrepp/vec)
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the MIT license. See https://github.com/rxi/vec/LICENSE for details.
+ */
+
+#include "bench_help.h"
+#include "vec_par.h"
+#include "vec_concurrent.h"
+
+// A few rounds of xorshift so the map does some work per element
+static uint64_t par_mix_u64(uint64_t x) {
+  x ^= x >> 12;
+  x ^= x << 25;
+  x ^= x >> 27;
+  return x * 0x2545f4914f6cdd1dull;
+}
+static uint64_t par_add_u64(uint64_t a, uint64_t b) { return a + b; }
+static void par_inc_u64(uint64_t *x, void *arg) { *x += *(const uint64_t *)arg; }
+// Every 64th element costs about a hundred times more than the others
+static void par_uneven_u64(uint64_t *x, void *arg) {
+  int spins = (*x & 63) == 0 ? 256 : 2;
+  (void) arg;
+  while (spins--) *x = par_mix_u64(*x) | 1;
+}
+static int par_cmp_u64(const void *a_, const void *b_) {
+  uint64_t a = *(const uint64_t *)a_, b = *(const uint64_t *)b_;
+  return a < b ? -1 : a > b;
+}
+
+static double par_mix_f64(double x) { return x * 1.000001 + 0.5; }
+static double par_add_f64(double a, double b) { return a + b; }
+static void par_inc_f64(double *x, void *arg) { *x += *(const double *)arg; }
+static void par_uneven_f64(double *x, void *arg) {
+  int spins = ((uint64_t)*x & 63) == 0 ? 256 : 2;
+  (void) arg;
+  while (spins--) *x = par_mix_f64(*x);
+}
+static int par_cmp_f64(const void *a_, const void *b_) {
+  double a = *(const double *)a_, b = *(const double *)b_;
+  return a < b ? -1 : a > b;
+}
+
+
+// The op name carries the thread count, `par_map_t4` ran on 4 threads. Ops are elements.
+#define BENCH_DEFINE_PAR(name, V, T, vname)                                   \
+  static void bench_par_##name(size_t n, int threads) {                       \
+    bench_t b;                                                                \
+    char op[32];                                                              \
+    V src, dst;                                                               \
+    T acc = 0, one = 1;                                                       \
+    size_t rounds = bench_rounds(n);                                          \
+    vec_init(&src);                                                           \
+    vec_init(&dst);                                                           \
+    if (vec_reserve(&src, n) != VEC_OK) return;                               \
+    for (size_t i = 0; i < n; ++i) src.data[i] = (T)i;                        \
+    src.length = n;                                                           \
+    if (bench_enabled("par_map", #name)) {                                    \
+      snprintf(op, sizeof(op), "par_map_t%d", threads);                       \
+      bench_begin(&b, op, #name, sizeof(T), n);                               \
+      bench_resume(&b);                                                       \
+      for (size_t r = 0; r < rounds; ++r) {                                   \
+        vec_par_map(&dst, &src, par_mix_##name, vname);                       \
+      }                                                                       \
+      bench_pause(&b, rounds * n);                                            \
+      bench_end(&b);                                                          \
+      acc += dst.data[n / 2];                                                 \
+    }                                                                         \
+    if (bench_enabled("par_fold", #name)) {                                   \
+      snprintf(op, sizeof(op), "par_fold_t%d", threads);                      \
+      bench_begin(&b, op, #name, sizeof(T), n);                               \
+      bench_resume(&b);                                                       \
+      for (size_t r = 0; r < rounds; ++r) {                                   \
+        acc += vec_par_fold(&src, 0, par_add_##name, vname);                  \
+      }                                                                       \
+      bench_pause(&b, rounds * n);                                            \
+      bench_end(&b);                                                          \
+    }                                                                         \
+    if (bench_enabled("par_each_ptr", #name)) {                               \
+      snprintf(op, sizeof(op), "par_each_ptr_t%d", threads);                  \
+      bench_begin(&b, op, #name, sizeof(T), n);                               \
+      bench_resume(&b);                                                       \
+      for (size_t r = 0; r < rounds; ++r) {                                   \
+        vec_par_each_ptr(&src, par_inc_##name, &one, vname);                  \
+      }                                                                       \
+      bench_pause(&b, rounds * n);                                            \
+      bench_end(&b);                                                          \
+      acc += src.data[n / 2];                                                 \
+    }                                                                         \
+    if (bench_enabled("par_uneven", #name)) {                                 \
+      for (size_t i = 0; i < n; ++i) src.data[i] = (T)i;                      \
+      snprintf(op, sizeof(op), "par_uneven_t%d", threads);                    \
+      bench_begin(&b, op, #name, sizeof(T), n);                               \
+      bench_resume(&b);                                                       \
+      vec_par_each_ptr(&src, par_uneven_##name, NULL, vname);                 \
+      bench_pause(&b, n);                                                     \
+      bench_end(&b);                                                          \
+      acc += src.data[n / 2];                                                 \
+    }                                                                         \
+    bench_sink += (uint64_t)acc;                                              \
+    vec_deinit(&src);                                                         \
+    vec_deinit(&dst);                                                         \
+  }
+
+BENCH_DEFINE_PAR(u64, vec_uint64_t, uint64_t, vec_uint64)
+BENCH_DEFINE_PAR(f64, vec_double_t, double, vec_double)
+
+
+// Stable parallel sorts of random keys, par_sort calls the compare through a pointer and
+// par_sort_inline has it generated inline. Compare with sort and sort_inline of vec_ops.
+#define BENCH_DEFINE_PAR_SORT(name, V, T)                                     \
+  VEC_DEFINE_PAR_SORT(bench_par_##name, T, *a < *b)                           \
+  static void bench_par_sort_##name(size_t n, int threads, int inl) {         \
+    bench_t b;                                                                \
+    char op[32];                                                              \
+    V v;                                                                      \
+    T *shuffled = malloc(n * sizeof(T));                                      \
+    uint64_t seed = 0x9e3779b97f4a7c15ull;                                    \
+    vec_init(&v);                                                             \
+    if (shuffled == NULL || vec_reserve(&v, n) != VEC_OK) {                   \
+      free(shuffled);                                                         \
+      vec_deinit(&v);                                                         \
+      return;                                                                 \
+    }                                                                         \
+    for (size_t i = 0; i < n; ++i) {                                          \
+      shuffled[i] = (T)(bench_rand(&seed) >> 11);                             \
+    }                                                                         \
+    v.length = n;                                                             \
+    snprintf(op, sizeof(op), "%s_t%d", inl ? "par_sort_inline" : "par_sort",  \
+             threads);                                                        \
+    bench_begin(&b, op, #name, sizeof(T), n);                                 \
+    for (size_t r = bench_rounds(n); r > 0; --r) {                            \
+      memcpy(v.data, shuffled, n * sizeof(T));                                \
+      bench_resume(&b);                                                       \
+      if (inl) {                                                              \
+        vec_par_sort_inline(&v, bench_par_##name);                            \
+      } else {                                                                \
+        vec_par_sort(&v, par_cmp_##name);                                     \
+      }                                                                       \
+      bench_pause(&b, n);                                                     \
+    }                                                                         \
+    bench_end(&b);                                                            \
+    bench_sink += (uint64_t)v.data[n / 2];                                    \
+    vec_deinit(&v);                                                           \
+    free(shuffled);                                                           \
+  }
+
+BENCH_DEFINE_PAR_SORT(u64, vec_uint64_t, uint64_t)
+BENCH_DEFINE_PAR_SORT(f64, vec_double_t, double)
+
+
+static void par_push_u64(void *ctx, vec_size_t lo, vec_size_t hi) {
+  vec_uint64_concurrent_t *c = ctx;
+  for (; lo < hi; ++lo) {
+    vec_concurrent_push(c, (uint64_t)lo, vec_uint64);
+  }
+}
+
+// Every pool thread pushes into one concurrent vector, compare with push of vec_ops
+static void bench_concurrent_push(size_t n, int threads) {
+  bench_t b;
+  char op[32];
+  vec_uint64_concurrent_t c;
+  vec_concurrent_init(&c);
+  snprintf(op, sizeof(op), "concurrent_push_t%d", threads);
+  bench_begin(&b, op, "u64", sizeof(uint64_t), n);
+  for (size_t r = bench_rounds(n); r > 0; --r) {
+    vec_concurrent_clear(&c);
+    bench_resume(&b);
+    vec_par_for(n, par_push_u64, &c);
+    bench_pause(&b, n);
+  }
+  bench_end(&b);
+  bench_sink += vec_concurrent_length(&c);
+  vec_concurrent_deinit(&c);
+}
+
+
+// Run every length on 1, 2, 4, ... threads up to --threads
+void bench_vec_par(void) {
+  int max_threads = bench_max_threads, threads;
+  size_t n;
+  if (max_threads <= 0) {
+    if (vec_par_init(0) != VEC_OK) return;
+    max_threads = vec_par_threads();
+    vec_par_shutdown();
+  }
+  for (threads = 1;; threads = threads * 2 < max_threads ? threads * 2 : max_threads) {
+    if (vec_par_init(threads) != VEC_OK) {
+      fprintf(stderr, "bench: unable to start %d threads\n", threads);
+      return;
+    }
+    bench_foreach_length(n) {
+      bench_par_u64(n, threads);
+      bench_par_f64(n, threads);
+      if (bench_enabled("par_sort", "u64")) bench_par_sort_u64(n, threads, 0);
+      if (bench_enabled("par_sort_inline", "u64")) bench_par_sort_u64(n, threads, 1);
+      if (bench_enabled("par_sort", "f64")) bench_par_sort_f64(n, threads, 0);
+      if (bench_enabled("par_sort_inline", "f64")) bench_par_sort_f64(n, threads, 1);
+      if (bench_enabled("concurrent_push", "u64")) bench_concurrent_push(n, threads);
+    }
+    vec_par_shutdown();
+    if (threads >= max_threads) break;
+  }
+}
@@ -0,0 +1,26 @@
+/**
+ * Copyright (c) 2014 rxi (https://github.com/rxi/vec)
+ *
+ * v0.3.x modifications (c) 2022 Jacob Repp (https://github.com/jrepp/vec)
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the MIT license. See https://github.com/rxi/vec/LICENSE for details.
+ */
+
+#ifndef VEC_BENCH_VEC_CONFIG_H
+#define VEC_BENCH_VEC_CONFIG_H
+
+#include <stddef.h>
+
+// Route vector allocations through the counting allocator (see bench_mem.c)
+#define VEC_MALLOC bench_malloc
+#define VEC_REALLOC bench_realloc
+#define VEC_FREE bench_free
+
+void *bench_malloc(size_t bytes);
+void *bench_realloc(void *p, size_t bytes);
+void bench_free(void *p);
+
+#include "vec_config_default.h"
+
+#endif //VEC_BENCH_VEC_CONFIG_H
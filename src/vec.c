@@ -7,16 +7,186 @@
  * under the terms of the MIT license. See https://github.com/rxi/vec/LICENSE for details.
  */
 
+// mremap is a GNU extension, in single header mode define _GNU_SOURCE before the first
+// include or mapped vectors grow by copying
+#if defined(__linux__) && !defined(VEC_NO_MMAP) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
 #include "vec.h"
 #include <string.h>
+#include <stddef.h>
+
+//
+// Page mapped storage for vec_init_mapped, define VEC_NO_MMAP to keep every vector on
+// VEC_MALLOC
+//
+#if !defined(VEC_NO_MMAP) && (defined(__unix__) || defined(__APPLE__))
+#define VEC_HAVE_MMAP 1
+#include <sys/mman.h>
+#include <unistd.h>
+#if !defined(MAP_ANONYMOUS)
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+#endif
+
+//
+// SIMD kernels, SSE2 is part of the x86-64 baseline and AVX2 is selected at runtime
+// when the compiler can target it. Define VEC_NO_SIMD to only build the scalar kernels.
+//
+#if !defined(VEC_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64))
+#define VEC_HAVE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if !defined(VEC_NO_SIMD) && (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define VEC_HAVE_AVX2 1
+#define VEC_TARGET_AVX2 __attribute__ ((target ("avx2")))
+#include <immintrin.h>
+#endif
+
+static int vec_simd_level_ = -1;
+
+static int vec_simd_detect_(void) {
+  int level = VEC_SIMD_NONE;
+#if defined(VEC_HAVE_SSE2)
+  level = VEC_SIMD_SSE2;
+#endif
+#if defined(VEC_HAVE_AVX2)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    level = VEC_SIMD_AVX2;
+  }
+#endif
+  return level;
+}
+
+int vec_simd_level(void) {
+  if (vec_simd_level_ < 0) {
+    vec_simd_level_ = vec_simd_detect_();
+  }
+  return vec_simd_level_;
+}
+
+int vec_simd_set_level(int level) {
+  int detected = vec_simd_detect_();
+  vec_simd_level_ = level < detected ? level : detected;
+  return vec_simd_level_;
+}
+
+// Vectors declared with vec_define_fields_alloc, the helpers only receive the address
+// of the options field so the allocator context is found relative to it
+typedef struct { vec_define_fields_alloc(uint8_t) } vec_alloc_fields_t;
+
+static const vec_allocator_t *vec_allocator_of_(const vec_size_t *options) {
+  const uint8_t *fields = (const uint8_t *)options - offsetof(vec_alloc_fields_t, options);
+  return ((const vec_alloc_fields_t *)fields)->allocator;
+}
+
+static uint8_t *vec_allocator_realloc_(const vec_allocator_t *a, uint8_t *existing, size_t copy_bytes,
+                                       size_t old_bytes, size_t new_bytes) {
+  uint8_t *new_region;
+  if (existing == NULL) {
+    return a->alloc(a->user, new_bytes);
+  }
+  if (a->realloc != NULL) {
+    return a->realloc(a->user, existing, old_bytes, new_bytes);
+  }
+  new_region = a->alloc(a->user, new_bytes);
+  if (new_region) {
+    memcpy(new_region, existing, copy_bytes);
+    a->free(a->user, existing, old_bytes);
+  }
+  return new_region;
+}
+
+static size_t vec_map_threshold_ = VEC_MAP_THRESHOLD;
+
+void vec_map_set_threshold(size_t bytes) {
+  vec_map_threshold_ = bytes == 0 ? VEC_MAP_THRESHOLD : bytes;
+}
+
+size_t vec_map_threshold(void) {
+  return vec_map_threshold_;
+}
+
+#if defined(VEC_HAVE_MMAP)
+static size_t vec_map_round_(size_t bytes) {
+  size_t page = (size_t)sysconf(_SC_PAGESIZE);
+  return (bytes + page - 1) & ~(page - 1);
+}
+#endif
+
+// Storage of a vec_init_mapped vector, VEC_MALLOC below the threshold and a mapping above
+// it. VEC_MAPPED_DATA is set while the storage is a mapping.
+static uint8_t *vec_map_resize_(uint8_t *existing, vec_size_t *options, size_t copy_bytes, size_t old_bytes, size_t new_bytes) {
+#if defined(VEC_HAVE_MMAP)
+  uint8_t *p;
+  if (new_bytes < vec_map_threshold_) {
+    if (0 == (*options & VEC_MAPPED_DATA)) {
+      return VEC_REALLOC(existing, new_bytes);
+    }
+    p = VEC_MALLOC(new_bytes);
+    if (p != NULL) {
+      memcpy(p, existing, copy_bytes);
+      munmap(existing, vec_map_round_(old_bytes));
+      *options &= ~(vec_size_t)VEC_MAPPED_DATA;
+    }
+    return p;
+  }
+  if (*options & VEC_MAPPED_DATA) {
+    if (vec_map_round_(old_bytes) == vec_map_round_(new_bytes)) {
+      return existing;
+    }
+#if defined(MREMAP_MAYMOVE)
+    // the kernel moves the page table entries, the elements are not copied
+    p = mremap(existing, vec_map_round_(old_bytes), vec_map_round_(new_bytes), MREMAP_MAYMOVE);
+    return p == MAP_FAILED ? NULL : p;
+#endif
+  }
+  p = mmap(NULL, vec_map_round_(new_bytes), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (p == MAP_FAILED) {
+    return NULL;
+  }
+  if (copy_bytes > 0) {
+    memcpy(p, existing, copy_bytes);
+  }
+  if (*options & VEC_MAPPED_DATA) {
+    munmap(existing, vec_map_round_(old_bytes));
+  } else {
+    VEC_FREE(existing);
+  }
+  *options |= VEC_MAPPED_DATA;
+  return p;
+#else
+  (void) options;
+  (void) copy_bytes;
+  (void) old_bytes;
+  return VEC_REALLOC(existing, new_bytes);
+#endif
+}
+
+// Resize the vector memory from `old_bytes` to `new_bytes`, `copy_bytes` are in use
+static uint8_t *vec_alloc_mem_(uint8_t *existing, vec_size_t *options, size_t copy_bytes, size_t old_bytes, size_t new_bytes) {
+  // Arena blocks know their arena, the last block of the arena grows in place
+  if (*options & VEC_ARENA) {
+    return vec_arena_realloc(existing, new_bytes);
+  }
+
+  if (*options & VEC_ALLOCATOR) {
+    return vec_allocator_realloc_(vec_allocator_of_(options), existing, copy_bytes, old_bytes, new_bytes);
+  }
+
+  if (*options & VEC_MAPPED) {
+    return vec_map_resize_(existing, options, copy_bytes, old_bytes, new_bytes);
+  }
 
-static uint8_t *vec_alloc_mem_(uint8_t *existing, vec_size_t *options, size_t existing_bytes, size_t new_bytes) {
   // If the vector doesn't own memory a new region must be acquired, do not release the old region
   if (0 == (*options & VEC_OWNS_MEMORY)) {
     uint8_t *new_region = VEC_MALLOC(new_bytes);
     if (new_region) {
-      memcpy(new_region, existing, existing_bytes);
-      *options |= VEC_OWNS_MEMORY;
+      memcpy(new_region, existing, copy_bytes);
+      *options = (*options & ~(vec_size_t)VEC_SBO) | VEC_OWNS_MEMORY;
       return new_region;
     }
     *options |= VEC_OOM;
@@ -26,13 +196,16 @@ static uint8_t *vec_alloc_mem_(uint8_t *existing, vec_size_t *options, size_t ex
   return VEC_REALLOC(existing, new_bytes);
 }
 
-int vec_expand_(uint8_t **data, vec_size_t *options, const vec_size_t *length, vec_size_t *capacity, vec_size_t memsz) {
-  if (*length + 1 > *capacity) {
+int vec_expand_n_(uint8_t **data, vec_size_t *options, const vec_size_t *length, vec_size_t *capacity, vec_size_t memsz, vec_size_t n) {
+  if (*length + n > *capacity) {
     if (0 == (*options & VEC_ALLOW_REALLOC)) {
       return VEC_ERR_NO_REALLOC;
     }
     size_t new_capacity = (*capacity == 0) ? VEC_INIT_CAPACITY : VEC_GROW_CAPACITY(*capacity);
-    uint8_t* ptr = vec_alloc_mem_(*data, options, *length * memsz, new_capacity * memsz);
+    if (new_capacity < *length + n) {
+      new_capacity = *length + n;
+    }
+    uint8_t* ptr = vec_alloc_mem_(*data, options, *length * memsz, *capacity * memsz, new_capacity * memsz);
     if (ptr == NULL) {
       *options |= VEC_OOM;
       return VEC_ERR_NO_MEMORY;
@@ -44,13 +217,18 @@ int vec_expand_(uint8_t **data, vec_size_t *options, const vec_size_t *length, v
 }
 
 
+VEC_COLD int vec_expand_(uint8_t **data, vec_size_t *options, const vec_size_t *length, vec_size_t *capacity, vec_size_t memsz) {
+  return vec_expand_n_(data, options, length, capacity, memsz, 1);
+}
+
+
 int vec_reserve_(uint8_t **data, vec_size_t *options, const vec_size_t *length, vec_size_t *capacity, vec_size_t memsz, vec_size_t n) {
   (void) length;
   if (n > *capacity) {
     if (0 == (*options & VEC_ALLOW_REALLOC)) {
       return VEC_ERR_NO_REALLOC;
     }
-    uint8_t *ptr = vec_alloc_mem_(*data, options, *length * memsz, n * memsz);
+    uint8_t *ptr = vec_alloc_mem_(*data, options, *length * memsz, *capacity * memsz, n * memsz);
     if (ptr == NULL) {
       *options |= VEC_OOM;
       return VEC_ERR_NO_MEMORY;
@@ -63,11 +241,25 @@ int vec_reserve_(uint8_t **data, vec_size_t *options, const vec_size_t *length,
 
 
 int vec_compact_(uint8_t **data, vec_size_t *options, const size_t *length, vec_size_t *capacity, vec_size_t memsz) {
+  // inline elements can't shrink
+  if (*options & VEC_SBO) {
+    return VEC_OK;
+  }
   if (*length == 0) {
-    if (*options & VEC_OWNS_MEMORY) {
-      VEC_FREE(*data);
+    if (*options & VEC_ARENA) {
+      // keep the empty block, it ties the vector to its arena
+      *data = vec_arena_realloc(*data, 0);
+    } else {
+      if (*options & VEC_MAPPED_DATA) {
+        vec_unmap_(data, options, length, capacity, memsz);
+        *options &= ~(vec_size_t)VEC_MAPPED_DATA;
+      } else if (*options & VEC_OWNS_MEMORY) {
+        VEC_FREE(*data);
+      } else if (*options & VEC_ALLOCATOR) {
+        vec_allocator_free_(data, options, length, capacity, memsz);
+      }
+      *data = NULL;
     }
-    *data = NULL;
     *capacity = 0;
   } else {
     if (0 == (*options & VEC_ALLOW_REALLOC)) {
@@ -75,7 +267,7 @@ int vec_compact_(uint8_t **data, vec_size_t *options, const size_t *length, vec_
     }
 
     vec_size_t n = *length;
-    uint8_t *ptr = vec_alloc_mem_(*data, options, *capacity * memsz, n * memsz);
+    uint8_t *ptr = vec_alloc_mem_(*data, options, n * memsz, *capacity * memsz, n * memsz);
     if (ptr == NULL) {
       *options |= VEC_OOM;
       return VEC_ERR_NO_MEMORY;
@@ -87,6 +279,189 @@ int vec_compact_(uint8_t **data, vec_size_t *options, const size_t *length, vec_
 }
 
 
+//
+// Arena allocation, each block is preceded by a vec_arena_block_t and the arena top is
+// kept aligned to VEC_ARENA_ALIGN so every block is aligned for any element type
+//
+#define VEC_ARENA_ALIGN 16
+#define VEC_ARENA_ROUND(n) (((n) + VEC_ARENA_ALIGN - 1) & ~(size_t)(VEC_ARENA_ALIGN - 1))
+
+typedef struct {
+  vec_arena_t *arena;
+  size_t size;
+} vec_arena_block_t;
+
+#define VEC_ARENA_BLOCK_HEADER VEC_ARENA_ROUND(sizeof(vec_arena_block_t))
+#define VEC_ARENA_CHUNK_HEADER VEC_ARENA_ROUND(sizeof(vec_arena_chunk_t))
+
+static vec_arena_block_t *vec_arena_block_(void *ptr) {
+  return (vec_arena_block_t *)((uint8_t *)ptr - VEC_ARENA_BLOCK_HEADER);
+}
+
+
+void vec_arena_init(vec_arena_t *arena, size_t chunk_size) {
+  arena->chunks = NULL;
+  arena->top = NULL;
+  arena->end = NULL;
+  arena->chunk_size = chunk_size == 0 ? VEC_ARENA_CHUNK : chunk_size;
+}
+
+
+void vec_arena_deinit(vec_arena_t *arena) {
+  while (arena->chunks != NULL) {
+    vec_arena_chunk_t *next = arena->chunks->next;
+    VEC_FREE(arena->chunks);
+    arena->chunks = next;
+  }
+  arena->top = NULL;
+  arena->end = NULL;
+}
+
+
+// Chunks are replaced by one chunk of their total size, so an arena reset after each
+// request settles on a single chunk that holds a whole request
+void vec_arena_reset(vec_arena_t *arena) {
+  vec_arena_chunk_t *keep = arena->chunks, *chunk;
+  size_t size = 0;
+  if (keep == NULL) {
+    return;
+  }
+  if (keep->next != NULL) {
+    for (chunk = keep; chunk != NULL; chunk = chunk->next) {
+      size += chunk->size;
+    }
+    vec_arena_deinit(arena);
+    keep = (vec_arena_chunk_t *)VEC_MALLOC(size);
+    if (keep == NULL) {
+      return;
+    }
+    keep->size = size;
+  }
+  keep->next = NULL;
+  arena->chunks = keep;
+  arena->top = (uint8_t *)keep + VEC_ARENA_CHUNK_HEADER;
+  arena->end = (uint8_t *)keep + keep->size;
+}
+
+
+void *vec_arena_alloc(vec_arena_t *arena, size_t bytes) {
+  size_t need = VEC_ARENA_BLOCK_HEADER + VEC_ARENA_ROUND(bytes);
+  vec_arena_block_t *block;
+  if (bytes > (size_t)-1 - VEC_ARENA_CHUNK_HEADER - VEC_ARENA_BLOCK_HEADER - VEC_ARENA_ALIGN) {
+    return NULL;
+  }
+  if ((size_t)(arena->end - arena->top) < need) {
+    // the rest of the current chunk is left unused
+    size_t size = arena->chunk_size < VEC_ARENA_CHUNK_HEADER + need
+                ? VEC_ARENA_CHUNK_HEADER + need : arena->chunk_size;
+    vec_arena_chunk_t *chunk = (vec_arena_chunk_t *)VEC_MALLOC(size);
+    if (chunk == NULL) {
+      return NULL;
+    }
+    chunk->next = arena->chunks;
+    chunk->size = size;
+    arena->chunks = chunk;
+    arena->top = (uint8_t *)chunk + VEC_ARENA_CHUNK_HEADER;
+    arena->end = (uint8_t *)chunk + size;
+  }
+  block = (vec_arena_block_t *)arena->top;
+  block->arena = arena;
+  block->size = bytes;
+  arena->top += need;
+  return (uint8_t *)block + VEC_ARENA_BLOCK_HEADER;
+}
+
+
+void *vec_arena_realloc(void *ptr, size_t bytes) {
+  vec_arena_block_t *block = vec_arena_block_(ptr);
+  vec_arena_t *arena = block->arena;
+  uint8_t *p = (uint8_t *)ptr, *grown;
+  if (p + VEC_ARENA_ROUND(block->size) == arena->top) {
+    // the last block, move the top of the arena when the chunk has room
+    size_t room = (size_t)(arena->end - p);
+    if (bytes <= room && VEC_ARENA_ROUND(bytes) <= room) {
+      arena->top = p + VEC_ARENA_ROUND(bytes);
+      block->size = bytes;
+      return ptr;
+    }
+  } else if (bytes <= block->size) {
+    block->size = bytes;
+    return ptr;
+  }
+  grown = (uint8_t *)vec_arena_alloc(arena, bytes);
+  if (grown != NULL) {
+    memcpy(grown, p, block->size < bytes ? block->size : bytes);
+  }
+  return grown;
+}
+
+
+void vec_arena_free(void *ptr) {
+  vec_arena_block_t *block;
+  if (ptr == NULL) {
+    return;
+  }
+  block = vec_arena_block_(ptr);
+  if ((uint8_t *)ptr + VEC_ARENA_ROUND(block->size) == block->arena->top) {
+    block->arena->top = (uint8_t *)block;
+  }
+}
+
+
+int vec_init_with_arena_(uint8_t **data, vec_size_t *options, size_t *length, vec_size_t *capacity, vec_size_t memsz,
+                         vec_arena_t *arena) {
+  (void) memsz;
+  *data = (uint8_t *)vec_arena_alloc(arena, 0);
+  *length = 0;
+  *capacity = 0;
+  if (*data == NULL) {
+    *options = VEC_FIXED | VEC_OOM;
+    return VEC_ERR_NO_MEMORY;
+  }
+  *options = VEC_ARENA | VEC_ALLOW_REALLOC;
+  return VEC_OK;
+}
+
+
+int vec_init_with_allocator_(uint8_t **data, vec_size_t *options, size_t *length, vec_size_t *capacity, vec_size_t memsz,
+                             const vec_allocator_t **allocator, const vec_allocator_t *a) {
+  (void) memsz;
+  *allocator = a;
+  *data = NULL;
+  *length = 0;
+  *capacity = 0;
+  if (a == NULL) {
+    *options = VEC_FIXED | VEC_OOM;
+    return VEC_ERR;
+  }
+  *options = VEC_ALLOCATOR | VEC_ALLOW_REALLOC;
+  return VEC_OK;
+}
+
+
+void vec_unmap_(uint8_t *const *data, const vec_size_t *options, const size_t *length, const vec_size_t *capacity, vec_size_t memsz) {
+  (void) options;
+  (void) length;
+#if defined(VEC_HAVE_MMAP)
+  munmap(*data, vec_map_round_(*capacity * memsz));
+#else
+  (void) data;
+  (void) capacity;
+  (void) memsz;
+#endif
+}
+
+
+void vec_allocator_free_(uint8_t *const *data, const vec_size_t *options, const size_t *length, const vec_size_t *capacity, vec_size_t memsz) {
+  const vec_allocator_t *a;
+  (void) length;
+  if (*data != NULL) {
+    a = vec_allocator_of_(options);
+    a->free(a->user, *data, *capacity * memsz);
+  }
+}
+
+
 int vec_insert_(uint8_t **data, vec_size_t *options, size_t *length, vec_size_t *capacity, vec_size_t memsz, vec_size_t idx) {
   int err = vec_expand_(data, options, length, capacity, memsz);
   if (err != VEC_OK) {
@@ -99,6 +474,20 @@ int vec_insert_(uint8_t **data, vec_size_t *options, size_t *length, vec_size_t
 }
 
 
+int vec_insertarr_(uint8_t **data, vec_size_t *options, const size_t *length, vec_size_t *capacity, vec_size_t memsz, vec_size_t idx, vec_size_t count) {
+  int err = vec_expand_n_(data, options, length, capacity, memsz, count);
+  if (err != VEC_OK) {
+    return err;
+  }
+  if (count > 0) {
+    memmove(*data + (idx + count) * memsz,
+            *data + idx * memsz,
+            (*length - idx) * memsz);
+  }
+  return VEC_OK;
+}
+
+
 void vec_splice_(uint8_t * const*data, const vec_size_t *options, const size_t *length, const vec_size_t *capacity, vec_size_t memsz, vec_size_t start, vec_size_t count) {
   (void) options;
   (void) capacity;
@@ -108,6 +497,58 @@ void vec_splice_(uint8_t * const*data, const vec_size_t *options, const size_t *
 }
 
 
+// One step of the batch splice sweep: `*read` is the first element of the next surviving
+// run and `*write` is where it lands. Removing [first, last) moves that run down with one
+// memmove, spans behind the sweep or past the end are clamped away.
+VEC_INLINE void vec_splice_step_(uint8_t *data, vec_size_t memsz, vec_size_t len,
+                                 vec_size_t *read, vec_size_t *write,
+                                 vec_size_t first, vec_size_t last) {
+  if (last > len) last = len;
+  if (first < *read) first = *read;
+  if (first >= last) {
+    return;
+  }
+  if (*write != *read && first > *read) {
+    memmove(data + *write * memsz, data + *read * memsz, (first - *read) * memsz);
+  }
+  *write += first - *read;
+  *read = last;
+}
+
+
+// Move the final surviving run down, returns the number of elements removed
+static vec_size_t vec_splice_finish_(uint8_t *data, vec_size_t memsz, vec_size_t len,
+                                     vec_size_t read, vec_size_t write) {
+  if (write != read && len > read) {
+    memmove(data + write * memsz, data + read * memsz, (len - read) * memsz);
+  }
+  return read - write;
+}
+
+
+vec_size_t vec_splice_indices_(uint8_t *const *data, const vec_size_t *options, const size_t *length, const vec_size_t *capacity, vec_size_t memsz, const vec_size_t *idx, vec_size_t count) {
+  vec_size_t len = *length, read = 0, write = 0;
+  (void) options;
+  (void) capacity;
+  for (vec_size_t i = 0; i < count && read < len; ++i) {
+    vec_splice_step_(*data, memsz, len, &read, &write, idx[i], idx[i] + 1);
+  }
+  return vec_splice_finish_(*data, memsz, len, read, write);
+}
+
+
+vec_size_t vec_splice_ranges_(uint8_t *const *data, const vec_size_t *options, const size_t *length, const vec_size_t *capacity, vec_size_t memsz, const vec_range_t *ranges, vec_size_t count) {
+  vec_size_t len = *length, read = 0, write = 0;
+  (void) options;
+  (void) capacity;
+  for (vec_size_t i = 0; i < count && read < len; ++i) {
+    vec_size_t start = ranges[i].start, n = ranges[i].count;
+    vec_splice_step_(*data, memsz, len, &read, &write, start, start < len && n < len - start ? start + n : len);
+  }
+  return vec_splice_finish_(*data, memsz, len, read, write);
+}
+
+
 void vec_swapsplice_(uint8_t *const *data, const vec_size_t *options, const size_t *length, const vec_size_t *capacity, vec_size_t memsz, vec_size_t start, vec_size_t count) {
   (void) options;
   (void) capacity;
@@ -117,24 +558,716 @@ void vec_swapsplice_(uint8_t *const *data, const vec_size_t *options, const size
 }
 
 
+// Swap `memsz` bytes between `a` and `b` using the widest moves that fit, the fixed size
+// copies compile to single vector or word moves
+static void vec_swap_bytes_(uint8_t *a, uint8_t *b, vec_size_t memsz) {
+  uint64_t t0[4], t1[4];
+  while (memsz >= 32) {
+    memcpy(t0, a, 32);
+    memcpy(t1, b, 32);
+    memcpy(a, t1, 32);
+    memcpy(b, t0, 32);
+    a += 32, b += 32, memsz -= 32;
+  }
+  if (memsz >= 16) {
+    memcpy(t0, a, 16);
+    memcpy(t1, b, 16);
+    memcpy(a, t1, 16);
+    memcpy(b, t0, 16);
+    a += 16, b += 16, memsz -= 16;
+  }
+  if (memsz >= 8) {
+    memcpy(t0, a, 8);
+    memcpy(t1, b, 8);
+    memcpy(a, t1, 8);
+    memcpy(b, t0, 8);
+    a += 8, b += 8, memsz -= 8;
+  }
+  if (memsz >= 4) {
+    memcpy(t0, a, 4);
+    memcpy(t1, b, 4);
+    memcpy(a, t1, 4);
+    memcpy(b, t0, 4);
+    a += 4, b += 4, memsz -= 4;
+  }
+  while (memsz--) {
+    uint8_t tmp = *a;
+    *a = *b;
+    *b = tmp;
+    a++, b++;
+  }
+}
+
+
 void vec_swap_(uint8_t *const *data, const vec_size_t *options, const vec_size_t *length, const vec_size_t *capacity, vec_size_t memsz, vec_size_t idx1, vec_size_t idx2) {
   (void) options;
   (void) length;
   (void) capacity;
-  uint8_t *a, *b, tmp;
-  vec_size_t count;
 
   if (idx1 == idx2) {
       return;
   }
-  a = *data + idx1 * memsz;
-  b = *data + idx2 * memsz;
-  count = memsz;
-  while (count--) {
-    tmp = *a;
-    *a = *b;
-    *b = tmp;
-    a++, b++;
+  vec_swap_bytes_(*data + idx1 * memsz, *data + idx2 * memsz, memsz);
+}
+
+
+//
+// Reverse engine, each kernel reverses whole blocks from both ends of [lo, hi) and
+// advances the pointers, leaving the middle to the next narrower kernel
+//
+#define VEC_REVERSE_SCALAR_(T)                          \
+  while (hi - lo >= 2 * (ptrdiff_t)sizeof(T)) {         \
+    T a, b;                                             \
+    hi -= sizeof(T);                                    \
+    memcpy(&a, lo, sizeof(T));                          \
+    memcpy(&b, hi, sizeof(T));                          \
+    memcpy(lo, &b, sizeof(T));                          \
+    memcpy(hi, &a, sizeof(T));                          \
+    lo += sizeof(T);                                    \
+  }
+
+#define VEC_REVERSE_BLOCKS_(T, load, store, rev)        \
+  while (hi - lo >= 2 * (ptrdiff_t)sizeof(T)) {         \
+    T a, b;                                             \
+    hi -= sizeof(T);                                    \
+    a = load((const T *)lo);                            \
+    b = load((const T *)hi);                            \
+    store((T *)lo, rev(b));                             \
+    store((T *)hi, rev(a));                             \
+    lo += sizeof(T);                                    \
   }
+
+static void vec_reverse_scalar_(uint8_t *lo, uint8_t *hi, vec_size_t memsz) {
+  switch (memsz) {
+  case 1: VEC_REVERSE_SCALAR_(uint8_t) break;
+  case 2: VEC_REVERSE_SCALAR_(uint16_t) break;
+  case 4: VEC_REVERSE_SCALAR_(uint32_t) break;
+  case 8: VEC_REVERSE_SCALAR_(uint64_t) break;
+  default:
+    while (hi - lo >= 2 * (ptrdiff_t)memsz) {
+      hi -= memsz;
+      vec_swap_bytes_(lo, hi, memsz);
+      lo += memsz;
+    }
+    break;
+  }
+}
+
+#if defined(VEC_HAVE_SSE2)
+static __m128i vec_rev64_sse2_(__m128i x) {
+  return _mm_shuffle_epi32(x, _MM_SHUFFLE(1, 0, 3, 2));
 }
 
+static __m128i vec_rev32_sse2_(__m128i x) {
+  return _mm_shuffle_epi32(x, _MM_SHUFFLE(0, 1, 2, 3));
+}
+
+static __m128i vec_rev16_sse2_(__m128i x) {
+  x = _mm_shufflelo_epi16(x, _MM_SHUFFLE(0, 1, 2, 3));
+  x = _mm_shufflehi_epi16(x, _MM_SHUFFLE(0, 1, 2, 3));
+  return vec_rev64_sse2_(x);
+}
+
+static __m128i vec_rev8_sse2_(__m128i x) {
+  x = vec_rev16_sse2_(x);
+  return _mm_or_si128(_mm_slli_epi16(x, 8), _mm_srli_epi16(x, 8));
+}
+
+static __m128i vec_rev128_sse2_(__m128i x) {
+  return x;
+}
+
+static void vec_reverse_sse2_(uint8_t **plo, uint8_t **phi, vec_size_t memsz) {
+  uint8_t *lo = *plo, *hi = *phi;
+  switch (memsz) {
+  case 1: VEC_REVERSE_BLOCKS_(__m128i, _mm_loadu_si128, _mm_storeu_si128, vec_rev8_sse2_) break;
+  case 2: VEC_REVERSE_BLOCKS_(__m128i, _mm_loadu_si128, _mm_storeu_si128, vec_rev16_sse2_) break;
+  case 4: VEC_REVERSE_BLOCKS_(__m128i, _mm_loadu_si128, _mm_storeu_si128, vec_rev32_sse2_) break;
+  case 8: VEC_REVERSE_BLOCKS_(__m128i, _mm_loadu_si128, _mm_storeu_si128, vec_rev64_sse2_) break;
+  case 16: VEC_REVERSE_BLOCKS_(__m128i, _mm_loadu_si128, _mm_storeu_si128, vec_rev128_sse2_) break;
+  default: break;
+  }
+  *plo = lo, *phi = hi;
+}
+#endif // VEC_HAVE_SSE2
+
+#if defined(VEC_HAVE_AVX2)
+VEC_TARGET_AVX2 static __m256i vec_rev128_avx2_(__m256i x) {
+  return _mm256_permute4x64_epi64(x, _MM_SHUFFLE(1, 0, 3, 2));
+}
+
+VEC_TARGET_AVX2 static __m256i vec_rev64_avx2_(__m256i x) {
+  return _mm256_permute4x64_epi64(x, _MM_SHUFFLE(0, 1, 2, 3));
+}
+
+VEC_TARGET_AVX2 static __m256i vec_rev32_avx2_(__m256i x) {
+  return _mm256_permutevar8x32_epi32(x, _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0));
+}
+
+VEC_TARGET_AVX2 static __m256i vec_rev16_avx2_(__m256i x) {
+  const __m256i mask = _mm256_setr_epi8(14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1,
+                                        14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1);
+  return vec_rev128_avx2_(_mm256_shuffle_epi8(x, mask));
+}
+
+VEC_TARGET_AVX2 static __m256i vec_rev8_avx2_(__m256i x) {
+  const __m256i mask = _mm256_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0,
+                                        15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+  return vec_rev128_avx2_(_mm256_shuffle_epi8(x, mask));
+}
+
+VEC_TARGET_AVX2 static void vec_reverse_avx2_(uint8_t **plo, uint8_t **phi, vec_size_t memsz) {
+  uint8_t *lo = *plo, *hi = *phi;
+  switch (memsz) {
+  case 1: VEC_REVERSE_BLOCKS_(__m256i, _mm256_loadu_si256, _mm256_storeu_si256, vec_rev8_avx2_) break;
+  case 2: VEC_REVERSE_BLOCKS_(__m256i, _mm256_loadu_si256, _mm256_storeu_si256, vec_rev16_avx2_) break;
+  case 4: VEC_REVERSE_BLOCKS_(__m256i, _mm256_loadu_si256, _mm256_storeu_si256, vec_rev32_avx2_) break;
+  case 8: VEC_REVERSE_BLOCKS_(__m256i, _mm256_loadu_si256, _mm256_storeu_si256, vec_rev64_avx2_) break;
+  case 16: VEC_REVERSE_BLOCKS_(__m256i, _mm256_loadu_si256, _mm256_storeu_si256, vec_rev128_avx2_) break;
+  default: break;
+  }
+  *plo = lo, *phi = hi;
+}
+#endif // VEC_HAVE_AVX2
+
+
+void vec_reverse_(uint8_t *const *data, const vec_size_t *options, const size_t *length, const vec_size_t *capacity, vec_size_t memsz) {
+  (void) options;
+  (void) capacity;
+  uint8_t *lo = *data;
+  uint8_t *hi = *data + *length * memsz;
+  int level = vec_simd_level();
+  (void) level;
+
+#if defined(VEC_HAVE_AVX2)
+  if (level >= VEC_SIMD_AVX2) {
+    vec_reverse_avx2_(&lo, &hi, memsz);
+  }
+#endif
+#if defined(VEC_HAVE_SSE2)
+  if (level >= VEC_SIMD_SSE2) {
+    vec_reverse_sse2_(&lo, &hi, memsz);
+  }
+#endif
+  vec_reverse_scalar_(lo, hi, memsz);
+}
+
+
+//
+// Linear search kernels for vec_find, vec_rfind and vec_count. Integer and pointer
+// elements compare by value, float and double with `==` so -0.0 matches 0.0 and NaN
+// never matches, anything else compares byte for byte.
+//
+#define VEC_SCAN_FIND 0
+#define VEC_SCAN_RFIND 1
+#define VEC_SCAN_COUNT 2
+
+#if defined(__GNUC__) || defined(__clang__)
+#define vec_msb_(m) ((vec_size_t)(31 - __builtin_clz(m)))
+#else
+static vec_size_t vec_msb_(unsigned m) {
+  vec_size_t n = 0;
+  while (m >>= 1) ++n;
+  return n;
+}
+#endif
+
+// Scalar scan of [lo, hi) with the element compare `EQ(p)`, count returns the matches
+#define VEC_SCAN_SCALAR_(EQ)                                            \
+  switch (op) {                                                         \
+  case VEC_SCAN_FIND:                                                   \
+    for (p = data + lo * memsz; lo < hi; ++lo, p += memsz) {            \
+      if (EQ(p)) return lo;                                             \
+    }                                                                   \
+    return VEC_NOT_FOUND;                                               \
+  case VEC_SCAN_RFIND:                                                  \
+    for (p = data + hi * memsz; hi > lo;) {                             \
+      --hi, p -= memsz;                                                 \
+      if (EQ(p)) return hi;                                             \
+    }                                                                   \
+    return VEC_NOT_FOUND;                                               \
+  default:                                                              \
+    for (p = data + lo * memsz; lo < hi; ++lo, p += memsz) {            \
+      count += (EQ(p)) ? 1 : 0;                                         \
+    }                                                                   \
+    return count;                                                       \
+  }
+
+#define VEC_EQ_U8_(p) (*(p) == *key)
+#define VEC_EQ_U16_(p) (*(const uint16_t *)(p) == *(const uint16_t *)key)
+#define VEC_EQ_U32_(p) (*(const uint32_t *)(p) == *(const uint32_t *)key)
+#define VEC_EQ_U64_(p) (*(const uint64_t *)(p) == *(const uint64_t *)key)
+#define VEC_EQ_F32_(p) (*(const float *)(p) == *(const float *)key)
+#define VEC_EQ_F64_(p) (*(const double *)(p) == *(const double *)key)
+#define VEC_EQ_LDBL_(p) (*(const long double *)(p) == *(const long double *)key)
+#define VEC_EQ_BYTES_(p) (0 == memcmp((p), key, memsz))
+
+static vec_size_t vec_scan_scalar_(int op, const uint8_t *data, vec_size_t lo, vec_size_t hi,
+                                   vec_size_t memsz, int kind, const uint8_t *key) {
+  const uint8_t *p;
+  vec_size_t count = 0;
+  if (kind == VEC_KIND_BITS) {
+    switch (memsz) {
+    case 1: VEC_SCAN_SCALAR_(VEC_EQ_U8_)
+    case 2: VEC_SCAN_SCALAR_(VEC_EQ_U16_)
+    case 4: VEC_SCAN_SCALAR_(VEC_EQ_U32_)
+    case 8: VEC_SCAN_SCALAR_(VEC_EQ_U64_)
+    default: break;
+    }
+  } else if (kind == VEC_KIND_FLOAT) {
+    if (memsz == sizeof(float)) {
+      VEC_SCAN_SCALAR_(VEC_EQ_F32_)
+    } else if (memsz == sizeof(double)) {
+      VEC_SCAN_SCALAR_(VEC_EQ_F64_)
+    } else if (memsz == sizeof(long double)) {
+      VEC_SCAN_SCALAR_(VEC_EQ_LDBL_)
+    }
+  }
+  VEC_SCAN_SCALAR_(VEC_EQ_BYTES_)
+}
+
+// Block scan narrowing [*lo, *hi) to the elements left for the scalar scan. `EQ` sets
+// every byte of a matching element so the byte mask has W bits per element. Counting
+// subtracts the compare result into byte lanes, `HSUM` folds them before they can wrap.
+#define VEC_SCAN_BLOCKS_(VT, LOADU, MOVEMASK, SETZERO, SUB8, HSUM, EQ, W)   \
+  {                                                                         \
+    const vec_size_t per = sizeof(VT) / (W);                                \
+    const VT k = LOADU((const VT *)key);                                    \
+    unsigned m;                                                             \
+    if (op == VEC_SCAN_FIND) {                                              \
+      for (; *hi - *lo >= per; *lo += per) {                                \
+        m = (unsigned)MOVEMASK(EQ(LOADU((const VT *)(data + *lo * (W))), k)); \
+        if (m) return *lo + vec_ctz_(m) / (W);                              \
+      }                                                                     \
+    } else if (op == VEC_SCAN_RFIND) {                                      \
+      for (; *hi - *lo >= per; *hi -= per) {                                \
+        m = (unsigned)MOVEMASK(EQ(LOADU((const VT *)(data + (*hi - per) * (W))), k)); \
+        if (m) return *hi - per + vec_msb_(m) / (W);                        \
+      }                                                                     \
+    } else {                                                                \
+      VT acc = SETZERO();                                                   \
+      vec_size_t bytes = 0;                                                 \
+      unsigned run = 0;                                                     \
+      for (; *hi - *lo >= per; *lo += per) {                                \
+        acc = SUB8(acc, EQ(LOADU((const VT *)(data + *lo * (W))), k));      \
+        if (++run == 255) {                                                 \
+          bytes += HSUM(acc);                                               \
+          acc = SETZERO();                                                  \
+          run = 0;                                                          \
+        }                                                                   \
+      }                                                                     \
+      *count += (bytes + HSUM(acc)) / (W);                                  \
+    }                                                                       \
+  }                                                                         \
+  break;
+
+#define VEC_SCAN_SWITCH_(VT, LOADU, MOVEMASK, SETZERO, SUB8, HSUM,         \
+                         EQ8, EQ16, EQ32, EQ64, EQF32, EQF64)               \
+  if (kind == VEC_KIND_BITS) {                                              \
+    switch (memsz) {                                                        \
+    case 1: VEC_SCAN_BLOCKS_(VT, LOADU, MOVEMASK, SETZERO, SUB8, HSUM, EQ8, 1) \
+    case 2: VEC_SCAN_BLOCKS_(VT, LOADU, MOVEMASK, SETZERO, SUB8, HSUM, EQ16, 2) \
+    case 4: VEC_SCAN_BLOCKS_(VT, LOADU, MOVEMASK, SETZERO, SUB8, HSUM, EQ32, 4) \
+    case 8: VEC_SCAN_BLOCKS_(VT, LOADU, MOVEMASK, SETZERO, SUB8, HSUM, EQ64, 8) \
+    default: break;                                                         \
+    }                                                                       \
+  } else if (kind == VEC_KIND_FLOAT) {                                      \
+    switch (memsz) {                                                        \
+    case 4: VEC_SCAN_BLOCKS_(VT, LOADU, MOVEMASK, SETZERO, SUB8, HSUM, EQF32, 4) \
+    case 8: VEC_SCAN_BLOCKS_(VT, LOADU, MOVEMASK, SETZERO, SUB8, HSUM, EQF64, 8) \
+    default: break;                                                         \
+    }                                                                       \
+  }                                                                         \
+  return VEC_NOT_FOUND;
+
+#if defined(VEC_HAVE_SSE2)
+static __m128i vec_eq8_sse2_(__m128i a, __m128i b) {
+  return _mm_cmpeq_epi8(a, b);
+}
+
+static __m128i vec_eq16_sse2_(__m128i a, __m128i b) {
+  return _mm_cmpeq_epi16(a, b);
+}
+
+static __m128i vec_eq32_sse2_(__m128i a, __m128i b) {
+  return _mm_cmpeq_epi32(a, b);
+}
+
+// SSE2 has no 64 bit compare, both 32 bit halves have to match
+static __m128i vec_eq64_sse2_(__m128i a, __m128i b) {
+  __m128i e = _mm_cmpeq_epi32(a, b);
+  return _mm_and_si128(e, _mm_shuffle_epi32(e, _MM_SHUFFLE(2, 3, 0, 1)));
+}
+
+static __m128i vec_eqf32_sse2_(__m128i a, __m128i b) {
+  return _mm_castps_si128(_mm_cmpeq_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b)));
+}
+
+static __m128i vec_eqf64_sse2_(__m128i a, __m128i b) {
+  return _mm_castpd_si128(_mm_cmpeq_pd(_mm_castsi128_pd(a), _mm_castsi128_pd(b)));
+}
+
+// Sum of the byte lanes
+static vec_size_t vec_hsum_sse2_(__m128i x) {
+  __m128i s = _mm_sad_epu8(x, _mm_setzero_si128());
+  return (vec_size_t)_mm_cvtsi128_si32(s) + (vec_size_t)_mm_cvtsi128_si32(_mm_srli_si128(s, 8));
+}
+
+static vec_size_t vec_scan_sse2_(int op, const uint8_t *data, vec_size_t *lo, vec_size_t *hi,
+                                 vec_size_t memsz, int kind, const uint8_t *key, vec_size_t *count) {
+  VEC_SCAN_SWITCH_(__m128i, _mm_loadu_si128, _mm_movemask_epi8,
+                   _mm_setzero_si128, _mm_sub_epi8, vec_hsum_sse2_,
+                   vec_eq8_sse2_, vec_eq16_sse2_, vec_eq32_sse2_, vec_eq64_sse2_,
+                   vec_eqf32_sse2_, vec_eqf64_sse2_)
+}
+#endif // VEC_HAVE_SSE2
+
+#if defined(VEC_HAVE_AVX2)
+VEC_TARGET_AVX2 static __m256i vec_eq8_avx2_(__m256i a, __m256i b) {
+  return _mm256_cmpeq_epi8(a, b);
+}
+
+VEC_TARGET_AVX2 static __m256i vec_eq16_avx2_(__m256i a, __m256i b) {
+  return _mm256_cmpeq_epi16(a, b);
+}
+
+VEC_TARGET_AVX2 static __m256i vec_eq32_avx2_(__m256i a, __m256i b) {
+  return _mm256_cmpeq_epi32(a, b);
+}
+
+VEC_TARGET_AVX2 static __m256i vec_eq64_avx2_(__m256i a, __m256i b) {
+  return _mm256_cmpeq_epi64(a, b);
+}
+
+VEC_TARGET_AVX2 static __m256i vec_eqf32_avx2_(__m256i a, __m256i b) {
+  return _mm256_castps_si256(_mm256_cmp_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b), _CMP_EQ_OQ));
+}
+
+VEC_TARGET_AVX2 static __m256i vec_eqf64_avx2_(__m256i a, __m256i b) {
+  return _mm256_castpd_si256(_mm256_cmp_pd(_mm256_castsi256_pd(a), _mm256_castsi256_pd(b), _CMP_EQ_OQ));
+}
+
+VEC_TARGET_AVX2 static vec_size_t vec_hsum_avx2_(__m256i x) {
+  __m256i s = _mm256_sad_epu8(x, _mm256_setzero_si256());
+  __m128i t = _mm_add_epi64(_mm256_castsi256_si128(s), _mm256_extracti128_si256(s, 1));
+  return (vec_size_t)_mm_cvtsi128_si32(t) + (vec_size_t)_mm_cvtsi128_si32(_mm_srli_si128(t, 8));
+}
+
+VEC_TARGET_AVX2 static vec_size_t vec_scan_avx2_(int op, const uint8_t *data, vec_size_t *lo, vec_size_t *hi,
+                                                 vec_size_t memsz, int kind, const uint8_t *key, vec_size_t *count) {
+  VEC_SCAN_SWITCH_(__m256i, _mm256_loadu_si256, _mm256_movemask_epi8,
+                   _mm256_setzero_si256, _mm256_sub_epi8, vec_hsum_avx2_,
+                   vec_eq8_avx2_, vec_eq16_avx2_, vec_eq32_avx2_, vec_eq64_avx2_,
+                   vec_eqf32_avx2_, vec_eqf64_avx2_)
+}
+#endif // VEC_HAVE_AVX2
+
+
+static vec_size_t vec_scan_(int op, const uint8_t *data, vec_size_t length, vec_size_t memsz,
+                            const void *key, int kind) {
+  vec_size_t lo = 0, hi = length, count = 0, found = VEC_NOT_FOUND;
+  int level = vec_simd_level();
+  (void) level;
+
+#if defined(VEC_HAVE_SSE2) || defined(VEC_HAVE_AVX2)
+  // The key repeated across a full vector register for the block compares
+  uint8_t keys[32];
+  if (kind != VEC_KIND_BYTES && memsz <= 8 && level > VEC_SIMD_NONE) {
+    for (vec_size_t i = 0; i + memsz <= sizeof(keys); i += memsz) {
+      memcpy(keys + i, key, memsz);
+    }
+#if defined(VEC_HAVE_AVX2)
+    if (level >= VEC_SIMD_AVX2) {
+      found = vec_scan_avx2_(op, data, &lo, &hi, memsz, kind, keys, &count);
+    }
+#endif
+#if defined(VEC_HAVE_SSE2)
+    if (found == VEC_NOT_FOUND && level >= VEC_SIMD_SSE2) {
+      found = vec_scan_sse2_(op, data, &lo, &hi, memsz, kind, keys, &count);
+    }
+#endif
+    if (found != VEC_NOT_FOUND) {
+      return found;
+    }
+  }
+#endif
+  found = vec_scan_scalar_(op, data, lo, hi, memsz, kind, (const uint8_t *)key);
+  return op == VEC_SCAN_COUNT ? count + found : found;
+}
+
+
+vec_size_t vec_find_(uint8_t *const *data, const vec_size_t *options, const size_t *length, const vec_size_t *capacity, vec_size_t memsz, const void *key, int kind) {
+  (void) options;
+  (void) capacity;
+  return vec_scan_(VEC_SCAN_FIND, *data, *length, memsz, key, kind);
+}
+
+
+vec_size_t vec_rfind_(uint8_t *const *data, const vec_size_t *options, const size_t *length, const vec_size_t *capacity, vec_size_t memsz, const void *key, int kind) {
+  (void) options;
+  (void) capacity;
+  return vec_scan_(VEC_SCAN_RFIND, *data, *length, memsz, key, kind);
+}
+
+
+vec_size_t vec_count_(uint8_t *const *data, const vec_size_t *options, const size_t *length, const vec_size_t *capacity, vec_size_t memsz, const void *key, int kind) {
+  (void) options;
+  (void) capacity;
+  return vec_scan_(VEC_SCAN_COUNT, *data, *length, memsz, key, kind);
+}
+
+
+//
+// LSD radix sort, one 8 bit digit per pass. Each element maps to an unsigned key with
+// the same order: signed integers flip the sign bit, floating point values flip the sign
+// bit of positives and every bit of negatives. All digit histograms are counted in one
+// read of the input and passes where every element has the same digit are skipped.
+//
+#define VEC_RADIX_INSERTION_MAX 32
+
+#define VEC_RADIX_KEY_(UT, x) \
+  ((UT)((x) ^ (((UT)(0u - ((x) >> (sizeof(UT) * 8 - 1))) & fmask) | smask)))
+
+#define VEC_RADIX_SORT_(UT)                                                   \
+  {                                                                           \
+    UT *src = (UT *)*data, *dst = (UT *)scratch;                              \
+    const UT smask = kind == VEC_KIND_BITS ? 0 : (UT)((UT)1 << (sizeof(UT) * 8 - 1)); \
+    const UT fmask = kind == VEC_KIND_FLOAT ? (UT)~(UT)0 : 0;                 \
+    if (n <= VEC_RADIX_INSERTION_MAX) {                                       \
+      for (vec_size_t i = 1; i < n; ++i) {                                    \
+        UT x = src[i], k = VEC_RADIX_KEY_(UT, x);                             \
+        vec_size_t j = i;                                                     \
+        for (; j > 0 && VEC_RADIX_KEY_(UT, src[j - 1]) > k; --j) {            \
+          src[j] = src[j - 1];                                                \
+        }                                                                     \
+        src[j] = x;                                                           \
+      }                                                                       \
+      break;                                                                  \
+    }                                                                         \
+    memset(counts, 0, sizeof(UT) * sizeof(counts[0]));                        \
+    for (vec_size_t i = 0; i < n; ++i) {                                      \
+      UT k = VEC_RADIX_KEY_(UT, src[i]);                                      \
+      for (unsigned d = 0; d < sizeof(UT); ++d) {                             \
+        counts[d][(k >> (d * 8)) & 0xff]++;                                   \
+      }                                                                       \
+    }                                                                         \
+    for (unsigned d = 0; d < sizeof(UT); ++d) {                               \
+      vec_size_t *c = counts[d], sum = 0;                                     \
+      const unsigned shift = d * 8;                                           \
+      if (c[(VEC_RADIX_KEY_(UT, src[0]) >> shift) & 0xff] == n) {             \
+        continue;                                                             \
+      }                                                                       \
+      for (unsigned b = 0; b < 256; ++b) {                                    \
+        vec_size_t t = c[b];                                                  \
+        c[b] = sum;                                                           \
+        sum += t;                                                             \
+      }                                                                       \
+      for (vec_size_t i = 0; i < n; ++i) {                                    \
+        UT x = src[i];                                                        \
+        dst[c[(VEC_RADIX_KEY_(UT, x) >> shift) & 0xff]++] = x;                \
+      }                                                                       \
+      UT *t = src;                                                            \
+      src = dst;                                                              \
+      dst = t;                                                                \
+    }                                                                         \
+    if (src != (UT *)*data) {                                                 \
+      memcpy(*data, src, n * sizeof(UT));                                     \
+    }                                                                         \
+  }                                                                           \
+  break;
+
+
+int vec_sort_radix_(uint8_t *const *data, const vec_size_t *options, const size_t *length, const vec_size_t *capacity, vec_size_t memsz, int kind) {
+  vec_size_t counts[8][256];
+  vec_size_t n = *length;
+  uint8_t *scratch = NULL, *allocated = NULL;
+  (void) options;
+
+  if (kind == VEC_KIND_FLOAT ? (memsz != 4 && memsz != 8)
+                             : (memsz != 1 && memsz != 2 && memsz != 4 && memsz != 8)) {
+    return VEC_ERR;
+  }
+  if (n < 2) {
+    return VEC_OK;
+  }
+
+  // The spare capacity past the length is used as the scratch buffer when it's large enough
+  if (n > VEC_RADIX_INSERTION_MAX) {
+    if (*capacity - n >= n) {
+      scratch = *data + n * memsz;
+    } else {
+      scratch = allocated = VEC_MALLOC(n * memsz);
+      if (scratch == NULL) {
+        return VEC_ERR_NO_MEMORY;
+      }
+    }
+  }
+
+  switch (memsz) {
+  case 1: VEC_RADIX_SORT_(uint8_t)
+  case 2: VEC_RADIX_SORT_(uint16_t)
+  case 4: VEC_RADIX_SORT_(uint32_t)
+  case 8: VEC_RADIX_SORT_(uint64_t)
+  default: break;
+  }
+
+  if (allocated != NULL) {
+    VEC_FREE(allocated);
+  }
+  return VEC_OK;
+}
+
+
+// Next node of the implicit tree of `n` nodes in in-order, 0 after the last node
+static vec_size_t vec_eytzinger_next_(vec_size_t k, vec_size_t n) {
+  if (2 * k + 1 <= n) {
+    k = 2 * k + 1;
+    while (2 * k <= n) {
+      k *= 2;
+    }
+  } else {
+    while (k & 1) {
+      k >>= 1;
+    }
+    k >>= 1;
+  }
+  return k;
+}
+
+
+// The in-order walk visits the nodes in sorted order, sorted element i is node k
+#define VEC_EYTZINGER_COPY_(memsz)                                              \
+  for (i = 0; i < n; i++, k = vec_eytzinger_next_(k, n)) {                      \
+    if (to_sorted) {                                                            \
+      memcpy(dst + i * (memsz), s + (k - 1) * (memsz), (memsz));                \
+    } else {                                                                    \
+      memcpy(dst + (k - 1) * (memsz), s + i * (memsz), (memsz));                \
+    }                                                                           \
+  }                                                                             \
+  break;
+
+int vec_eytzinger_(uint8_t **data, vec_size_t *options, const size_t *length, vec_size_t *capacity, vec_size_t memsz, const void *src, vec_size_t n, int to_sorted) {
+  const uint8_t *s = src;
+  uint8_t *dst;
+  vec_size_t i, k = 1;
+
+  if (vec_reserve_(data, options, length, capacity, memsz, n) != VEC_OK) {
+    return VEC_ERR;
+  }
+  dst = *data;
+  while (2 * k <= n) {
+    k *= 2;
+  }
+
+  switch (memsz) {
+  case 1: VEC_EYTZINGER_COPY_(1)
+  case 2: VEC_EYTZINGER_COPY_(2)
+  case 4: VEC_EYTZINGER_COPY_(4)
+  case 8: VEC_EYTZINGER_COPY_(8)
+  case 16: VEC_EYTZINGER_COPY_(16)
+  default: VEC_EYTZINGER_COPY_(memsz)
+  }
+  return VEC_OK;
+}
+
+
+// Searches advanced together by vec_bsearch_batch_, enough probes in flight to cover the
+// memory latency of each one
+#define VEC_BSEARCH_GROUP 16
+
+// Below this many bytes of elements the probes hit the cache and the lockstep bookkeeping
+// costs more than it hides, the keys are then searched one at a time
+#define VEC_BSEARCH_LOCKSTEP_BYTES ((vec_size_t)1 << 20)
+
+// Sorted keys are merged when there is at least one key per this many elements, sparser
+// keys gallop across distances that cost more than the lockstep search
+#define VEC_BSEARCH_MERGE_GAP 256
+
+typedef int (*vec_cmp_fn_)(const void *, const void *);
+
+// Lower bound of `key` in [lo, hi)
+static vec_size_t vec_bisect_(const uint8_t *data, vec_size_t memsz, vec_size_t lo, vec_size_t hi,
+                              const void *key, vec_cmp_fn_ cmp) {
+  while (lo < hi) {
+    vec_size_t mid = lo + (hi - lo) / 2;
+    if (cmp(data + mid * memsz, key) < 0) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+// Lower bound of `key` in [lo, n) by doubling steps from `lo` then bisecting, the cost
+// grows with the distance from `lo` rather than with `n`
+static vec_size_t vec_gallop_(const uint8_t *data, vec_size_t memsz, vec_size_t lo, vec_size_t n,
+                              const void *key, vec_cmp_fn_ cmp) {
+  vec_size_t hi = lo, step = 1;
+  while (hi < n && cmp(data + hi * memsz, key) < 0) {
+    lo = hi + 1;
+    hi += step;
+    step *= 2;
+  }
+  return vec_bisect_(data, memsz, lo, hi < n ? hi : n, key, cmp);
+}
+
+
+vec_size_t vec_bsearch_batch_(uint8_t *const *data, const vec_size_t *options, const size_t *length, const vec_size_t *capacity, vec_size_t memsz,
+                              const void *keys, vec_size_t nkeys, vec_size_t *out, vec_cmp_fn_ cmp) {
+  const uint8_t *d = *data, *k = keys;
+  vec_size_t n = *length, i, found = 0;
+  int sorted = nkeys * VEC_BSEARCH_MERGE_GAP >= n;
+  (void) options;
+  (void) capacity;
+
+  for (i = 1; i < nkeys && sorted; i++) {
+    sorted = cmp(k + (i - 1) * memsz, k + i * memsz) <= 0;
+  }
+
+  if (sorted) {
+    // Sorted keys merge against the vector, each search starts where the previous ended
+    vec_size_t lo = 0;
+    for (i = 0; i < nkeys; i++) {
+      lo = vec_gallop_(d, memsz, lo, n, k + i * memsz, cmp);
+      out[i] = lo;
+    }
+  } else if (n * memsz <= VEC_BSEARCH_LOCKSTEP_BYTES) {
+    for (i = 0; i < nkeys; i++) {
+      out[i] = vec_bisect_(d, memsz, 0, n, k + i * memsz, cmp);
+    }
+  } else {
+    // Every search of a group halves the same length in lockstep, the next probe of each
+    // one is prefetched and is loaded by the time the group comes back around to it
+    for (i = 0; i < nkeys; i += VEC_BSEARCH_GROUP) {
+      vec_size_t base[VEC_BSEARCH_GROUP];
+      vec_size_t g, m = nkeys - i < VEC_BSEARCH_GROUP ? nkeys - i : VEC_BSEARCH_GROUP;
+      vec_size_t len = n;
+      const uint8_t *gk = k + i * memsz;
+      for (g = 0; g < m; g++) {
+        base[g] = 0;
+      }
+      while (len > 1) {
+        vec_size_t half = len >> 1, next = (len - half) >> 1;
+        for (g = 0; g < m; g++) {
+          vec_size_t take = cmp(d + (base[g] + half) * memsz, gk + g * memsz) < 0;
+          base[g] += half & ((vec_size_t)0 - take);
+          VEC_PREFETCH(d + (base[g] + next) * memsz);
+        }
+        len -= half;
+      }
+      for (g = 0; g < m; g++) {
+        out[i + g] = base[g] + (len == 1 && cmp(d + base[g] * memsz, gk + g * memsz) < 0);
+      }
+    }
+  }
+
+  for (i = 0; i < nkeys; i++) {
+    if (out[i] < n && cmp(d + out[i] * memsz, k + i * memsz) == 0) {
+      found++;
+    } else {
+      out[i] = VEC_NOT_FOUND;
+    }
+  }
+  return found;
+}
@@ -54,7 +54,12 @@ extern "C" {
 //
 #define VEC_OWNS_MEMORY     0x10
 #define VEC_ALLOW_REALLOC   0x20
+#define VEC_ARENA           0x40
+#define VEC_ALLOCATOR       0x80
 #define VEC_OOM             0x01
+#define VEC_SBO             0x02
+#define VEC_MAPPED_DATA     0x04
+#define VEC_MAPPED          0x08
 
 //
 // Combinations of options for vector initialization
@@ -63,10 +68,57 @@ extern "C" {
 #define VEC_FIXED_REALLOC (VEC_ALLOW_REALLOC)
 #define VEC_FIXED (0)
 
+//
+// SIMD levels for the vector kernels (see vec_simd_set_level)
+//
+#define VEC_SIMD_NONE 0
+#define VEC_SIMD_SSE2 1
+#define VEC_SIMD_AVX2 2
+
+//
+// Element kinds for the search and sort kernels (see VEC_ELEM_KIND)
+//
+#define VEC_KIND_BITS 0
+#define VEC_KIND_FLOAT 1
+#define VEC_KIND_BYTES 2
+#define VEC_KIND_SIGNED 3
+
+
+// A span of `count` elements beginning at `start` (see vec_splice_ranges)
+typedef struct {
+  vec_size_t start;
+  vec_size_t count;
+} vec_range_t;
+
+
+// Memory taken from VEC_MALLOC by an arena, blocks are bumped from the bytes after it
+typedef struct vec_arena_chunk_t {
+  struct vec_arena_chunk_t *next;
+  size_t size;
+} vec_arena_chunk_t;
+
+// Bump allocator for short lived vectors (see vec_init_with_arena)
+typedef struct {
+  vec_arena_chunk_t *chunks;
+  uint8_t *top, *end;
+  size_t chunk_size;
+} vec_arena_t;
+
+// Allocator context of a vector (see vec_init_with_allocator). The callbacks receive
+// `user` and the size of the block being resized or freed. A NULL realloc is replaced by
+// alloc, copy and free.
+typedef struct {
+  void *(*alloc)(void *user, size_t bytes);
+  void *(*realloc)(void *user, void *ptr, size_t old_bytes, size_t new_bytes);
+  void (*free)(void *user, void *ptr, size_t bytes);
+  void *user;
+} vec_allocator_t;
+
 
 // Optionally add assert into array access, the statement remains unchanged but
 // but will break before access the array out of bounds.
 #if defined(VEC_USE_CHECKED_ACCESS)
+#include <assert.h>
 #define VEC_CHECK(v, i) assert(i < (v)->length)
 #else
 #define VEC_CHECK(v, i) ((void)1)
@@ -89,6 +141,18 @@ extern "C" {
    T *data; size_t options, length, capacity;
 
 
+// Declare a new vector type that can carry an allocator context, vectors declared
+// with vec_define_fields don't pay for the extra field
+#define vec_define_fields_alloc(T) \
+   vec_define_fields(T) const vec_allocator_t *allocator;
+
+
+// Declare a new vector type with room for `N` elements inside the struct, the vector
+// moves to the heap when it grows past them (see vec_init_sbo)
+#define vec_define_fields_sbo(T, N) \
+   vec_define_fields(T) T sbo[N];
+
+
 // Initialize vector fields
 #define vec_init(v) \
   (void) ((v)->data = NULL, (v)->options = VEC_DYNAMIC, (v)->length = 0, (v)->capacity = 0)
@@ -104,9 +168,48 @@ extern "C" {
   (void) ((v)->data = (ptr), (v)->options = VEC_FIXED_REALLOC, (v)->length = 0, (v)->capacity = (capacity_))
 
 
+// Initialize a vector declared with vec_define_fields_sbo to use its inline elements, the
+// first growth past them copies the elements to the heap. The vector points into itself,
+// it must not be copied or moved by value while the elements are inline.
+#define vec_init_sbo(v)                                                   \
+  (void) ((v)->data = (v)->sbo, (v)->options = VEC_FIXED_REALLOC | VEC_SBO, \
+          (v)->length = 0, (v)->capacity = vec_countof((v)->sbo))
+
+
+// Initialize a vector whose storage above vec_map_threshold bytes is a page mapping. Large
+// vectors then grow without copying the elements, on Linux mremap moves the pages.
+#define vec_init_mapped(v) \
+  (void) ((v)->data = NULL, (v)->options = VEC_DYNAMIC | VEC_MAPPED, (v)->length = 0, (v)->capacity = 0)
+
+
+// Initialize with storage bumped from `arena`. Growing the last block of the arena extends
+// it in place and the memory is released all at once by vec_arena_reset. Returns VEC_OK,
+// or VEC_ERR_NO_MEMORY and a vector that can't grow.
+#define vec_init_with_arena(v, arena) \
+  vec_init_with_arena_(vec_unpack_(v), arena)
+
+
+// Initialize a vector declared with vec_define_fields_alloc to take its memory from
+// `allocator` instead of VEC_MALLOC, the allocator must outlive the vector. Returns VEC_OK,
+// or VEC_ERR and a vector that can't grow when `allocator` is NULL.
+#define vec_init_with_allocator(v, allocator_) \
+  vec_init_with_allocator_(vec_unpack_(v), &(v)->allocator, allocator_)
+
+
 // Free vectory memory
-#define vec_deinit(v) \
-  ( (((v)->options & VEC_OWNS_MEMORY) ? VEC_FREE((v)->data) : (void)0), vec_init(v) )
+#define vec_deinit(v)                                                        \
+  ( (((v)->options & VEC_MAPPED_DATA) ? vec_unmap_(vec_unpack_(v))           \
+     : ((v)->options & VEC_OWNS_MEMORY) ? VEC_FREE((v)->data)                \
+     : ((v)->options & VEC_ARENA) ? vec_arena_free((v)->data)                \
+     : ((v)->options & VEC_ALLOCATOR) ? vec_allocator_free_(vec_unpack_(v)) \
+     : (void)0),                                                             \
+    vec_init(v) )
+
+
+// Free the heap memory of a vector declared with vec_define_fields_sbo and go back to the
+// inline elements
+#define vec_deinit_sbo(v) \
+  (vec_deinit(v), vec_init_sbo(v))
 
 
 // Length of vector in elements
@@ -125,14 +228,21 @@ extern "C" {
 // Availability of vector in elements
 #define vec_available(v) ((v)->capacity - (v)->length)
 
+// True when there is room for one more element or the vector could be grown,
+// the capacity check is inline and only growth calls out to `vec_expand_`
+#define vec_ensure_one_(v)                          \
+  ( VEC_LIKELY((v)->length < (v)->capacity)         \
+    || VEC_OK == vec_expand_(vec_unpack_(v)) )
+
+
 // Push an element, returns VEC_OK or VEC_ERR
 #define vec_push(v, val)                  \
-  ( vec_expand_(vec_unpack_(v))           \
-     ? VEC_ERR                            \
-     : (                                  \
+  ( vec_ensure_one_(v)                    \
+     ? (                                  \
         (v)->data[(v)->length++] = (val), \
         VEC_OK                            \
        )                                  \
+     : VEC_ERR                            \
   )
 
 
@@ -155,15 +265,39 @@ extern "C" {
   )
 
 
+// Remove the elements at the `count` ascending indices in `idx` in a single sweep,
+// each surviving run of elements is moved once. Duplicate indices and indices past
+// the end are ignored.
+#define vec_splice_indices(v, idx, count) \
+  ( (v)->length -= vec_splice_indices_(vec_unpack_(v), idx, count) )
+
+
+// Remove the `count` ascending `vec_range_t` spans in `ranges` in a single sweep,
+// overlapping spans are merged and spans are clamped to the length
+#define vec_splice_ranges(v, ranges, count) \
+  ( (v)->length -= vec_splice_ranges_(vec_unpack_(v), ranges, count) )
+
+
+// Move the elements from `idx` up by one in a vector with room for one more, returns `idx`
+VEC_INLINE vec_size_t vec_insert_gap_(uint8_t *const *data, const vec_size_t *options, const size_t *length,
+                                      const vec_size_t *capacity, vec_size_t memsz, vec_size_t idx) {
+  (void) options;
+  (void) capacity;
+  memmove(*data + (idx + 1) * memsz, *data + idx * memsz, (*length - idx) * memsz);
+  return idx;
+}
+
+
 // Insert `val` at specified `idx`, adjust contents up
-#define vec_insert(v, idx, val)      \
-  ( vec_insert_(vec_unpack_(v), idx) \
-    ? VEC_ERR                        \
-    : (                              \
-       (v)->data[idx] = (val),       \
-       (v)->length++,                \
-       VEC_OK                        \
-      )                              \
+#define vec_insert(v, idx, val)                              \
+  ( vec_ensure_one_(v)                                       \
+    ? (                                                      \
+       (v)->data[vec_insert_gap_(vec_unpack_(v), idx)]       \
+         = (val),                                            \
+       (v)->length++,                                        \
+       VEC_OK                                                \
+      )                                                      \
+    : VEC_ERR                                                \
     )
 
 
@@ -172,6 +306,22 @@ extern "C" {
   qsort((v)->data, (v)->length, sizeof(*(v)->data), fn)
 
 
+#if defined(VEC_ELEM_KIND)
+// Sort integer or floating point elements with an LSD radix sort, returns VEC_OK or
+// VEC_ERR_NO_MEMORY when the scratch buffer can't be allocated. Floating point values
+// order as -NaN < -inf < ... < -0.0 < 0.0 < ... < inf < NaN.
+#define vec_sort_radix(v) \
+  vec_sort_radix_(vec_unpack_(v), vec_radix_kind_((v)->data[0]))
+
+
+// Radix key kind of an element: unsigned integers sort by their bits, signed integers
+// flip the sign bit and floating point values also invert the negative magnitudes
+#define vec_radix_kind_(x)                                                   \
+  ( VEC_ELEM_KIND(x) == VEC_KIND_FLOAT ? VEC_KIND_FLOAT                      \
+    : (VEC_TYPEOF(x))-1 < (VEC_TYPEOF(x))1 ? VEC_KIND_SIGNED : VEC_KIND_BITS )
+#endif // VEC_ELEM_KIND
+
+
 // `bsearch()` the contents using `key` and `fn` result in `idx`
 #define vec_bsearch(v, key, idx, fn)                                    \
   do {                                                                  \
@@ -183,6 +333,167 @@ extern "C" {
   } while (0)
 
 
+// Search the sorted vector for each of the `nkeys` keys in the array `keys`, which hold the
+// element type. `out_idx[i]` is set to the first index of `keys[i]` or VEC_NOT_FOUND and
+// the number of keys found is returned. Groups of unsorted keys are searched in lockstep
+// so their memory accesses overlap, sorted keys are merged against the vector.
+#define vec_bsearch_batch(v, keys, nkeys, out_idx, fn) \
+  vec_bsearch_batch_(vec_unpack_(v), keys, nkeys, out_idx, fn)
+
+
+
+// Branchless binary search of the sorted range [lo, length) for the first element where
+// `before(p)` is false, `before` must hold for a prefix of the range. The midpoints of
+// both possible next steps are prefetched while the current compare resolves.
+#define vec_search_(v, before, lo, idx)                                       \
+  do {                                                                        \
+    vec_size_t base__ = (lo), n__ = (v)->length - base__;                     \
+    while (n__ > 1) {                                                         \
+      vec_size_t half__ = n__ >> 1, next__ = (n__ - half__) >> 1;             \
+      VEC_PREFETCH(&(v)->data[base__ + next__]);                              \
+      VEC_PREFETCH(&(v)->data[base__ + half__ + next__]);                     \
+      vec_size_t take__ = (vec_size_t)before(&(v)->data[base__ + half__]);    \
+      base__ += half__ & ((vec_size_t)0 - take__);                            \
+      n__ -= half__;                                                          \
+    }                                                                         \
+    (idx) = base__ + (n__ == 1 && before(&(v)->data[base__]));                \
+  } while (0)
+
+#define vec_before_lower_(p) (*(p) < key__)
+#define vec_before_upper_(p) (!(key__ < *(p)))
+#define vec_before_lower_cmp_(p) (fn__((p), key__) < 0)
+#define vec_before_upper_cmp_(p) (fn__(key__, (p)) >= 0)
+
+
+// Index of the first element not less than `key` in the sorted vector, this is the
+// insertion index when `key` is not present
+#define vec_lower_bound(v, key, idx)                    \
+  do {                                                  \
+    VEC_TYPEOF((v)->data[0]) const key__ = (key);       \
+    vec_search_(v, vec_before_lower_, 0, idx);          \
+  } while (0)
+
+
+// Index of the first element greater than `key` in the sorted vector
+#define vec_upper_bound(v, key, idx)                    \
+  do {                                                  \
+    VEC_TYPEOF((v)->data[0]) const key__ = (key);       \
+    vec_search_(v, vec_before_upper_, 0, idx);          \
+  } while (0)
+
+
+// The range [first, last) of elements equal to `key` in the sorted vector
+#define vec_equal_range(v, key, first, last)            \
+  do {                                                  \
+    VEC_TYPEOF((v)->data[0]) const key__ = (key);       \
+    vec_search_(v, vec_before_lower_, 0, first);        \
+    vec_search_(v, vec_before_upper_, first, last);     \
+  } while (0)
+
+
+// As vec_lower_bound with a pointer to the key and a qsort-compatible compare `fn`
+#define vec_lower_bound_cmp(v, key, idx, fn)                      \
+  do {                                                            \
+    const void *key__ = (key);                                    \
+    int (*fn__)(const void *, const void *) = (fn);               \
+    vec_search_(v, vec_before_lower_cmp_, 0, idx);                \
+  } while (0)
+
+
+// As vec_upper_bound with a pointer to the key and a qsort-compatible compare `fn`
+#define vec_upper_bound_cmp(v, key, idx, fn)                      \
+  do {                                                            \
+    const void *key__ = (key);                                    \
+    int (*fn__)(const void *, const void *) = (fn);               \
+    vec_search_(v, vec_before_upper_cmp_, 0, idx);                \
+  } while (0)
+
+
+// As vec_equal_range with a pointer to the key and a qsort-compatible compare `fn`
+#define vec_equal_range_cmp(v, key, first, last, fn)              \
+  do {                                                            \
+    const void *key__ = (key);                                    \
+    int (*fn__)(const void *, const void *) = (fn);               \
+    vec_search_(v, vec_before_lower_cmp_, 0, first);              \
+    vec_search_(v, vec_before_upper_cmp_, first, last);           \
+  } while (0)
+
+
+// Copy the sorted `src` into `dst` in Eytzinger (breadth first) order: node k of the implicit
+// binary search tree is stored at index k - 1 and its children at 2k - 1 and 2k, so the
+// first levels of every search share a few cache lines. `dst` must be a different vector of
+// the same element type. Returns VEC_OK or VEC_ERR when `dst` can't hold the elements.
+#define vec_eytzinger_build(dst, src)                                         \
+  ( vec_eytzinger_(vec_unpack_(dst), (src)->data, (src)->length, 0)           \
+    ? VEC_ERR                                                                 \
+    : ((dst)->length = (src)->length, VEC_OK) )
+
+
+// Copy the Eytzinger ordered `src` back into `dst` in sorted order, as vec_eytzinger_build
+#define vec_eytzinger_sorted(dst, src)                                        \
+  ( vec_eytzinger_(vec_unpack_(dst), (src)->data, (src)->length, 1)           \
+    ? VEC_ERR                                                                 \
+    : ((dst)->length = (src)->length, VEC_OK) )
+
+
+// Nodes this many times deeper than the current one are consecutive and fill at most a
+// 64 byte cache line, prefetching them covers the next levels of the search
+#define vec_eytzinger_ahead_(v)                                               \
+  ( sizeof(*(v)->data) <= 1 ? 64 : sizeof(*(v)->data) <= 2 ? 32               \
+    : sizeof(*(v)->data) <= 4 ? 16 : sizeof(*(v)->data) <= 8 ? 8              \
+    : sizeof(*(v)->data) <= 16 ? 4 : 2 )
+
+
+// Count the trailing zero bits of a nonzero `x`
+VEC_INLINE vec_size_t vec_ctz_(unsigned long long x) {
+#if defined(__GNUC__) || defined(__clang__)
+  return (vec_size_t)__builtin_ctzll(x);
+#else
+  vec_size_t n = 0;
+  while (!(x & 1u)) x >>= 1, ++n;
+  return n;
+#endif
+}
+
+
+// Drop the trailing right turns and the last left turn from the search path `k`
+VEC_INLINE vec_size_t vec_eytzinger_up_(vec_size_t k) {
+  return k >> (vec_ctz_(~(unsigned long long)k) + 1);
+}
+
+
+// Descend the Eytzinger layout to the first element where `before(p)` is false. The path
+// taken is the bits of k__, the answer is the last node where the search went left.
+#define vec_eytzinger_search_(v, before, idx)                                 \
+  do {                                                                        \
+    vec_size_t k__ = 1, n__ = (v)->length;                                    \
+    while (k__ <= n__) {                                                      \
+      VEC_PREFETCH(&(v)->data[k__ * vec_eytzinger_ahead_(v) - 1]);            \
+      k__ = 2 * k__ + (vec_size_t)before(&(v)->data[k__ - 1]);                \
+    }                                                                         \
+    k__ = vec_eytzinger_up_(k__);                                             \
+    (idx) = k__ ? k__ - 1 : VEC_NOT_FOUND;                                    \
+  } while (0)
+
+
+// Index in the Eytzinger layout `v` of the first element not less than `key`, VEC_NOT_FOUND
+// when every element is less
+#define vec_eytzinger_search(v, key, idx)               \
+  do {                                                  \
+    VEC_TYPEOF((v)->data[0]) const key__ = (key);       \
+    vec_eytzinger_search_(v, vec_before_lower_, idx);   \
+  } while (0)
+
+
+// As vec_eytzinger_search with a pointer to the key and a qsort-compatible compare `fn`
+#define vec_eytzinger_search_cmp(v, key, idx, fn)                 \
+  do {                                                            \
+    const void *key__ = (key);                                    \
+    int (*fn__)(const void *, const void *) = (fn);               \
+    vec_eytzinger_search_(v, vec_before_lower_cmp_, idx);         \
+  } while (0)
+
+
 // Swap the elements at `idx1` and `idx2`
 #define vec_swap(v, idx1, idx2)\
   vec_swap_(vec_unpack_(v), idx1, idx2)
@@ -223,20 +534,60 @@ extern "C" {
   ((v)->data[(VEC_CHECK(v, (v)->length - 1), (v)->length - 1)])
 
 
-// Swap the data of src into dst, releasing dst before the swap
-#define vec_swap_data(dst, src)        \
-  do {                                 \
-    if (((dst)->data) == ((src)->data))    \
-      break;                           \
-    vec_deinit(dst);                   \
-    (dst)->data     = (src)->data;     \
-    (dst)->options  = (src)->options;  \
-    (dst)->length   = (src)->length;   \
-    (dst)->capacity = (src)->capacity; \
-    vec_init(src);                     \
+// Swap the data of src into dst, releasing dst before the swap. Inline elements of src
+// (see vec_init_sbo) and memory of an allocator context (see vec_init_with_allocator)
+// can't be handed over, they are copied and src is cleared.
+#define vec_swap_data(dst, src)                                 \
+  do {                                                          \
+    if (((dst)->data) == ((src)->data))                         \
+      break;                                                    \
+    vec_deinit(dst);                                            \
+    if ((src)->options & (VEC_SBO | VEC_ALLOCATOR)) {           \
+      vec_swap_copy_(dst, src);                                 \
+      break;                                                    \
+    }                                                           \
+    vec_swap_hand_over_(dst, src);                              \
   } while(0);
 
 
+// Swap the data of src into dst for vectors declared with vec_define_fields_alloc,
+// the allocator context moves with the data
+#define vec_swap_data_alloc(dst, src)                           \
+  do {                                                          \
+    if (((dst)->data) == ((src)->data))                         \
+      break;                                                    \
+    vec_deinit(dst);                                            \
+    if ((src)->options & VEC_SBO) {                             \
+      vec_swap_copy_(dst, src);                                 \
+      break;                                                    \
+    }                                                           \
+    (dst)->allocator = (src)->allocator;                        \
+    vec_swap_hand_over_(dst, src);                              \
+  } while(0)
+
+
+// Copy the elements of src into the released dst and clear src, src keeps its elements
+// when dst can't grow
+#define vec_swap_copy_(dst, src)                                \
+  do {                                                          \
+    if ((src)->length > 0)                                      \
+      vec_pusharr(dst, (src)->data, (src)->length);             \
+    if ((dst)->length == (src)->length)                         \
+      vec_clear(src);                                           \
+  } while(0)
+
+
+// Hand the memory of src over to the released dst and empty src
+#define vec_swap_hand_over_(dst, src)                           \
+  do {                                                          \
+    (dst)->data     = (src)->data;                              \
+    (dst)->options  = (src)->options;                           \
+    (dst)->length   = (src)->length;                            \
+    (dst)->capacity = (src)->capacity;                          \
+    vec_init(src);                                              \
+  } while(0)
+
+
 // Reserve space for `n` elements
 #define vec_reserve(v, n)          \
   (vec_reserve_(vec_unpack_(v), n) \
@@ -251,22 +602,91 @@ extern "C" {
     ? VEC_ERR : VEC_OK)
 
 
-// Reserve and copy the values from a source array
-#define vec_pusharr(v, arr, count)                                       \
+// Copy `count` values from `arr` to `dst`, a single memcpy when the element types match
+// otherwise each value is converted by assignment
+#define vec_copyarr_(dst, arr, count)                                    \
   do {                                                                   \
     vec_size_t i__, n__ = (count);                                       \
-    if (vec_reserve_(vec_unpack_(v), (v)->length + n__) != 0) break;     \
-    for (i__ = 0; i__ < n__; i__++) {                                    \
-      (v)->data[(v)->length++] = (arr)[i__];                             \
+    if (VEC_SAME_TYPE(*(dst), *(arr)) && n__ > 0) {                      \
+      memcpy((dst), (arr), n__ * sizeof(*(dst)));                        \
+    } else {                                                             \
+      for (i__ = 0; i__ < n__; i__++) {                                  \
+        (dst)[i__] = (arr)[i__];                                         \
+      }                                                                  \
     }                                                                    \
   } while (0)
 
 
+// Reserve and copy the values from a source array
+#define vec_pusharr(v, arr, count)                                       \
+  do {                                                                   \
+    vec_size_t c__ = (count);                                            \
+    if (vec_expand_n_(vec_unpack_(v), c__) != 0) break;                  \
+    vec_copyarr_((v)->data + (v)->length, arr, c__);                     \
+    (v)->length += c__;                                                  \
+  } while (0)
+
+
+// Insert the values from a source array at `idx`, adjust contents up. The gap is opened
+// with a single move, `arr` must not point into `v`.
+#define vec_insertarr(v, idx, arr, count)                                \
+  do {                                                                   \
+    vec_size_t c__ = (count), at__ = (idx);                              \
+    if (vec_insertarr_(vec_unpack_(v), at__, c__) != 0) break;           \
+    vec_copyarr_((v)->data + at__, arr, c__);                            \
+    (v)->length += c__;                                                  \
+  } while (0)
+
+
 // Extend vector `v` with the elements from `v2`
 #define vec_extend(v, v2)\
   vec_pusharr((v), (v2)->data, (v2)->length)
 
 
+#if defined(VEC_ELEM_KIND)
+// Declare `key` holding `val` converted to the element type of `v`. `ok` is false when the
+// conversion changed the value, `==` then matches no element so the searches find nothing.
+#define vec_search_key_(v, val, key, ok)                                      \
+  VEC_TYPEOF(0 ? (val) : (val)) raw__, back__;                                \
+  VEC_TYPEOF((v)->data[0]) key;                                               \
+  int ok;                                                                     \
+  memset(&raw__, 0, sizeof(raw__));                                           \
+  memset(&back__, 0, sizeof(back__));                                         \
+  raw__ = (val);                                                              \
+  key = raw__;                                                                \
+  back__ = key;                                                               \
+  ok = __builtin_types_compatible_p(VEC_TYPEOF(raw__), VEC_TYPEOF(key))       \
+       || 0 == memcmp(&raw__, &back__, sizeof(raw__))
+
+
+// Find `val` in vector, populates `idx` with result, VEC_NOT_FOUND when absent.
+// Primitive elements are scanned with the SIMD kernels, other elements are compared
+// byte for byte, padding included.
+#define vec_find(v, val, idx)                                                 \
+  do {                                                                        \
+    vec_search_key_(v, val, key__, ok__);                                     \
+    (idx) = ok__ ? vec_find_(vec_unpack_(v), &key__, VEC_ELEM_KIND(key__))    \
+                 : VEC_NOT_FOUND;                                             \
+  } while (0)
+
+
+// Find the last `val` in vector, populates `idx` with result
+#define vec_rfind(v, val, idx)                                                \
+  do {                                                                        \
+    vec_search_key_(v, val, key__, ok__);                                     \
+    (idx) = ok__ ? vec_rfind_(vec_unpack_(v), &key__, VEC_ELEM_KIND(key__))   \
+                 : VEC_NOT_FOUND;                                             \
+  } while (0)
+
+
+// Count the elements equal to `val`, populates `n` with result
+#define vec_count(v, val, n)                                                  \
+  do {                                                                        \
+    vec_search_key_(v, val, key__, ok__);                                     \
+    (n) = ok__ ? vec_count_(vec_unpack_(v), &key__, VEC_ELEM_KIND(key__))     \
+               : 0;                                                           \
+  } while (0)
+#else
 // Find `val` in vector, populates `idx` with result
 #define vec_find(v, val, idx)\
   do {                                                \
@@ -287,6 +707,17 @@ extern "C" {
   } while (0)
 
 
+// Count the elements equal to `val`, populates `n` with result
+#define vec_count(v, val, n)\
+  do {                                                \
+    (n) = 0;                                          \
+    for (vec_size_t i__ = 0; i__ < (v)->length; i__++) { \
+      (n) += (v)->data[i__] == (val);                 \
+    }                                                 \
+  } while (0)
+#endif // VEC_ELEM_KIND
+
+
 // Remove an element from the vector by value
 #define vec_remove(v, val)                    \
   do {                                        \
@@ -299,13 +730,8 @@ extern "C" {
 
 
 // Reverse the contents of a vector
-#define vec_reverse(v)                             \
-  do {                                             \
-    vec_size_t i__ = (v)->length >> 1;                 \
-    while (i__--) {                                \
-      vec_swap((v), i__, (v)->length - (i__ + 1)); \
-    }                                              \
-  } while (0)
+#define vec_reverse(v) \
+  vec_reverse_(vec_unpack_(v))
 
 
 // Simply execute a function on each valid element of v
@@ -452,7 +878,88 @@ extern "C" {
   } while(0);
 
 
-int VEC_API(vec_expand_)(uint8_t **data, vec_size_t *options, const size_t *length, vec_size_t *capacity, vec_size_t memsz);
+// Elements up to this size are compacted without branching on the predicate: every
+// element is copied and the write position only advances for the ones that are kept
+#define VEC_BRANCHLESS_MAX 16
+
+#define vec_arg_val_(p) (*(p))
+#define vec_arg_ptr_(p) (p)
+
+// Single pass stable compaction of src into dst keeping elements where `keep` is
+// `(pred)(...) == want`, dst may be the same vector as src
+#define vec_compact_if_(dst, src, want, pred, arg, ...)                     \
+  do {                                                                      \
+    VEC_TYPEOF((src)->data[0]) *s__ = (src)->data,                          \
+                               *e__ = (src)->data + (src)->length,          \
+                               *d__ = (dst)->data;                          \
+    if (sizeof(*s__) <= VEC_BRANCHLESS_MAX) {                               \
+      for (; s__ < e__; ++s__) {                                            \
+        *d__ = *s__;                                                        \
+        d__ += (!(pred)(arg(s__) , ## __VA_ARGS__ )) == !(want);            \
+      }                                                                     \
+    } else {                                                                \
+      for (; s__ < e__; ++s__) {                                            \
+        if ((!(pred)(arg(s__) , ## __VA_ARGS__ )) == !(want)) {             \
+          if (d__ != s__) *d__ = *s__;                                      \
+          ++d__;                                                            \
+        }                                                                   \
+      }                                                                     \
+    }                                                                       \
+    (dst)->length = d__ - (dst)->data;                                      \
+  } while (0)
+
+
+// Remove every element where `pred(v[i], ...)` is true in a single pass, preserving order
+#define vec_remove_if(v, pred, ...) \
+  vec_compact_if_(v, v, 0, pred, vec_arg_val_ , ## __VA_ARGS__ )
+
+
+// Remove every element where `pred(&v[i], ...)` is true in a single pass, preserving order
+#define vec_remove_if_ptr(v, pred, ...) \
+  vec_compact_if_(v, v, 0, pred, vec_arg_ptr_ , ## __VA_ARGS__ )
+
+
+// Set dst to the elements of src where `pred(src[i], ...)` is true, preserving order
+#define vec_filter(dst, src, pred, ...)                        \
+  do {                                                         \
+    if (VEC_OK != vec_reserve((dst), vec_length(src))) {       \
+      break;                                                   \
+    }                                                          \
+    vec_compact_if_(dst, src, 1, pred, vec_arg_val_ , ## __VA_ARGS__ ); \
+  } while (0)
+
+
+// Set dst to the elements of src where `pred(&src[i], ...)` is true, preserving order
+#define vec_filter_ptr(dst, src, pred, ...)                    \
+  do {                                                         \
+    if (VEC_OK != vec_reserve((dst), vec_length(src))) {       \
+      break;                                                   \
+    }                                                          \
+    vec_compact_if_(dst, src, 1, pred, vec_arg_ptr_ , ## __VA_ARGS__ ); \
+  } while (0)
+
+
+// Remove every element where `pred(v[i], ...)` is true, each removed element is replaced
+// by the last element as in `vec_swapsplice`. Order is not preserved but only one element
+// is moved per removal.
+#define vec_remove_if_unstable(v, pred, ...)                                \
+  do {                                                                      \
+    VEC_TYPEOF((v)->data[0]) *s__ = (v)->data,                              \
+                             *e__ = (v)->data + (v)->length;                \
+    while (s__ < e__) {                                                     \
+      if ((pred)(*s__ , ## __VA_ARGS__ )) {                                 \
+        *s__ = *--e__;                                                      \
+      } else {                                                              \
+        ++s__;                                                              \
+      }                                                                     \
+    }                                                                       \
+    (v)->length = e__ - (v)->data;                                          \
+  } while (0)
+
+
+VEC_COLD int VEC_API(vec_expand_)(uint8_t **data, vec_size_t *options, const size_t *length, vec_size_t *capacity, vec_size_t memsz);
+
+int VEC_API(vec_expand_n_)(uint8_t **data, vec_size_t *options, const size_t *length, vec_size_t *capacity, vec_size_t memsz, vec_size_t n);
 
 int VEC_API(vec_reserve_)(uint8_t **data, vec_size_t *options, const size_t *length, vec_size_t *capacity, vec_size_t memsz, vec_size_t n);
 
@@ -460,33 +967,541 @@ int VEC_API(vec_compact_)(uint8_t **data, vec_size_t *options, const size_t *len
 
 int VEC_API(vec_insert_)(uint8_t **data, vec_size_t *options, vec_size_t *length, vec_size_t *capacity, vec_size_t memsz, vec_size_t idx);
 
+int VEC_API(vec_insertarr_)(uint8_t **data, vec_size_t *options, const size_t *length, vec_size_t *capacity, vec_size_t memsz, vec_size_t idx, vec_size_t count);
+
 void VEC_API(vec_splice_)(uint8_t *const *data, const vec_size_t *options, const size_t *length, const vec_size_t *capacity, vec_size_t memsz, vec_size_t start, vec_size_t count);
 
+vec_size_t VEC_API(vec_splice_indices_)(uint8_t *const *data, const vec_size_t *options, const size_t *length, const vec_size_t *capacity, vec_size_t memsz, const vec_size_t *idx, vec_size_t count);
+
+vec_size_t VEC_API(vec_splice_ranges_)(uint8_t *const *data, const vec_size_t *options, const size_t *length, const vec_size_t *capacity, vec_size_t memsz, const vec_range_t *ranges, vec_size_t count);
+
 void VEC_API(vec_swapsplice_)(uint8_t *const *data, const vec_size_t *options, const size_t *length, const vec_size_t *capacity, vec_size_t memsz, vec_size_t start, vec_size_t count);
 
 void VEC_API(vec_swap_)(uint8_t *const *data, const vec_size_t *options, const size_t *length, const vec_size_t *capacity, vec_size_t memsz, vec_size_t idx1, vec_size_t idx2);
 
+vec_size_t VEC_API(vec_find_)(uint8_t *const *data, const vec_size_t *options, const size_t *length, const vec_size_t *capacity, vec_size_t memsz, const void *key, int kind);
+
+vec_size_t VEC_API(vec_rfind_)(uint8_t *const *data, const vec_size_t *options, const size_t *length, const vec_size_t *capacity, vec_size_t memsz, const void *key, int kind);
+
+vec_size_t VEC_API(vec_count_)(uint8_t *const *data, const vec_size_t *options, const size_t *length, const vec_size_t *capacity, vec_size_t memsz, const void *key, int kind);
+
+int VEC_API(vec_sort_radix_)(uint8_t *const *data, const vec_size_t *options, const size_t *length, const vec_size_t *capacity, vec_size_t memsz, int kind);
+
+int VEC_API(vec_eytzinger_)(uint8_t **data, vec_size_t *options, const size_t *length, vec_size_t *capacity, vec_size_t memsz, const void *src, vec_size_t n, int to_sorted);
+
+vec_size_t VEC_API(vec_bsearch_batch_)(uint8_t *const *data, const vec_size_t *options, const size_t *length, const vec_size_t *capacity, vec_size_t memsz, const void *keys, vec_size_t nkeys, vec_size_t *out, int (*fn)(const void *, const void *));
+
+void VEC_API(vec_reverse_)(uint8_t *const *data, const vec_size_t *options, const size_t *length, const vec_size_t *capacity, vec_size_t memsz);
+
+int VEC_API(vec_init_with_arena_)(uint8_t **data, vec_size_t *options, size_t *length, vec_size_t *capacity, vec_size_t memsz, vec_arena_t *arena);
+
+int VEC_API(vec_init_with_allocator_)(uint8_t **data, vec_size_t *options, size_t *length, vec_size_t *capacity, vec_size_t memsz, const vec_allocator_t **allocator, const vec_allocator_t *a);
+
+void VEC_API(vec_allocator_free_)(uint8_t *const *data, const vec_size_t *options, const size_t *length, const vec_size_t *capacity, vec_size_t memsz);
+
+void VEC_API(vec_unmap_)(uint8_t *const *data, const vec_size_t *options, const size_t *length, const vec_size_t *capacity, vec_size_t memsz);
+
+// Set the bytes above which vectors initialized with vec_init_mapped use page mappings, 0
+// restores VEC_MAP_THRESHOLD. A vector changes storage on its next resize.
+void VEC_API(vec_map_set_threshold)(size_t bytes);
+
+// Bytes above which vectors initialized with vec_init_mapped use page mappings
+size_t VEC_API(vec_map_threshold)(void);
+
+//
+// Arena allocation
+//
+// An arena bumps blocks out of chunks of `chunk_size` bytes, 0 selects VEC_ARENA_CHUNK.
+// Each block records its arena and size in front of it, so a block can be grown or freed
+// without the arena. Only the last block of the arena is grown in place or given back on
+// free, the others are copied on growth and released by vec_arena_reset. Arenas are not
+// thread safe.
+//
+void VEC_API(vec_arena_init)(vec_arena_t *arena, size_t chunk_size);
+
+// Free every chunk of the arena
+void VEC_API(vec_arena_deinit)(vec_arena_t *arena);
+
+// Release every block, the newest chunk is kept for the next blocks
+void VEC_API(vec_arena_reset)(vec_arena_t *arena);
+
+// Bump a block of `bytes`, NULL when a chunk can't be allocated
+void *VEC_API(vec_arena_alloc)(vec_arena_t *arena, size_t bytes);
+
+// Resize a block, in place when it's the last block of its arena and the chunk has room
+void *VEC_API(vec_arena_realloc)(void *ptr, size_t bytes);
+
+// Give the block back when it's the last block of its arena
+void VEC_API(vec_arena_free)(void *ptr);
+
+// Active SIMD level used by the vector kernels, detected on first use
+int VEC_API(vec_simd_level)(void);
+
+// Limit the SIMD level used by the vector kernels, returns the resulting level
+int VEC_API(vec_simd_set_level)(int level);
+
+//
+// Typed vector generation
+//
+// VEC_DECLARE_TYPE(T, name) declares the vector type `name_t` for elements of type `T`.
+//
+// VEC_DEFINE_TYPE(T, name) generates inline functions specialized for `name_t`, the element
+// size is a compile time constant and the data is accessed through restrict qualified
+// pointers of type `T` so copies, swaps and loops can be specialized by the compiler.
+// The `arr` of name_pusharr may point into `v`.
+//
+//   int  name_push(name_t *v, T val)
+//   int  name_insert(name_t *v, vec_size_t idx, T val)
+//   int  name_reserve(name_t *v, vec_size_t n)
+//   int  name_pusharr(name_t *v, const T *arr, vec_size_t count)
+//   int  name_extend(name_t *v, const name_t *v2)
+//   void name_splice(name_t *v, vec_size_t start, vec_size_t count)
+//   void name_swapsplice(name_t *v, vec_size_t start, vec_size_t count)
+//   void name_swap(name_t *v, vec_size_t idx1, vec_size_t idx2)
+//   void name_reverse(name_t *v)
+//   int  name_map(name_t *dst, const name_t *src, T (*f)(T))
+//   T    name_fold(const name_t *v, T ov, T (*f)(T, T))
+//
+// VEC_DEFINE_TYPE_SEARCH(T, name) additionally generates the searches. They use the
+// vec_find_ kernels with GCC and clang, other compilers require `==` on `T`.
+//
+//   vec_size_t name_find(const name_t *v, T val)
+//   vec_size_t name_rfind(const name_t *v, T val)
+//   vec_size_t name_lower_bound(const name_t *v, T key)
+//   vec_size_t name_upper_bound(const name_t *v, T key)
+//
+#define VEC_DECLARE_TYPE(T, name) \
+  typedef VEC_PRE_ALIGN struct { vec_define_fields(T) } name##_t VEC_POST_ALIGN;
+
+
+#define VEC_DEFINE_TYPE(T, name)                                                    \
+  VEC_INLINE int name##_push(name##_t *v, T val) {                                  \
+    if (VEC_UNLIKELY(v->length >= v->capacity)                                      \
+        && VEC_OK != vec_expand_(vec_unpack_(v))) {                                 \
+      return VEC_ERR;                                                               \
+    }                                                                               \
+    v->data[v->length++] = val;                                                     \
+    return VEC_OK;                                                                  \
+  }                                                                                 \
+                                                                                    \
+  VEC_INLINE int name##_insert(name##_t *v, vec_size_t idx, T val) {                \
+    if (VEC_UNLIKELY(v->length >= v->capacity)                                      \
+        && VEC_OK != vec_expand_(vec_unpack_(v))) {                                 \
+      return VEC_ERR;                                                               \
+    }                                                                               \
+    T *VEC_RESTRICT d = v->data;                                                    \
+    memmove(d + idx + 1, d + idx, (v->length - idx) * sizeof(T));                   \
+    d[idx] = val;                                                                   \
+    v->length++;                                                                    \
+    return VEC_OK;                                                                  \
+  }                                                                                 \
+                                                                                    \
+  VEC_INLINE int name##_reserve(name##_t *v, vec_size_t n) {                        \
+    return vec_reserve_(vec_unpack_(v), n) ? VEC_ERR : VEC_OK;                      \
+  }                                                                                 \
+                                                                                    \
+  VEC_INLINE int name##_pusharr(name##_t *v, T const *arr, vec_size_t count) {     \
+    /* arr may point into v, the growth can move it */                              \
+    uintptr_t at = (uintptr_t)arr - (uintptr_t)v->data;                             \
+    int inside = at < v->length * sizeof(T);                                        \
+    if (vec_expand_n_(vec_unpack_(v), count) != VEC_OK) {                           \
+      return VEC_ERR;                                                               \
+    }                                                                               \
+    if (inside) {                                                                   \
+      arr = (T const *)((uint8_t *)v->data + at);                                   \
+    }                                                                               \
+    memcpy(v->data + v->length, arr, count * sizeof(T));                            \
+    v->length += count;                                                             \
+    return VEC_OK;                                                                  \
+  }                                                                                 \
+                                                                                    \
+  VEC_INLINE int name##_extend(name##_t *v, const name##_t *v2) {                   \
+    if (v == v2) {                                                                  \
+      vec_size_t n = v->length;                                                     \
+      if (vec_expand_n_(vec_unpack_(v), n) != VEC_OK) {                             \
+        return VEC_ERR;                                                             \
+      }                                                                             \
+      memcpy(v->data + n, v->data, n * sizeof(T));                                  \
+      v->length += n;                                                               \
+      return VEC_OK;                                                                \
+    }                                                                               \
+    return name##_pusharr(v, v2->data, v2->length);                                 \
+  }                                                                                 \
+                                                                                    \
+  VEC_INLINE void name##_splice(name##_t *v, vec_size_t start, vec_size_t count) {  \
+    T *VEC_RESTRICT d = v->data;                                                    \
+    memmove(d + start, d + start + count,                                           \
+            (v->length - start - count) * sizeof(T));                               \
+    v->length -= count;                                                             \
+  }                                                                                 \
+                                                                                    \
+  VEC_INLINE void name##_swapsplice(name##_t *v, vec_size_t start,                  \
+                                    vec_size_t count) {                             \
+    T *VEC_RESTRICT d = v->data;                                                    \
+    memmove(d + start, d + v->length - count, count * sizeof(T));                   \
+    v->length -= count;                                                             \
+  }                                                                                 \
+                                                                                    \
+  VEC_INLINE void name##_swap(name##_t *v, vec_size_t idx1, vec_size_t idx2) {      \
+    T *VEC_RESTRICT d = v->data;                                                    \
+    T tmp = d[idx1];                                                                \
+    d[idx1] = d[idx2];                                                              \
+    d[idx2] = tmp;                                                                  \
+  }                                                                                 \
+                                                                                    \
+  VEC_INLINE void name##_reverse(name##_t *v) {                                     \
+    T *VEC_RESTRICT lo = v->data;                                                   \
+    T *VEC_RESTRICT hi = v->data + v->length;                                       \
+    while (lo + 1 < hi) {                                                           \
+      T tmp = *lo;                                                                  \
+      *lo++ = *--hi;                                                                \
+      *hi = tmp;                                                                    \
+    }                                                                               \
+  }                                                                                 \
+                                                                                    \
+  VEC_INLINE int name##_map(name##_t *dst, const name##_t *src, T (*f)(T)) {        \
+    if (vec_reserve_(vec_unpack_(dst), src->length) != VEC_OK) {                    \
+      return VEC_ERR;                                                               \
+    }                                                                               \
+    T const *s = src->data;                                                         \
+    T *d = dst->data;                                                               \
+    vec_size_t n = src->length;                                                     \
+    for (vec_size_t i = 0; i < n; ++i) {                                            \
+      d[i] = f(s[i]);                                                               \
+    }                                                                               \
+    dst->length = n;                                                                \
+    return VEC_OK;                                                                  \
+  }                                                                                 \
+                                                                                    \
+  VEC_INLINE T name##_fold(const name##_t *v, T ov, T (*f)(T, T)) {                 \
+    T const *VEC_RESTRICT s = v->data;                                              \
+    for (vec_size_t i = 0, n = v->length; i < n; ++i) {                             \
+      ov = f(ov, s[i]);                                                             \
+    }                                                                               \
+    return ov;                                                                      \
+  }
+
+
+#define VEC_DEFINE_TYPE_BOUNDS_(T, name)                                            \
+  VEC_INLINE vec_size_t name##_lower_bound(const name##_t *v, T key__) {            \
+    vec_size_t idx;                                                                 \
+    vec_search_(v, vec_before_lower_, 0, idx);                                      \
+    return idx;                                                                     \
+  }                                                                                 \
+                                                                                    \
+  VEC_INLINE vec_size_t name##_upper_bound(const name##_t *v, T key__) {            \
+    vec_size_t idx;                                                                 \
+    vec_search_(v, vec_before_upper_, 0, idx);                                      \
+    return idx;                                                                     \
+  }
+
+#if defined(VEC_ELEM_KIND)
+#define VEC_DEFINE_TYPE_SEARCH(T, name)                                             \
+  VEC_DEFINE_TYPE_BOUNDS_(T, name)                                                  \
+  VEC_INLINE vec_size_t name##_find(const name##_t *v, T val) {                     \
+    return vec_find_(vec_unpack_(v), &val, VEC_ELEM_KIND(val));                     \
+  }                                                                                 \
+                                                                                    \
+  VEC_INLINE vec_size_t name##_rfind(const name##_t *v, T val) {                    \
+    return vec_rfind_(vec_unpack_(v), &val, VEC_ELEM_KIND(val));                    \
+  }
+#else
+#define VEC_DEFINE_TYPE_SEARCH(T, name)                                             \
+  VEC_DEFINE_TYPE_BOUNDS_(T, name)                                                  \
+  VEC_INLINE vec_size_t name##_find(const name##_t *v, T val) {                     \
+    T const *VEC_RESTRICT s = v->data;                                              \
+    for (vec_size_t i = 0, n = v->length; i < n; ++i) {                             \
+      if (s[i] == val) return i;                                                    \
+    }                                                                               \
+    return VEC_NOT_FOUND;                                                           \
+  }                                                                                 \
+                                                                                    \
+  VEC_INLINE vec_size_t name##_rfind(const name##_t *v, T val) {                    \
+    T const *VEC_RESTRICT s = v->data;                                              \
+    for (vec_size_t i = v->length; i-- > 0;) {                                      \
+      if (s[i] == val) return i;                                                    \
+    }                                                                               \
+    return VEC_NOT_FOUND;                                                           \
+  }
+#endif // VEC_ELEM_KIND
+
+
 //
 // Pre-defined stand-alone vector structure types
 //
 // All that is required to use the vector APIs is to have the vector fields in your type
 // by passing a pointer to your type the fields will be expanded into the API
 //
-typedef VEC_PRE_ALIGN struct { vec_define_fields(void*) } vec_void_t VEC_POST_ALIGN;
-typedef VEC_PRE_ALIGN struct { vec_define_fields(char*) } vec_str_t VEC_POST_ALIGN;
-typedef VEC_PRE_ALIGN struct { vec_define_fields(int) } vec_int_t VEC_POST_ALIGN;
-typedef VEC_PRE_ALIGN struct { vec_define_fields(int32_t) } vec_int32_t VEC_POST_ALIGN;
-typedef VEC_PRE_ALIGN struct { vec_define_fields(uint32_t) } vec_uint32_t VEC_POST_ALIGN;
-typedef VEC_PRE_ALIGN struct { vec_define_fields(int64_t) } vec_int64_t VEC_POST_ALIGN;
-typedef VEC_PRE_ALIGN struct { vec_define_fields(uint64_t) } vec_uint64_t VEC_POST_ALIGN;
-typedef VEC_PRE_ALIGN struct { vec_define_fields(char) } vec_char_t VEC_POST_ALIGN;
-typedef VEC_PRE_ALIGN struct { vec_define_fields(uint8_t) } vec_uint8_t VEC_POST_ALIGN;
-typedef VEC_PRE_ALIGN struct { vec_define_fields(float) } vec_float_t VEC_POST_ALIGN;
-typedef VEC_PRE_ALIGN struct { vec_define_fields(double) } vec_double_t VEC_POST_ALIGN;
+VEC_DECLARE_TYPE(void*, vec_void)
+VEC_DECLARE_TYPE(char*, vec_str)
+VEC_DECLARE_TYPE(int, vec_int)
+VEC_DECLARE_TYPE(int32_t, vec_int32)
+VEC_DECLARE_TYPE(uint32_t, vec_uint32)
+VEC_DECLARE_TYPE(int64_t, vec_int64)
+VEC_DECLARE_TYPE(uint64_t, vec_uint64)
+VEC_DECLARE_TYPE(char, vec_char)
+VEC_DECLARE_TYPE(uint8_t, vec_uint8)
+VEC_DECLARE_TYPE(float, vec_float)
+VEC_DECLARE_TYPE(double, vec_double)
+
+//
+// Pre-generated typed functions for the pre-defined vector types, vec_int_push(), ...
+//
+#define VEC_DEFINE_TYPE_ALL(T, name) \
+  VEC_DEFINE_TYPE(T, name)           \
+  VEC_DEFINE_TYPE_SEARCH(T, name)
+
+
+//
+// Sort generation
+//
+// VEC_DEFINE_SORT(name, T, less_expr) generates a pattern-defeating quicksort for elements
+// of type `T` with the comparison inlined. `less_expr` is an expression over the pointers
+// `a` and `b` (`T const *`) that is true when `*a` orders before `*b`. Elements are moved
+// with typed assignments, short ranges use insertion sort and unbalanced partitioning
+// falls back to heapsort so the worst case is O(n log n). The sort is not stable.
+//
+//   void name_sort(T *data, vec_size_t n)
+//
+// Use vec_sort_inline(v, name) to sort a vector with the generated sort.
+//
+#define VEC_SORT_INSERTION_MAX 24
+#define VEC_SORT_NINTHER_MIN 128
+#define VEC_SORT_PARTIAL_MAX 8
+
+#define VEC_DEFINE_SORT(name, T, less_expr)                                         \
+  VEC_INLINE int name##_sort_less_(T const *a, T const *b) {                        \
+    return (less_expr);                                                             \
+  }                                                                                 \
+                                                                                    \
+  VEC_INLINE void name##_sort_swap_(T *a, T *b) {                                   \
+    T t = *a;                                                                       \
+    *a = *b;                                                                        \
+    *b = t;                                                                         \
+  }                                                                                 \
+                                                                                    \
+  VEC_INLINE void name##_sort3_(T *a, T *b, T *c) {                                 \
+    if (name##_sort_less_(b, a)) name##_sort_swap_(a, b);                           \
+    if (name##_sort_less_(c, b)) {                                                  \
+      name##_sort_swap_(b, c);                                                      \
+      if (name##_sort_less_(b, a)) name##_sort_swap_(a, b);                         \
+    }                                                                               \
+  }                                                                                 \
+                                                                                    \
+  VEC_INLINE void name##_sort_insertion_(T *d, vec_size_t n) {                      \
+    for (vec_size_t i = 1; i < n; ++i) {                                            \
+      if (name##_sort_less_(&d[i], &d[i - 1])) {                                    \
+        T x = d[i];                                                                 \
+        vec_size_t j = i;                                                           \
+        do {                                                                        \
+          d[j] = d[j - 1];                                                          \
+        } while (--j > 0 && name##_sort_less_(&x, &d[j - 1]));                      \
+        d[j] = x;                                                                   \
+      }                                                                             \
+    }                                                                               \
+  }                                                                                 \
+                                                                                    \
+  /* d[-1] is not greater than any element so the scan needs no bound */            \
+  VEC_INLINE void name##_sort_unguarded_(T *d, vec_size_t n) {                      \
+    for (vec_size_t i = 1; i < n; ++i) {                                            \
+      if (name##_sort_less_(&d[i], &d[i - 1])) {                                    \
+        T x = d[i];                                                                 \
+        T *p = d + i;                                                               \
+        do {                                                                        \
+          *p = p[-1];                                                               \
+        } while (name##_sort_less_(&x, --p - 1));                                   \
+        *p = x;                                                                     \
+      }                                                                             \
+    }                                                                               \
+  }                                                                                 \
+                                                                                    \
+  /* insertion sort that gives up after VEC_SORT_PARTIAL_MAX moves */               \
+  VEC_INLINE int name##_sort_partial_(T *d, vec_size_t n) {                         \
+    vec_size_t moved = 0;                                                           \
+    for (vec_size_t i = 1; i < n; ++i) {                                            \
+      if (name##_sort_less_(&d[i], &d[i - 1])) {                                    \
+        T x = d[i];                                                                 \
+        vec_size_t j = i;                                                           \
+        do {                                                                        \
+          d[j] = d[j - 1];                                                          \
+        } while (--j > 0 && name##_sort_less_(&x, &d[j - 1]));                      \
+        d[j] = x;                                                                   \
+        moved += i - j;                                                             \
+        if (moved > VEC_SORT_PARTIAL_MAX) return 0;                                 \
+      }                                                                             \
+    }                                                                               \
+    return 1;                                                                       \
+  }                                                                                 \
+                                                                                    \
+  VEC_INLINE void name##_sort_sift_(T *d, vec_size_t i, vec_size_t n) {             \
+    T x = d[i];                                                                     \
+    for (;;) {                                                                      \
+      vec_size_t c = 2 * i + 1;                                                     \
+      if (c >= n) break;                                                            \
+      if (c + 1 < n && name##_sort_less_(&d[c], &d[c + 1])) ++c;                    \
+      if (!name##_sort_less_(&x, &d[c])) break;                                     \
+      d[i] = d[c];                                                                  \
+      i = c;                                                                        \
+    }                                                                               \
+    d[i] = x;                                                                       \
+  }                                                                                 \
+                                                                                    \
+  VEC_INLINE void name##_sort_heap_(T *d, vec_size_t n) {                           \
+    for (vec_size_t i = n / 2; i-- > 0;) {                                          \
+      name##_sort_sift_(d, i, n);                                                   \
+    }                                                                               \
+    for (vec_size_t i = n; i-- > 1;) {                                              \
+      name##_sort_swap_(&d[0], &d[i]);                                              \
+      name##_sort_sift_(d, 0, i);                                                   \
+    }                                                                               \
+  }                                                                                 \
+                                                                                    \
+  /* partition around the pivot d[0], elements equal to the pivot go right */       \
+  VEC_INLINE vec_size_t name##_sort_partition_right_(T *d, vec_size_t n,            \
+                                                      int *already) {               \
+    T pivot = d[0];                                                                 \
+    vec_size_t first = 0, last = n;                                                 \
+    while (name##_sort_less_(&d[++first], &pivot));                                 \
+    if (first == 1) {                                                               \
+      while (first < last && !name##_sort_less_(&d[--last], &pivot));               \
+    } else {                                                                        \
+      while (!name##_sort_less_(&d[--last], &pivot));                               \
+    }                                                                               \
+    *already = first >= last;                                                       \
+    while (first < last) {                                                          \
+      name##_sort_swap_(&d[first], &d[last]);                                       \
+      while (name##_sort_less_(&d[++first], &pivot));                               \
+      while (!name##_sort_less_(&d[--last], &pivot));                               \
+    }                                                                               \
+    d[0] = d[first - 1];                                                            \
+    d[first - 1] = pivot;                                                           \
+    return first - 1;                                                               \
+  }                                                                                 \
+                                                                                    \
+  /* partition around the pivot d[0], elements equal to the pivot go left */        \
+  VEC_INLINE vec_size_t name##_sort_partition_left_(T *d, vec_size_t n) {           \
+    T pivot = d[0];                                                                 \
+    vec_size_t first = 0, last = n;                                                 \
+    while (name##_sort_less_(&pivot, &d[--last]));                                  \
+    if (last + 1 == n) {                                                            \
+      while (first < last && !name##_sort_less_(&pivot, &d[++first]));              \
+    } else {                                                                        \
+      while (!name##_sort_less_(&pivot, &d[++first]));                              \
+    }                                                                               \
+    while (first < last) {                                                          \
+      name##_sort_swap_(&d[first], &d[last]);                                       \
+      while (name##_sort_less_(&pivot, &d[--last]));                                \
+      while (!name##_sort_less_(&pivot, &d[++first]));                              \
+    }                                                                               \
+    d[0] = d[last];                                                                 \
+    d[last] = pivot;                                                                \
+    return last;                                                                    \
+  }                                                                                 \
+                                                                                    \
+  /* swap a few elements of an unbalanced side to break up the input pattern */     \
+  VEC_INLINE void name##_sort_shuffle_(T *lo, T *hi, vec_size_t n) {                \
+    name##_sort_swap_(lo, lo + n / 4);                                              \
+    name##_sort_swap_(hi - 1, hi - n / 4);                                          \
+    if (n > VEC_SORT_NINTHER_MIN) {                                                 \
+      name##_sort_swap_(lo + 1, lo + (n / 4 + 1));                                  \
+      name##_sort_swap_(lo + 2, lo + (n / 4 + 2));                                  \
+      name##_sort_swap_(hi - 2, hi - (n / 4 + 1));                                  \
+      name##_sort_swap_(hi - 3, hi - (n / 4 + 2));                                  \
+    }                                                                               \
+  }                                                                                 \
+                                                                                    \
+  VEC_INLINE void name##_sort_loop_(T *d, vec_size_t n, int bad, int leftmost) {    \
+    for (;;) {                                                                      \
+      vec_size_t h = n / 2, p, l, r;                                                \
+      int already;                                                                  \
+      if (n <= VEC_SORT_INSERTION_MAX) {                                            \
+        if (leftmost) {                                                             \
+          name##_sort_insertion_(d, n);                                             \
+        } else {                                                                    \
+          name##_sort_unguarded_(d, n);                                             \
+        }                                                                           \
+        return;                                                                     \
+      }                                                                             \
+      if (n > VEC_SORT_NINTHER_MIN) {                                               \
+        name##_sort3_(d, d + h, d + n - 1);                                         \
+        name##_sort3_(d + 1, d + h - 1, d + n - 2);                                 \
+        name##_sort3_(d + 2, d + h + 1, d + n - 3);                                 \
+        name##_sort3_(d + h - 1, d + h, d + h + 1);                                 \
+        name##_sort_swap_(d, d + h);                                                \
+      } else {                                                                      \
+        name##_sort3_(d + h, d, d + n - 1);                                         \
+      }                                                                             \
+      /* the pivot equals the element before this range, skip every equal element */\
+      if (!leftmost && !name##_sort_less_(d - 1, d)) {                              \
+        p = name##_sort_partition_left_(d, n) + 1;                                  \
+        d += p;                                                                     \
+        n -= p;                                                                     \
+        continue;                                                                   \
+      }                                                                             \
+      p = name##_sort_partition_right_(d, n, &already);                             \
+      l = p;                                                                        \
+      r = n - p - 1;                                                                \
+      if (l < n / 8 || r < n / 8) {                                                 \
+        if (--bad == 0) {                                                           \
+          name##_sort_heap_(d, n);                                                  \
+          return;                                                                   \
+        }                                                                           \
+        if (l > VEC_SORT_INSERTION_MAX) name##_sort_shuffle_(d, d + p, l);          \
+        if (r > VEC_SORT_INSERTION_MAX) name##_sort_shuffle_(d + p + 1, d + n, r);  \
+      } else if (already && name##_sort_partial_(d, l)                              \
+                 && name##_sort_partial_(d + p + 1, r)) {                           \
+        return;                                                                     \
+      }                                                                             \
+      /* recurse into the smaller side and loop on the larger */                    \
+      if (l < r) {                                                                  \
+        name##_sort_loop_(d, l, bad, leftmost);                                     \
+        d += p + 1;                                                                 \
+        n = r;                                                                      \
+        leftmost = 0;                                                               \
+      } else {                                                                      \
+        name##_sort_loop_(d + p + 1, r, bad, 0);                                    \
+        n = l;                                                                      \
+      }                                                                             \
+    }                                                                               \
+  }                                                                                 \
+                                                                                    \
+  VEC_INLINE void name##_sort(T *data, vec_size_t n) {                              \
+    int bad = 0;                                                                    \
+    for (vec_size_t m = n; m > 1; m >>= 1) ++bad;                                   \
+    if (n > 1) {                                                                    \
+      name##_sort_loop_(data, n, bad, 1);                                           \
+    }                                                                               \
+  }
+
+
+// Sort a vector with a sort generated by VEC_DEFINE_SORT
+#define vec_sort_inline(v, name) \
+  name##_sort((v)->data, (v)->length)
+
+VEC_DEFINE_TYPE_ALL(void*, vec_void)
+VEC_DEFINE_TYPE_ALL(char*, vec_str)
+VEC_DEFINE_TYPE_ALL(int, vec_int)
+VEC_DEFINE_TYPE_ALL(int32_t, vec_int32)
+VEC_DEFINE_TYPE_ALL(uint32_t, vec_uint32)
+VEC_DEFINE_TYPE_ALL(int64_t, vec_int64)
+VEC_DEFINE_TYPE_ALL(uint64_t, vec_uint64)
+VEC_DEFINE_TYPE_ALL(char, vec_char)
+VEC_DEFINE_TYPE_ALL(uint8_t, vec_uint8)
+VEC_DEFINE_TYPE_ALL(float, vec_float)
+VEC_DEFINE_TYPE_ALL(double, vec_double)
 
 
 #if defined(__cplusplus)
 }
 #endif
 
+//
+// Single header mode, define VEC_IMPLEMENTATION before including vec.h in exactly one
+// translation unit to compile the implementation along with it instead of linking vec.c
+//
+#if defined(VEC_IMPLEMENTATION) && !defined(INCLUDED_VEC_IMPLEMENTATION)
+#define INCLUDED_VEC_IMPLEMENTATION
+#include "vec.c"
+#endif
+
 #endif // INCLUDED_VEC_H
@@ -0,0 +1,123 @@
+/**
+ * Copyright (c) 2014 rxi (https://github.com/rxi/vec)
+ *
+ * v0.3.x modifications (c) 2022 Jacob Repp (https://github.com/jrepp/vec)
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the MIT license. See https://github.com/rxi/vec/LICENSE for details.
+ */
+
+#include "vec_bufpool.h"
+
+
+// Smallest class holding `bytes`, VEC_BUFPOOL_CLASSES when the buffer is too large
+static vec_size_t vec_bufpool_class_(const vec_bufpool_t *pool, size_t bytes) {
+  vec_size_t k = 0;
+  while (k < VEC_BUFPOOL_CLASSES && pool->bytes[k] < bytes) {
+    ++k;
+  }
+  return k;
+}
+
+
+static void *vec_bufpool_alloc_(void *user, size_t bytes) {
+  vec_bufpool_t *pool = (vec_bufpool_t *)user;
+  vec_size_t k = vec_bufpool_class_(pool, bytes);
+  vec_bufpool_block_t *block;
+  if (k == VEC_BUFPOOL_CLASSES) {
+    pool->misses++;
+    return VEC_MALLOC(bytes);
+  }
+  block = pool->free[k];
+  if (block != NULL) {
+    pool->free[k] = block->next;
+    pool->count[k]--;
+    pool->hits++;
+    return block;
+  }
+  pool->misses++;
+  return VEC_MALLOC(pool->bytes[k]);
+}
+
+
+static void vec_bufpool_free_(void *user, void *ptr, size_t bytes) {
+  vec_bufpool_t *pool = (vec_bufpool_t *)user;
+  vec_size_t k = vec_bufpool_class_(pool, bytes);
+  vec_bufpool_block_t *block = (vec_bufpool_block_t *)ptr;
+  if (k == VEC_BUFPOOL_CLASSES || pool->count[k] == VEC_BUFPOOL_DEPTH) {
+    VEC_FREE(ptr);
+    return;
+  }
+  block->next = pool->free[k];
+  pool->free[k] = block;
+  pool->count[k]++;
+}
+
+
+static void *vec_bufpool_realloc_(void *user, void *ptr, size_t old_bytes, size_t new_bytes) {
+  vec_bufpool_t *pool = (vec_bufpool_t *)user;
+  vec_size_t from = vec_bufpool_class_(pool, old_bytes);
+  vec_size_t to = vec_bufpool_class_(pool, new_bytes);
+  void *p;
+  if (from == to) {
+    if (to < VEC_BUFPOOL_CLASSES) {
+      // the buffer already has the bytes of its class
+      pool->hits++;
+      return ptr;
+    }
+    pool->misses++;
+    return VEC_REALLOC(ptr, new_bytes);
+  }
+  p = vec_bufpool_alloc_(user, new_bytes);
+  if (p != NULL) {
+    memcpy(p, ptr, old_bytes < new_bytes ? old_bytes : new_bytes);
+    vec_bufpool_free_(user, ptr, old_bytes);
+  }
+  return p;
+}
+
+
+void vec_bufpool_init(vec_bufpool_t *pool, size_t unit) {
+  vec_size_t k, capacity = VEC_INIT_CAPACITY;
+  memset(pool, 0, sizeof(*pool));
+  if (unit == 0) {
+    unit = VEC_BUFPOOL_UNIT;
+  }
+  for (k = 0; k < VEC_BUFPOOL_CLASSES; ++k) {
+    // a free buffer holds the free list link
+    pool->bytes[k] = capacity * unit < sizeof(vec_bufpool_block_t)
+                   ? sizeof(vec_bufpool_block_t) : capacity * unit;
+    capacity = VEC_GROW_CAPACITY(capacity);
+  }
+  pool->allocator.alloc = vec_bufpool_alloc_;
+  pool->allocator.realloc = vec_bufpool_realloc_;
+  pool->allocator.free = vec_bufpool_free_;
+  pool->allocator.user = pool;
+}
+
+
+void vec_bufpool_deinit(vec_bufpool_t *pool) {
+  vec_size_t k;
+  vec_bufpool_block_t *block;
+  for (k = 0; k < VEC_BUFPOOL_CLASSES; ++k) {
+    while ((block = pool->free[k]) != NULL) {
+      pool->free[k] = block->next;
+      VEC_FREE(block);
+    }
+    pool->count[k] = 0;
+  }
+}
+
+
+#if defined(VEC_THREAD_LOCAL)
+static VEC_THREAD_LOCAL vec_bufpool_t vec_bufpool_local_;
+static VEC_THREAD_LOCAL int vec_bufpool_local_ready_;
+
+vec_bufpool_t *vec_bufpool_local(void) {
+  if (!vec_bufpool_local_ready_) {
+    vec_bufpool_init(&vec_bufpool_local_, 0);
+    vec_bufpool_local_ready_ = 1;
+  }
+  return &vec_bufpool_local_;
+}
+#endif
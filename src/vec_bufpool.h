@@ -0,0 +1,99 @@
+/**
+ * Copyright (c) 2014 rxi (https://github.com/rxi/vec)
+ *
+ * v0.3.x modifications (c) 2022 Jacob Repp (https://github.com/jrepp/vec)
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the MIT license. See https://github.com/rxi/vec/LICENSE for details.
+ */
+
+#ifndef INCLUDED_VEC_BUFPOOL_H
+#define INCLUDED_VEC_BUFPOOL_H
+
+#include "vec.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+//
+// Buffer pools recycle vector storage for vectors that are created and released over and
+// over. The size classes follow the growth of a vector, VEC_INIT_CAPACITY elements grown by
+// VEC_GROW_CAPACITY, times a unit of bytes. Vectors whose element size is the unit move
+// through the classes exactly, a growth within a class keeps the buffer. Released buffers
+// are kept on a free list per class and handed out again. Larger buffers go straight to
+// VEC_MALLOC. A pool is not thread safe, vec_bufpool_local gives each thread its own.
+//
+
+// Number of size classes, with the default growth the last class holds 4875 units
+#if !defined(VEC_BUFPOOL_CLASSES)
+#define VEC_BUFPOOL_CLASSES 8
+#endif
+
+// Buffers kept on the free list of each class, the others are released to VEC_FREE
+#if !defined(VEC_BUFPOOL_DEPTH)
+#define VEC_BUFPOOL_DEPTH 64
+#endif
+
+// Unit of the size classes of the thread local pools
+#if !defined(VEC_BUFPOOL_UNIT)
+#define VEC_BUFPOOL_UNIT sizeof(int)
+#endif
+
+
+typedef struct vec_bufpool_block_t {
+  struct vec_bufpool_block_t *next;
+} vec_bufpool_block_t;
+
+typedef struct {
+  vec_allocator_t allocator;
+  vec_bufpool_block_t *free[VEC_BUFPOOL_CLASSES];
+  size_t count[VEC_BUFPOOL_CLASSES];
+  size_t bytes[VEC_BUFPOOL_CLASSES];
+  // Allocations served by the pool and allocations that went to VEC_MALLOC
+  size_t hits, misses;
+} vec_bufpool_t;
+
+
+// Allocator context to initialize vectors with (see vec_init_with_allocator)
+#define vec_bufpool_allocator(pool) \
+  ((const vec_allocator_t *)&(pool)->allocator)
+
+
+// Allocations served from the free lists or kept in place by a growth within a class
+#define vec_bufpool_hits(pool) ((pool)->hits)
+
+
+// Allocations that went to VEC_MALLOC or VEC_REALLOC
+#define vec_bufpool_misses(pool) ((pool)->misses)
+
+
+// Initialize a pool whose size classes are `unit` bytes times the vector capacities,
+// 0 selects VEC_BUFPOOL_UNIT
+void VEC_API(vec_bufpool_init)(vec_bufpool_t *pool, size_t unit);
+
+// Release the buffers on the free lists, vectors still using the pool must be released
+// before the pool goes away
+void VEC_API(vec_bufpool_deinit)(vec_bufpool_t *pool);
+
+// The pool of the calling thread, initialized with VEC_BUFPOOL_UNIT on first use. Vectors
+// using it must be released on the same thread, and the thread releases the pool with
+// vec_bufpool_deinit before it exits. Only available with VEC_THREAD_LOCAL, a pool
+// shared by the threads would not be safe.
+#if defined(VEC_THREAD_LOCAL)
+vec_bufpool_t *VEC_API(vec_bufpool_local)(void);
+#endif
+
+#if defined(__cplusplus)
+}
+#endif
+
+//
+// Single header mode, see VEC_IMPLEMENTATION in vec.h
+//
+#if defined(VEC_IMPLEMENTATION) && !defined(INCLUDED_VEC_BUFPOOL_IMPLEMENTATION)
+#define INCLUDED_VEC_BUFPOOL_IMPLEMENTATION
+#include "vec_bufpool.c"
+#endif
+
+#endif // INCLUDED_VEC_BUFPOOL_H
@@ -0,0 +1,172 @@
+/**
+ * Copyright (c) 2014 rxi (https://github.com/rxi/vec)
+ *
+ * v0.3.x modifications (c) 2022 Jacob Repp (https://github.com/jrepp/vec)
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the MIT license. See https://github.com/rxi/vec/LICENSE for details.
+ */
+
+#include "vec_concurrent.h"
+
+// A segment of n elements is followed by n ready flags, a flag is set once its element is
+// written. The ready flags let a push that finishes early leave its element for a slower
+// push to publish, so no push waits for another.
+#if defined(__GNUC__) || defined(__clang__)
+#define vec_cload_(p) __atomic_load_n(p, __ATOMIC_SEQ_CST)
+#define vec_cstore_(p, x) __atomic_store_n(p, x, __ATOMIC_SEQ_CST)
+#define vec_cfetch_add_(p, x) __atomic_fetch_add(p, x, __ATOMIC_SEQ_CST)
+#define vec_cfetch_or_(p, x) __atomic_fetch_or(p, x, __ATOMIC_SEQ_CST)
+#define vec_ccas_(p, expect, x) \
+  __atomic_compare_exchange_n(p, expect, x, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)
+#else
+#define vec_cload_(p) (*(p))
+#define vec_cstore_(p, x) (*(p) = (x))
+#define vec_cfetch_add_(p, x) ((*(p) += (x)) - (x))
+#define vec_cfetch_or_(p, x) (*(p) |= (x))
+#define vec_ccas_(p, expect, x) \
+  (*(p) == *(expect) ? (*(p) = (x), 1) : (*(expect) = *(p), 0))
+#endif
+
+
+static vec_size_t vec_concurrent_cap_(vec_size_t s) {
+  return (vec_size_t)VEC_CONCURRENT_FIRST << s;
+}
+
+
+// The segment `s`, allocated when missing. Threads racing to allocate it keep the first.
+static uint8_t *vec_concurrent_segment_(uint8_t **segments, vec_size_t memsz, vec_size_t s) {
+  uint8_t *seg = vec_cload_(&segments[s]), *expect = NULL;
+  vec_size_t cap = vec_concurrent_cap_(s);
+  if (seg != NULL) {
+    return seg;
+  }
+  if (cap > (vec_size_t)-1 / (memsz + 1)) {
+    return NULL;
+  }
+  seg = (uint8_t *)VEC_MALLOC(cap * (memsz + 1));
+  if (seg == NULL) {
+    return NULL;
+  }
+  memset(seg + cap * memsz, 0, cap);
+  if (!vec_ccas_(&segments[s], &expect, seg)) {
+    VEC_FREE(seg);
+    return expect;
+  }
+  return seg;
+}
+
+
+void vec_concurrent_deinit_(uint8_t **segments, size_t *reserved, size_t *length, vec_size_t memsz) {
+  vec_size_t s;
+  (void) memsz;
+  for (s = 0; s < VEC_CONCURRENT_SEGMENTS; ++s) {
+    if (segments[s] != NULL) {
+      VEC_FREE(segments[s]);
+      segments[s] = NULL;
+    }
+  }
+  *reserved = 0;
+  *length = 0;
+}
+
+
+void vec_concurrent_clear_(uint8_t **segments, size_t *reserved, size_t *length, vec_size_t memsz) {
+  vec_size_t s;
+  for (s = 0; s < VEC_CONCURRENT_SEGMENTS; ++s) {
+    if (segments[s] != NULL) {
+      vec_size_t cap = vec_concurrent_cap_(s);
+      memset(segments[s] + cap * memsz, 0, cap);
+    }
+  }
+  *reserved = 0;
+  *length = 0;
+}
+
+
+int vec_concurrent_reserve_(uint8_t **segments, size_t *reserved, size_t *length, vec_size_t memsz, vec_size_t n) {
+  vec_size_t s, last;
+  (void) length;
+  if (vec_cload_(reserved) & VEC_CONCURRENT_FAILED) {
+    return VEC_ERR;
+  }
+  if (n == 0) {
+    return VEC_OK;
+  }
+  last = vec_concurrent_seg_(n - 1);
+  if (last >= VEC_CONCURRENT_SEGMENTS) {
+    return VEC_ERR_NO_MEMORY;
+  }
+  for (s = 0; s <= last; ++s) {
+    if (vec_concurrent_segment_(segments, memsz, s) == NULL) {
+      return VEC_ERR_NO_MEMORY;
+    }
+  }
+  return VEC_OK;
+}
+
+
+void *vec_concurrent_claim_(uint8_t **segments, size_t *reserved, size_t *length, vec_size_t memsz, vec_size_t *idx) {
+  vec_size_t i = vec_cfetch_add_(reserved, 1), s = vec_concurrent_seg_(i), off;
+  uint8_t *seg;
+  (void) length;
+  if (VEC_UNLIKELY(i & VEC_CONCURRENT_FAILED)) {
+    return NULL;
+  }
+  if (VEC_UNLIKELY(s >= VEC_CONCURRENT_SEGMENTS)) {
+    (void)vec_cfetch_or_(reserved, VEC_CONCURRENT_FAILED);
+    return NULL;
+  }
+  off = vec_concurrent_off_(i, s);
+  // allocate the next segment half way through this one so pushes rarely find it missing
+  if (VEC_UNLIKELY(off == vec_concurrent_cap_(s) / 2) && s + 1 < VEC_CONCURRENT_SEGMENTS) {
+    (void)vec_concurrent_segment_(segments, memsz, s + 1);
+  }
+  seg = vec_concurrent_segment_(segments, memsz, s);
+  if (VEC_UNLIKELY(seg == NULL)) {
+    // the index can never be published, fail every later push instead of storing
+    // elements the length never reaches
+    (void)vec_cfetch_or_(reserved, VEC_CONCURRENT_FAILED);
+    return NULL;
+  }
+  *idx = i;
+  return seg + off * memsz;
+}
+
+
+// The ready flag of index `i`, NULL while its segment is missing
+static uint8_t *vec_concurrent_ready_(uint8_t **segments, vec_size_t memsz, vec_size_t i) {
+  vec_size_t s = vec_concurrent_seg_(i);
+  uint8_t *seg;
+  if (s >= VEC_CONCURRENT_SEGMENTS || (seg = vec_cload_(&segments[s])) == NULL) {
+    return NULL;
+  }
+  return seg + vec_concurrent_cap_(s) * memsz + vec_concurrent_off_(i, s);
+}
+
+
+void vec_concurrent_publish_(uint8_t **segments, size_t *reserved, size_t *length, vec_size_t memsz, vec_size_t idx) {
+  size_t l = vec_cload_(length);
+  uint8_t *ready;
+  (void) reserved;
+  // The length only passes idx once this push publishes it, so when the length is at idx
+  // the push publishes itself without its flag. Otherwise the flag is left for the push
+  // that reaches idx.
+  if (l != idx || !vec_ccas_(length, &l, l + 1)) {
+    vec_cstore_(vec_concurrent_ready_(segments, memsz, idx), 1);
+    l = vec_cload_(length);
+  } else {
+    ++l;
+  }
+  // Advance the length over the written elements. Stopping at an unwritten element is
+  // safe, its push sets the flag before reading the length so it continues from here.
+  for (;;) {
+    ready = vec_concurrent_ready_(segments, memsz, l);
+    if (ready == NULL || !vec_cload_(ready)) {
+      break;
+    }
+    if (vec_ccas_(length, &l, l + 1)) {
+      ++l;
+    }
+  }
+}
@@ -0,0 +1,192 @@
+/**
+ * Copyright (c) 2014 rxi (https://github.com/rxi/vec)
+ *
+ * v0.3.x modifications (c) 2022 Jacob Repp (https://github.com/jrepp/vec)
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the MIT license. See https://github.com/rxi/vec/LICENSE for details.
+ */
+
+#ifndef INCLUDED_VEC_CONCURRENT_H
+#define INCLUDED_VEC_CONCURRENT_H
+
+#include "vec_seg.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+//
+// Append only vectors that many threads can push to without a lock. A push reserves its
+// index with an atomic add and the elements live in segments that double in size, so an
+// element never moves once written. The length is the longest prefix of completely
+// written elements, readers always see a consistent prefix of the pushes. The atomics use
+// the GCC and clang builtins, with other compilers the vectors are for a single thread.
+//
+
+// Elements in the first segment, a power of two. Segment s holds VEC_CONCURRENT_FIRST << s.
+#if !defined(VEC_CONCURRENT_FIRST)
+#define VEC_CONCURRENT_FIRST 64
+#endif
+
+// Number of segments, more than can be allocated on a 64 bit address space
+#define VEC_CONCURRENT_SEGMENTS VEC_SEG_SEGMENTS
+
+// Set in `reserved` once a push failed to allocate its segment, later pushes fail
+#define VEC_CONCURRENT_FAILED ((size_t)1 << (sizeof(size_t) * CHAR_BIT - 1))
+
+
+// Given a concurrent vector unpack it into arguments for the helper functions
+#define vec_concurrent_unpack_(c) \
+  (uint8_t**)(c)->segments, &(c)->reserved, &(c)->length, sizeof(**(c)->segments)
+
+
+// Declare a new concurrent vector type. `reserved` counts the claimed indices, `length`
+// the published prefix.
+#define vec_concurrent_define_fields(T) \
+   T *segments[VEC_CONCURRENT_SEGMENTS]; size_t reserved, length;
+
+
+// Initialize concurrent vector fields, no memory is allocated until the first push
+#define vec_concurrent_init(c) \
+  (void) (memset((c)->segments, 0, sizeof((c)->segments)), (c)->reserved = 0, (c)->length = 0)
+
+
+// Free the segments, no thread may be pushing
+#define vec_concurrent_deinit(c) \
+  vec_concurrent_deinit_(vec_concurrent_unpack_(c))
+
+
+// Forget the elements but keep the segments for reuse, no thread may be pushing
+#define vec_concurrent_clear(c) \
+  vec_concurrent_clear_(vec_concurrent_unpack_(c))
+
+
+// Allocate the segments for the first `n` elements so pushes below `n` never allocate,
+// returns VEC_OK, VEC_ERR_NO_MEMORY or VEC_ERR after a failed push
+#define vec_concurrent_reserve(c, n) \
+  vec_concurrent_reserve_(vec_concurrent_unpack_(c), n)
+
+
+// True once a push failed, the length stops below the failed index and every later push
+// returns VEC_ERR until the vector is cleared
+#define vec_concurrent_failed(c) \
+  ((vec_concurrent_length_(&(c)->reserved) & VEC_CONCURRENT_FAILED) != 0)
+
+
+// Number of elements published, every element below it is completely written
+#define vec_concurrent_length(c) \
+  vec_concurrent_length_(&(c)->length)
+
+
+// Get an element at an index below vec_concurrent_length
+#define vec_concurrent_get(c, i) \
+  ((c)->segments[vec_concurrent_seg_(i)][vec_concurrent_off_(i, vec_concurrent_seg_(i))])
+
+
+// Get an element by pointer at an index below vec_concurrent_length
+#define vec_concurrent_get_ptr(c, i) \
+  (&vec_concurrent_get(c, i))
+
+
+// Push an element, returns VEC_OK or VEC_ERR. Requires VEC_DEFINE_CONCURRENT for `name`.
+#define vec_concurrent_push(c, val, name) \
+  name##_concurrent_push(c, val)
+
+
+// Append the published elements to the vector `dst` of the same element type, returns
+// VEC_OK or VEC_ERR when `dst` can't grow
+#define vec_concurrent_flatten(c, dst)                                    \
+  vec_seg_flatten_((uint8_t *const *)(c)->segments, VEC_CONCURRENT_FIRST, \
+                   vec_concurrent_length(c), sizeof(**(c)->segments),     \
+                   vec_unpack_(dst))
+
+
+// Segment holding index `i`
+VEC_INLINE vec_size_t vec_concurrent_seg_(vec_size_t i) {
+  return vec_seg_of_(i, VEC_CONCURRENT_FIRST);
+}
+
+
+// Offset of index `i` in its segment `s`
+VEC_INLINE vec_size_t vec_concurrent_off_(vec_size_t i, vec_size_t s) {
+  return vec_seg_off_(i, s, VEC_CONCURRENT_FIRST);
+}
+
+
+VEC_INLINE vec_size_t vec_concurrent_length_(const size_t *length) {
+#if defined(__GNUC__) || defined(__clang__)
+  return __atomic_load_n(length, __ATOMIC_ACQUIRE);
+#else
+  return *length;
+#endif
+}
+
+
+void VEC_API(vec_concurrent_deinit_)(uint8_t **segments, size_t *reserved, size_t *length, vec_size_t memsz);
+
+void VEC_API(vec_concurrent_clear_)(uint8_t **segments, size_t *reserved, size_t *length, vec_size_t memsz);
+
+int VEC_API(vec_concurrent_reserve_)(uint8_t **segments, size_t *reserved, size_t *length, vec_size_t memsz, vec_size_t n);
+
+// Claim the next index into `idx` and return its slot, NULL when its segment can't be
+// allocated. The slot must be written and then published.
+void *VEC_API(vec_concurrent_claim_)(uint8_t **segments, size_t *reserved, size_t *length, vec_size_t memsz, vec_size_t *idx);
+
+// Mark the slot `idx` written and advance the length over every written slot
+void VEC_API(vec_concurrent_publish_)(uint8_t **segments, size_t *reserved, size_t *length, vec_size_t memsz, vec_size_t idx);
+
+
+//
+// VEC_DEFINE_CONCURRENT(T, name) declares the concurrent vector `name_concurrent_t` of `T`
+// and its push
+//
+//   int name_concurrent_push(name_concurrent_t *c, T val)
+//
+// A failed push leaves its index claimed but never published, the length stops below it.
+// The failure is sticky, every later push and reserve returns VEC_ERR until
+// vec_concurrent_clear. Pushes already running alongside the failed one may still store
+// an element past it. Reserve up front with vec_concurrent_reserve when pushes must not
+// fail.
+//
+#define VEC_DEFINE_CONCURRENT(T, name)                                              \
+  typedef struct { vec_concurrent_define_fields(T) } name##_concurrent_t;           \
+                                                                                    \
+  VEC_INLINE int name##_concurrent_push(name##_concurrent_t *c, T val) {            \
+    vec_size_t idx;                                                                 \
+    T *slot = (T *)vec_concurrent_claim_(vec_concurrent_unpack_(c), &idx);          \
+    if (VEC_UNLIKELY(slot == NULL)) {                                               \
+      return VEC_ERR;                                                               \
+    }                                                                               \
+    *slot = val;                                                                    \
+    vec_concurrent_publish_(vec_concurrent_unpack_(c), idx);                        \
+    return VEC_OK;                                                                  \
+  }
+
+
+VEC_DEFINE_CONCURRENT(void*, vec_void)
+VEC_DEFINE_CONCURRENT(char*, vec_str)
+VEC_DEFINE_CONCURRENT(int, vec_int)
+VEC_DEFINE_CONCURRENT(int32_t, vec_int32)
+VEC_DEFINE_CONCURRENT(uint32_t, vec_uint32)
+VEC_DEFINE_CONCURRENT(int64_t, vec_int64)
+VEC_DEFINE_CONCURRENT(uint64_t, vec_uint64)
+VEC_DEFINE_CONCURRENT(char, vec_char)
+VEC_DEFINE_CONCURRENT(uint8_t, vec_uint8)
+VEC_DEFINE_CONCURRENT(float, vec_float)
+VEC_DEFINE_CONCURRENT(double, vec_double)
+
+
+#if defined(__cplusplus)
+}
+#endif
+
+//
+// Single header mode, see VEC_IMPLEMENTATION in vec.h
+//
+#if defined(VEC_IMPLEMENTATION) && !defined(INCLUDED_VEC_CONCURRENT_IMPLEMENTATION)
+#define INCLUDED_VEC_CONCURRENT_IMPLEMENTATION
+#include "vec_concurrent.c"
+#endif
+
+#endif // INCLUDED_VEC_CONCURRENT_H
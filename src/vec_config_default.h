@@ -14,6 +14,17 @@
 #define VEC_INIT_CAPACITY 8
 #define VEC_GROW_CAPACITY(n) (((n) << 1) + (n >> 1))
 
+// Bytes in each chunk an arena takes from VEC_MALLOC, larger blocks get a chunk of their own
+#if !defined(VEC_ARENA_CHUNK)
+#define VEC_ARENA_CHUNK (64 * 1024)
+#endif
+
+// Bytes above which vectors initialized with vec_init_mapped keep their elements in page
+// mappings (see vec_map_set_threshold)
+#if !defined(VEC_MAP_THRESHOLD)
+#define VEC_MAP_THRESHOLD (4 * 1024 * 1024)
+#endif
+
 // If a different size type is desired
 #if !defined(VEC_SIZE_TYPE)
 typedef size_t vec_size_t;
@@ -34,10 +45,77 @@ typedef VEC_SIZE_TYPE vec_size_t;
   #define VEC_PRE_ALIGN
   #define VEC_POST_ALIGN __attribute__ ((aligned (8)))
   #define VEC_TYPEOF(v) __typeof__(v)
+  #define VEC_SAME_TYPE(a, b) __builtin_types_compatible_p(__typeof__(a), __typeof__(b))
 #elif defined(WIN32)
   #define VEC_PRE_ALIGN __declspec(align(8))
   #define VEC_POST_ALIGN
   #define VEC_TYPEOF(v) decltype(v)
+  #define VEC_SAME_TYPE(a, b) 0
+#endif
+
+//
+// Typed function generation helpers (see VEC_DEFINE_TYPE)
+//
+#if defined(__GNUC__) || defined(__clang__)
+  #define VEC_INLINE static __inline__
+  #define VEC_RESTRICT __restrict__
+#elif defined(_MSC_VER)
+  #define VEC_INLINE static __inline
+  #define VEC_RESTRICT __restrict
+#else
+  #define VEC_INLINE static
+  #define VEC_RESTRICT
+#endif
+
+//
+// Branch prediction, inlining and prefetch hints, the vector fast paths are expanded
+// inline and only call out of line to grow storage
+//
+#if defined(__GNUC__) || defined(__clang__)
+  #define VEC_LIKELY(x) __builtin_expect(!!(x), 1)
+  #define VEC_UNLIKELY(x) __builtin_expect(!!(x), 0)
+  #define VEC_COLD __attribute__ ((cold, noinline))
+  #define VEC_PREFETCH(p) __builtin_prefetch(p)
+#elif defined(_MSC_VER)
+  #define VEC_LIKELY(x) (x)
+  #define VEC_UNLIKELY(x) (x)
+  #define VEC_COLD __declspec(noinline)
+  #define VEC_PREFETCH(p) ((void)(p))
+#else
+  #define VEC_LIKELY(x) (x)
+  #define VEC_UNLIKELY(x) (x)
+  #define VEC_COLD
+  #define VEC_PREFETCH(p) ((void)(p))
+#endif
+
+//
+// Thread local storage for the per thread buffer pools (see vec_bufpool_local), when
+// undefined vec_bufpool_local is not available
+//
+#if defined(__GNUC__) || defined(__clang__)
+  #define VEC_THREAD_LOCAL __thread
+#elif defined(_MSC_VER)
+  #define VEC_THREAD_LOCAL __declspec(thread)
+#endif
+
+//
+// Count the leading zero bits of a nonzero unsigned long long, a shift loop is used
+// when undefined
+//
+#if defined(__GNUC__) || defined(__clang__)
+  #define VEC_CLZ(x) __builtin_clzll(x)
+#endif
+
+//
+// Classify an element for the search kernels (see vec_find), integers, enums and
+// pointers compare by value, floating point with `==` and anything else byte for byte.
+// When undefined the searches fall back to a `==` loop.
+//
+#if defined(__GNUC__) || defined(__clang__)
+  #define VEC_ELEM_KIND(x)                                      \
+    ( __builtin_classify_type(x) == 8 ? VEC_KIND_FLOAT          \
+      : __builtin_classify_type(x) <= 5 ? VEC_KIND_BITS         \
+      : VEC_KIND_BYTES )
 #endif
 
 //
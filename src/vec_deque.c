@@ -0,0 +1,114 @@
+/**
+ * Copyright (c) 2014 rxi (https://github.com/rxi/vec)
+ *
+ * v0.3.x modifications (c) 2022 Jacob Repp (https://github.com/jrepp/vec)
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the MIT license. See https://github.com/rxi/vec/LICENSE for details.
+ */
+
+#include "vec_deque.h"
+
+
+// Move the elements to a new buffer of `new_capacity`, unwrapped so the front is in slot 0.
+// Realloc would copy the wrapped layout as is and leave a second copy to fix it up.
+static int vec_deque_grow_(uint8_t **data, vec_size_t *options, const size_t *length, vec_size_t *capacity,
+                           vec_size_t memsz, size_t *head, vec_size_t new_capacity) {
+  uint8_t *ptr;
+  if (0 == (*options & VEC_ALLOW_REALLOC)) {
+    return VEC_ERR_NO_REALLOC;
+  }
+  ptr = VEC_MALLOC(new_capacity * memsz);
+  if (ptr == NULL) {
+    *options |= VEC_OOM;
+    return VEC_ERR_NO_MEMORY;
+  }
+  if (*length > 0) {
+    vec_size_t first = *capacity - *head;
+    if (first > *length) {
+      first = *length;
+    }
+    memcpy(ptr, *data + *head * memsz, first * memsz);
+    memcpy(ptr + first * memsz, *data, (*length - first) * memsz);
+  }
+  if (*options & VEC_OWNS_MEMORY) {
+    VEC_FREE(*data);
+  }
+  *options |= VEC_OWNS_MEMORY;
+  *data = ptr;
+  *capacity = new_capacity;
+  *head = 0;
+  return VEC_OK;
+}
+
+
+VEC_COLD int vec_deque_expand_(uint8_t **data, vec_size_t *options, size_t *length, vec_size_t *capacity,
+                               vec_size_t memsz, size_t *head, vec_size_t n) {
+  vec_size_t new_capacity;
+  if (*length + n <= *capacity) {
+    return VEC_OK;
+  }
+  new_capacity = (*capacity == 0) ? VEC_INIT_CAPACITY : VEC_GROW_CAPACITY(*capacity);
+  if (new_capacity < *length + n) {
+    new_capacity = *length + n;
+  }
+  return vec_deque_grow_(data, options, length, capacity, memsz, head, new_capacity);
+}
+
+
+int vec_deque_reserve_(uint8_t **data, vec_size_t *options, size_t *length, vec_size_t *capacity,
+                       vec_size_t memsz, size_t *head, vec_size_t n) {
+  if (n <= *capacity) {
+    return VEC_OK;
+  }
+  return vec_deque_grow_(data, options, length, capacity, memsz, head, n);
+}
+
+
+int vec_deque_push_back_arr_(uint8_t **data, vec_size_t *options, size_t *length, vec_size_t *capacity,
+                             vec_size_t memsz, size_t *head, const void *arr, vec_size_t count) {
+  const uint8_t *src = (const uint8_t *)arr;
+  vec_size_t tail, first;
+  int err;
+  if (count == 0) {
+    return VEC_OK;
+  }
+  err = vec_deque_expand_(data, options, length, capacity, memsz, head, count);
+  if (err != VEC_OK) {
+    return err;
+  }
+  // the free slots run from the tail to the end of the buffer and on from slot 0
+  tail = vec_deque_at_(*head, *capacity, *length);
+  first = *capacity - tail;
+  if (first > count) {
+    first = count;
+  }
+  memcpy(*data + tail * memsz, src, first * memsz);
+  memcpy(*data, src + first * memsz, (count - first) * memsz);
+  *length += count;
+  return VEC_OK;
+}
+
+
+vec_size_t vec_deque_pop_front_arr_(uint8_t **data, vec_size_t *options, size_t *length, vec_size_t *capacity,
+                                    vec_size_t memsz, size_t *head, void *arr, vec_size_t count) {
+  uint8_t *dst = (uint8_t *)arr;
+  vec_size_t first;
+  (void) options;
+  if (count > *length) {
+    count = *length;
+  }
+  if (count == 0) {
+    return 0;
+  }
+  first = *capacity - *head;
+  if (first > count) {
+    first = count;
+  }
+  memcpy(dst, *data + *head * memsz, first * memsz);
+  memcpy(dst + first * memsz, *data, (count - first) * memsz);
+  *length -= count;
+  // an empty deque starts over at slot 0 so the next pushes don't wrap
+  *head = *length == 0 ? 0 : vec_deque_at_(*head, *capacity, count);
+  return count;
+}
@@ -0,0 +1,200 @@
+/**
+ * Copyright (c) 2014 rxi (https://github.com/rxi/vec)
+ *
+ * v0.3.x modifications (c) 2022 Jacob Repp (https://github.com/jrepp/vec)
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the MIT license. See https://github.com/rxi/vec/LICENSE for details.
+ */
+
+#ifndef INCLUDED_VEC_DEQUE_H
+#define INCLUDED_VEC_DEQUE_H
+
+#include "vec.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+//
+// Double ended queues are vectors used as a ring buffer. The storage is the same as
+// vec_define_fields plus `head`, the slot of the first element, and the elements wrap from
+// the end of the buffer to its start. Pushes and pops at both ends are constant time.
+// Growing copies the elements unwrapped into the new buffer so `head` is 0 again.
+// Only the vec_deque functions understand the wrapped layout, vec_deinit and
+// vec_oom also work.
+//
+
+// Given a deque unpack it into arguments for the helper functions
+#define vec_deque_unpack_(d) \
+  vec_unpack_(d), &(d)->head
+
+
+// Declare a new deque type
+#define vec_deque_define_fields(T) \
+   vec_define_fields(T) size_t head;
+
+
+// Initialize deque fields
+#define vec_deque_init(d) \
+  (void) (vec_init(d), (d)->head = 0)
+
+
+// Initialize with a fixed buffer, no reallocation
+#define vec_deque_init_with_fixed(d, ptr, capacity_) \
+  (void) (vec_init_with_fixed(d, ptr, capacity_), (d)->head = 0)
+
+
+// Free deque memory
+#define vec_deque_deinit(d) \
+  (void) (vec_deinit(d), (d)->head = 0)
+
+
+// Length of the deque in elements
+#define vec_deque_length(d) ((d)->length)
+
+
+// Capacity of the deque in elements
+#define vec_deque_capacity(d) ((d)->capacity)
+
+
+// Get the element `i` places from the front
+#define vec_deque_get(d, i) \
+  ((d)->data[vec_deque_at_((d)->head, (d)->capacity, (VEC_CHECK(d, i), i))])
+
+
+// Get the element `i` places from the front by pointer
+#define vec_deque_get_ptr(d, i) \
+  (&vec_deque_get(d, i))
+
+
+// Get the first element
+#define vec_deque_front(d) \
+  ((d)->data[(VEC_CHECK(d, 0), (d)->head)])
+
+
+// Get the last element
+#define vec_deque_back(d) \
+  vec_deque_get(d, (d)->length - 1)
+
+
+// True when there is room for one more element or the deque could be grown
+#define vec_deque_ensure_one_(d)                            \
+  ( VEC_LIKELY((d)->length < (d)->capacity)                 \
+    || VEC_OK == vec_deque_expand_(vec_deque_unpack_(d), 1) )
+
+
+// Push an element after the back, returns VEC_OK or VEC_ERR
+#define vec_deque_push_back(d, val)                                       \
+  ( vec_deque_ensure_one_(d)                                              \
+     ? (                                                                  \
+        (d)->data[vec_deque_at_((d)->head, (d)->capacity, (d)->length)]   \
+          = (val),                                                        \
+        (d)->length++,                                                    \
+        VEC_OK                                                            \
+       )                                                                  \
+     : VEC_ERR                                                            \
+  )
+
+
+// Push an element before the front, returns VEC_OK or VEC_ERR
+#define vec_deque_push_front(d, val)                                      \
+  ( vec_deque_ensure_one_(d)                                              \
+     ? (                                                                  \
+        (d)->head = ((d)->head == 0 ? (d)->capacity : (d)->head) - 1,     \
+        (d)->data[(d)->head] = (val),                                     \
+        (d)->length++,                                                    \
+        VEC_OK                                                            \
+       )                                                                  \
+     : VEC_ERR                                                            \
+  )
+
+
+// Remove the first element and return it, the deque must not be empty
+#define vec_deque_pop_front(d) \
+  ((d)->data[(VEC_CHECK(d, 0), vec_deque_pop_front_(&(d)->head, &(d)->length, (d)->capacity))])
+
+
+// Remove the last element and return it, the deque must not be empty
+#define vec_deque_pop_back(d) \
+  ((d)->data[(VEC_CHECK(d, 0), vec_deque_at_((d)->head, (d)->capacity, --(d)->length))])
+
+
+// Push `count` elements of the array `arr` after the back with at most two copies,
+// returns VEC_OK or an error
+#define vec_deque_push_back_arr(d, arr, count) \
+  vec_deque_push_back_arr_(vec_deque_unpack_(d), (arr), (count))
+
+
+// Move up to `count` elements from the front into the array `arr` with at most two
+// copies, returns the number of elements moved
+#define vec_deque_pop_front_arr(d, arr, count) \
+  vec_deque_pop_front_arr_(vec_deque_unpack_(d), (arr), (count))
+
+
+// Reserve capacity for `n` elements, returns VEC_OK or an error
+#define vec_deque_reserve(d, n) \
+  vec_deque_reserve_(vec_deque_unpack_(d), n)
+
+
+// Remove every element, the buffer is kept
+#define vec_deque_clear(d) \
+  (void) ((d)->length = 0, (d)->head = 0)
+
+
+// Iterate over the elements from the front, `var` is the element and `iter` its position
+#define vec_deque_foreach(d, var, iter)                                                 \
+  if ((d)->length > 0)                                                                  \
+    for ((iter) = 0;                                                                    \
+         (iter) < (d)->length                                                           \
+         && (((var) = (d)->data[vec_deque_at_((d)->head, (d)->capacity, (iter))]), 1);  \
+         ++(iter))
+
+
+// Iterate over the elements from the front, `var` is a pointer to the element
+#define vec_deque_foreach_ptr(d, var, iter)                                             \
+  if ((d)->length > 0)                                                                  \
+    for ((iter) = 0;                                                                    \
+         (iter) < (d)->length                                                           \
+         && (((var) = &(d)->data[vec_deque_at_((d)->head, (d)->capacity, (iter))]), 1); \
+         ++(iter))
+
+
+// Slot of the element `i` places after `head`, a subtraction instead of a modulo
+VEC_INLINE vec_size_t vec_deque_at_(size_t head, size_t capacity, vec_size_t i) {
+  vec_size_t j = head + i;
+  return j >= capacity ? j - capacity : j;
+}
+
+
+// Advance the head past the first element and return its old slot
+VEC_INLINE vec_size_t vec_deque_pop_front_(size_t *head, size_t *length, size_t capacity) {
+  vec_size_t slot = *head;
+  *head = slot + 1 == capacity ? 0 : slot + 1;
+  --*length;
+  return slot;
+}
+
+
+VEC_COLD int VEC_API(vec_deque_expand_)(uint8_t **data, vec_size_t *options, size_t *length, vec_size_t *capacity, vec_size_t memsz, size_t *head, vec_size_t n);
+
+int VEC_API(vec_deque_reserve_)(uint8_t **data, vec_size_t *options, size_t *length, vec_size_t *capacity, vec_size_t memsz, size_t *head, vec_size_t n);
+
+int VEC_API(vec_deque_push_back_arr_)(uint8_t **data, vec_size_t *options, size_t *length, vec_size_t *capacity, vec_size_t memsz, size_t *head, const void *arr, vec_size_t count);
+
+vec_size_t VEC_API(vec_deque_pop_front_arr_)(uint8_t **data, vec_size_t *options, size_t *length, vec_size_t *capacity, vec_size_t memsz, size_t *head, void *arr, vec_size_t count);
+
+
+#if defined(__cplusplus)
+}
+#endif
+
+//
+// Single header mode, see VEC_IMPLEMENTATION in vec.h
+//
+#if defined(VEC_IMPLEMENTATION) && !defined(INCLUDED_VEC_DEQUE_IMPLEMENTATION)
+#define INCLUDED_VEC_DEQUE_IMPLEMENTATION
+#include "vec_deque.c"
+#endif
+
+#endif // INCLUDED_VEC_DEQUE_H
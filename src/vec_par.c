@@ -0,0 +1,619 @@
+/**
+ * Copyright (c) 2014 rxi (https://github.com/rxi/vec)
+ *
+ * v0.3.x modifications (c) 2022 Jacob Repp (https://github.com/jrepp/vec)
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the MIT license. See https://github.com/rxi/vec/LICENSE for details.
+ */
+
+// clock_gettime and the pthreads are POSIX, request them before the first include so
+// strict C99 builds see them
+#if !defined(VEC_NO_THREADS) && !defined(_WIN32) && !defined(_POSIX_C_SOURCE) && !defined(_GNU_SOURCE)
+#define _POSIX_C_SOURCE 200112L
+#endif
+
+#include "vec_par.h"
+
+#if !defined(VEC_NO_THREADS) && !defined(_WIN32) && (defined(__GNUC__) || defined(__clang__))
+#define VEC_HAVE_THREADS 1
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+static vec_size_t vec_par_grain_ = VEC_PAR_GRAIN;
+static vec_size_t vec_par_serial_max_ = VEC_PAR_SERIAL_MAX;
+
+void vec_par_set_grain(vec_size_t grain) {
+  vec_par_grain_ = grain ? grain : VEC_PAR_GRAIN;
+}
+
+vec_size_t vec_par_grain(void) {
+  return vec_par_grain_;
+}
+
+void vec_par_set_serial_max(vec_size_t n) {
+  vec_par_serial_max_ = n ? n : VEC_PAR_SERIAL_MAX;
+}
+
+static void vec_par_loop_(vec_size_t n, vec_size_t grain, vec_size_t serial_max, vec_par_body_t body, void *ctx);
+
+void vec_par_for(vec_size_t n, vec_par_body_t body, void *ctx) {
+  vec_par_loop_(n, vec_par_grain_, vec_par_serial_max_, body, ctx);
+}
+
+
+void vec_par_for_(vec_size_t n, vec_size_t grain, vec_par_body_t body, void *ctx) {
+  vec_par_loop_(n, grain, vec_par_serial_max_, body, ctx);
+}
+
+
+#if defined(VEC_HAVE_THREADS)
+
+// Ranges a thread can have waiting in its deque. Each split pushes the upper half and keeps
+// splitting the lower half so a deque holds at most one range per level of splitting, a
+// range that doesn't fit is run without splitting further.
+#define VEC_PAR_DEQUE_SIZE 128
+
+#define vec_load_(p) __atomic_load_n(p, __ATOMIC_RELAXED)
+#define vec_store_(p, x) __atomic_store_n(p, x, __ATOMIC_RELAXED)
+#define vec_add_(p, x) vec_store_(p, vec_load_(p) + (x))
+
+// Chase-Lev deque of index ranges. The owner pushes and pops at the bottom, other threads
+// steal from the top. Ranges are stored as separate words so a steal racing with the owner
+// reads a torn range only when it is about to lose the compare and swap on top.
+typedef struct {
+  long top;
+  char pad0[64 - sizeof(long)];
+  long bottom;
+  char pad1[64 - sizeof(long)];
+  vec_size_t ranges[VEC_PAR_DEQUE_SIZE][2];
+  vec_par_stats_t stats;
+  uint64_t seed;
+  char pad2[64];
+} vec_par_deque_;
+
+
+static int vec_par_deque_push_(vec_par_deque_ *d, vec_size_t lo, vec_size_t hi) {
+  long b = __atomic_load_n(&d->bottom, __ATOMIC_RELAXED);
+  long t = __atomic_load_n(&d->top, __ATOMIC_ACQUIRE);
+  if (b - t >= VEC_PAR_DEQUE_SIZE) {
+    return 0;
+  }
+  vec_store_(&d->ranges[b % VEC_PAR_DEQUE_SIZE][0], lo);
+  vec_store_(&d->ranges[b % VEC_PAR_DEQUE_SIZE][1], hi);
+  __atomic_store_n(&d->bottom, b + 1, __ATOMIC_SEQ_CST);
+  return 1;
+}
+
+
+static int vec_par_deque_pop_(vec_par_deque_ *d, vec_size_t *lo, vec_size_t *hi) {
+  long b = __atomic_load_n(&d->bottom, __ATOMIC_RELAXED) - 1, t;
+  int ok = 1;
+  // top and bottom are sequentially consistent so a thief and the owner can't both miss
+  // the other taking the last range
+  __atomic_store_n(&d->bottom, b, __ATOMIC_SEQ_CST);
+  t = __atomic_load_n(&d->top, __ATOMIC_SEQ_CST);
+  if (t > b) {
+    __atomic_store_n(&d->bottom, b + 1, __ATOMIC_RELAXED);
+    return 0;
+  }
+  *lo = vec_load_(&d->ranges[b % VEC_PAR_DEQUE_SIZE][0]);
+  *hi = vec_load_(&d->ranges[b % VEC_PAR_DEQUE_SIZE][1]);
+  if (t == b) {
+    // the last range, race the thieves for it
+    ok = __atomic_compare_exchange_n(&d->top, &t, t + 1, 0, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED);
+    __atomic_store_n(&d->bottom, b + 1, __ATOMIC_RELAXED);
+  }
+  return ok;
+}
+
+
+static int vec_par_deque_steal_(vec_par_deque_ *d, vec_size_t *lo, vec_size_t *hi) {
+  long t = __atomic_load_n(&d->top, __ATOMIC_SEQ_CST);
+  long b = __atomic_load_n(&d->bottom, __ATOMIC_SEQ_CST);
+  if (t >= b) {
+    return 0;
+  }
+  *lo = vec_load_(&d->ranges[t % VEC_PAR_DEQUE_SIZE][0]);
+  *hi = vec_load_(&d->ranges[t % VEC_PAR_DEQUE_SIZE][1]);
+  return __atomic_compare_exchange_n(&d->top, &t, t + 1, 0, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED);
+}
+
+
+static uint64_t vec_par_now_ns_(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+
+// The pool runs one loop at a time. The caller publishes the loop under the lock, pushes the
+// whole range to its own deque and bumps the generation. Every thread splits the ranges it
+// holds, runs the pieces of at most a grain and steals from the others when it runs dry.
+// The loop is done when the remaining element count reaches zero, the caller returns once
+// every worker has checked back in.
+static struct {
+  pthread_mutex_t lock;
+  pthread_cond_t wake;
+  pthread_cond_t done;
+  pthread_t *threads;
+  vec_par_deque_ *deques;
+  int count;
+  int running;
+  int stop;
+  int busy;
+  unsigned long generation;
+  int active;
+  vec_par_body_t body;
+  void *ctx;
+  vec_size_t grain;
+  vec_size_t remaining;
+} vec_pool_ = { PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, PTHREAD_COND_INITIALIZER,
+                NULL, NULL, 0, 0, 0, 0, 0, 0, NULL, NULL, 0, 0 };
+
+
+// Split [lo, hi) at grain multiples keeping the lower half until it fits a grain, then run it
+static void vec_par_run_(vec_par_deque_ *d, vec_size_t lo, vec_size_t hi) {
+  vec_size_t grain = vec_pool_.grain;
+  while (hi - lo > grain) {
+    vec_size_t chunks = (hi - lo + grain - 1) / grain;
+    vec_size_t mid = lo + chunks / 2 * grain;
+    if (!vec_par_deque_push_(d, mid, hi)) {
+      break;
+    }
+    hi = mid;
+  }
+  vec_pool_.body(vec_pool_.ctx, lo, hi);
+  vec_add_(&d->stats.tasks, 1);
+  __atomic_sub_fetch(&vec_pool_.remaining, hi - lo, __ATOMIC_RELEASE);
+}
+
+
+// Steal a range from a random victim, the others are tried in turn
+static int vec_par_steal_(int self, vec_size_t *lo, vec_size_t *hi) {
+  vec_par_deque_ *d = &vec_pool_.deques[self];
+  int slots = vec_pool_.count + 1, i;
+  uint64_t x = d->seed;
+  x ^= x >> 12;
+  x ^= x << 25;
+  x ^= x >> 27;
+  d->seed = x;
+  for (i = 0; i < slots; i++) {
+    int victim = (int)((x + (uint64_t)i) % (uint64_t)slots);
+    if (victim != self && vec_par_deque_steal_(&vec_pool_.deques[victim], lo, hi)) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+
+static void vec_par_work_(int self) {
+  vec_par_deque_ *d = &vec_pool_.deques[self];
+  vec_size_t lo, hi;
+  for (;;) {
+    uint64_t idle;
+    int found = 0;
+    if (vec_par_deque_pop_(d, &lo, &hi)) {
+      vec_par_run_(d, lo, hi);
+      continue;
+    }
+    if (__atomic_load_n(&vec_pool_.remaining, __ATOMIC_ACQUIRE) == 0) {
+      break;
+    }
+    idle = vec_par_now_ns_();
+    while (__atomic_load_n(&vec_pool_.remaining, __ATOMIC_ACQUIRE) > 0) {
+      if (vec_par_steal_(self, &lo, &hi)) {
+        found = 1;
+        break;
+      }
+      vec_add_(&d->stats.failed_steals, 1);
+      sched_yield();
+    }
+    vec_add_(&d->stats.idle_ns, vec_par_now_ns_() - idle);
+    if (!found) {
+      break;
+    }
+    vec_add_(&d->stats.steals, 1);
+    vec_par_run_(d, lo, hi);
+  }
+}
+
+
+static void *vec_par_worker_(void *arg) {
+  int self = (int)(intptr_t)arg;
+  unsigned long seen = 0;
+  pthread_mutex_lock(&vec_pool_.lock);
+  for (;;) {
+    while (!vec_pool_.stop && vec_pool_.generation == seen) {
+      pthread_cond_wait(&vec_pool_.wake, &vec_pool_.lock);
+    }
+    if (vec_pool_.stop) {
+      break;
+    }
+    seen = vec_pool_.generation;
+    pthread_mutex_unlock(&vec_pool_.lock);
+    vec_par_work_(self);
+    pthread_mutex_lock(&vec_pool_.lock);
+    if (--vec_pool_.active == 0) {
+      pthread_cond_signal(&vec_pool_.done);
+    }
+  }
+  pthread_mutex_unlock(&vec_pool_.lock);
+  return NULL;
+}
+
+
+int vec_par_init(int nthreads) {
+  int i, workers;
+  if (nthreads <= 0) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    nthreads = cpus > 0 ? (int)cpus : 1;
+  }
+  workers = nthreads - 1;
+
+  pthread_mutex_lock(&vec_pool_.lock);
+  if (vec_pool_.running) {
+    pthread_mutex_unlock(&vec_pool_.lock);
+    return VEC_ERR;
+  }
+  // slot 0 is the thread that starts a loop, the workers use the slots after it
+  vec_pool_.deques = VEC_MALLOC(sizeof(vec_par_deque_) * (size_t)nthreads);
+  vec_pool_.threads = workers > 0 ? VEC_MALLOC(sizeof(pthread_t) * (size_t)workers) : NULL;
+  if (vec_pool_.deques == NULL || (workers > 0 && vec_pool_.threads == NULL)) {
+    if (vec_pool_.deques != NULL) VEC_FREE(vec_pool_.deques);
+    if (vec_pool_.threads != NULL) VEC_FREE(vec_pool_.threads);
+    vec_pool_.deques = NULL;
+    vec_pool_.threads = NULL;
+    pthread_mutex_unlock(&vec_pool_.lock);
+    return VEC_ERR;
+  }
+  memset(vec_pool_.deques, 0, sizeof(vec_par_deque_) * (size_t)nthreads);
+  for (i = 0; i < nthreads; i++) {
+    vec_pool_.deques[i].seed = 0x9e3779b97f4a7c15ull * (uint64_t)(i + 1);
+  }
+  vec_pool_.stop = 0;
+  vec_pool_.count = 0;
+  vec_pool_.running = 1;
+  for (i = 0; i < workers; i++) {
+    if (pthread_create(&vec_pool_.threads[i], NULL, vec_par_worker_, (void *)(intptr_t)(i + 1)) != 0) {
+      break;
+    }
+    vec_pool_.count++;
+  }
+  pthread_mutex_unlock(&vec_pool_.lock);
+
+  if (vec_pool_.count < workers) {
+    vec_par_shutdown();
+    return VEC_ERR;
+  }
+  return VEC_OK;
+}
+
+
+void vec_par_shutdown(void) {
+  int i;
+  pthread_mutex_lock(&vec_pool_.lock);
+  if (!vec_pool_.running) {
+    pthread_mutex_unlock(&vec_pool_.lock);
+    return;
+  }
+  vec_pool_.stop = 1;
+  pthread_cond_broadcast(&vec_pool_.wake);
+  pthread_mutex_unlock(&vec_pool_.lock);
+
+  for (i = 0; i < vec_pool_.count; i++) {
+    pthread_join(vec_pool_.threads[i], NULL);
+  }
+
+  pthread_mutex_lock(&vec_pool_.lock);
+  if (vec_pool_.threads != NULL) {
+    VEC_FREE(vec_pool_.threads);
+  }
+  VEC_FREE(vec_pool_.deques);
+  vec_pool_.threads = NULL;
+  vec_pool_.deques = NULL;
+  vec_pool_.count = 0;
+  vec_pool_.running = 0;
+  pthread_mutex_unlock(&vec_pool_.lock);
+}
+
+
+int vec_par_threads(void) {
+  int count;
+  pthread_mutex_lock(&vec_pool_.lock);
+  count = vec_pool_.count + 1;
+  pthread_mutex_unlock(&vec_pool_.lock);
+  return count;
+}
+
+
+int vec_par_stats(vec_par_stats_t *stats, int count) {
+  int i, threads;
+  pthread_mutex_lock(&vec_pool_.lock);
+  threads = vec_pool_.running ? vec_pool_.count + 1 : 0;
+  for (i = 0; i < threads && i < count; i++) {
+    const vec_par_stats_t *s = &vec_pool_.deques[i].stats;
+    stats[i].tasks = vec_load_(&s->tasks);
+    stats[i].steals = vec_load_(&s->steals);
+    stats[i].failed_steals = vec_load_(&s->failed_steals);
+    stats[i].idle_ns = vec_load_(&s->idle_ns);
+  }
+  pthread_mutex_unlock(&vec_pool_.lock);
+  return threads;
+}
+
+
+void vec_par_stats_reset(void) {
+  int i;
+  pthread_mutex_lock(&vec_pool_.lock);
+  for (i = 0; vec_pool_.running && i <= vec_pool_.count; i++) {
+    vec_par_stats_t *s = &vec_pool_.deques[i].stats;
+    vec_store_(&s->tasks, 0);
+    vec_store_(&s->steals, 0);
+    vec_store_(&s->failed_steals, 0);
+    vec_store_(&s->idle_ns, 0);
+  }
+  pthread_mutex_unlock(&vec_pool_.lock);
+}
+
+
+// Loops up to `serial_max` long run on the caller, the sort passes its own task counts
+static void vec_par_loop_(vec_size_t n, vec_size_t grain, vec_size_t serial_max, vec_par_body_t body, void *ctx) {
+  int i;
+  if (n == 0) {
+    return;
+  }
+  if (grain == 0) {
+    grain = 1;
+  }
+  pthread_mutex_lock(&vec_pool_.lock);
+  if (n <= serial_max || n <= grain || vec_pool_.count == 0 || vec_pool_.busy) {
+    pthread_mutex_unlock(&vec_pool_.lock);
+    body(ctx, 0, n);
+    return;
+  }
+  vec_pool_.busy = 1;
+  vec_pool_.body = body;
+  vec_pool_.ctx = ctx;
+  vec_pool_.grain = grain;
+  vec_pool_.remaining = n;
+  for (i = 0; i <= vec_pool_.count; i++) {
+    vec_pool_.deques[i].top = 0;
+    vec_pool_.deques[i].bottom = 0;
+  }
+  vec_par_deque_push_(&vec_pool_.deques[0], 0, n);
+  vec_pool_.active = vec_pool_.count;
+  vec_pool_.generation++;
+  pthread_cond_broadcast(&vec_pool_.wake);
+  pthread_mutex_unlock(&vec_pool_.lock);
+
+  vec_par_work_(0);
+
+  pthread_mutex_lock(&vec_pool_.lock);
+  while (vec_pool_.active > 0) {
+    pthread_cond_wait(&vec_pool_.done, &vec_pool_.lock);
+  }
+  vec_pool_.busy = 0;
+  pthread_mutex_unlock(&vec_pool_.lock);
+}
+
+#else // VEC_HAVE_THREADS
+
+int vec_par_init(int nthreads) {
+  (void) nthreads;
+  return VEC_ERR;
+}
+
+
+void vec_par_shutdown(void) {
+}
+
+
+int vec_par_threads(void) {
+  return 1;
+}
+
+
+int vec_par_stats(vec_par_stats_t *stats, int count) {
+  (void) stats;
+  (void) count;
+  return 0;
+}
+
+
+void vec_par_stats_reset(void) {
+}
+
+
+static void vec_par_loop_(vec_size_t n, vec_size_t grain, vec_size_t serial_max, vec_par_body_t body, void *ctx) {
+  (void) grain;
+  (void) serial_max;
+  if (n > 0) {
+    body(ctx, 0, n);
+  }
+}
+
+#endif // VEC_HAVE_THREADS
+
+
+// The sort splits the vector into 4^k chunks sorted in parallel, then merges pairs of runs
+// in log2(chunks) rounds alternating between the vector and the scratch buffer, an even
+// number of rounds leaves the result in the vector. A round is split into output blocks of
+// a grain each, the start of a block in both input runs is found by binary search so every
+// block merges independently.
+typedef struct {
+  uint8_t *data;
+  uint8_t *scratch;
+  const uint8_t *src;
+  uint8_t *dst;
+  vec_size_t n;
+  vec_size_t memsz;
+  vec_size_t width;
+  vec_size_t block;
+  const vec_par_sort_ops_t *ops;
+  void *ctx;
+} vec_par_sort_job_;
+
+
+static void vec_par_sort_chunks_(void *job_, vec_size_t lo, vec_size_t hi) {
+  vec_par_sort_job_ *job = job_;
+  for (; lo < hi; ++lo) {
+    vec_size_t first = lo * job->width;
+    if (first < job->n) {
+      vec_size_t count = job->n - first < job->width ? job->n - first : job->width;
+      job->ops->sort(job->data + first * job->memsz, job->scratch + first * job->memsz, count, job->ctx);
+    }
+  }
+}
+
+
+static void vec_par_sort_merge_(void *job_, vec_size_t lo, vec_size_t hi) {
+  vec_par_sort_job_ *job = job_;
+  vec_size_t n = job->n, memsz = job->memsz, pair = job->width * 2;
+  vec_size_t o = lo * job->block, end = hi * job->block < n ? hi * job->block : n;
+  // a block can span the end of one pair of runs and the start of the next
+  while (o < end) {
+    vec_size_t p = o / pair * pair;
+    vec_size_t m = n - p < job->width ? n - p : job->width;
+    vec_size_t k = n - p - m < job->width ? n - p - m : job->width;
+    vec_size_t e = p + m + k < end ? p + m + k : end;
+    const uint8_t *a = job->src + p * memsz, *b = a + m * memsz;
+    vec_size_t i0 = job->ops->split(a, m, b, k, o - p, job->ctx);
+    vec_size_t i1 = job->ops->split(a, m, b, k, e - p, job->ctx);
+    job->ops->merge(a + i0 * memsz, i1 - i0, b + (o - p - i0) * memsz, (e - p - i1) - (o - p - i0),
+                    job->dst + o * memsz, job->ctx);
+    o = e;
+  }
+}
+
+
+int vec_par_sort_ops_(void *data, vec_size_t n, vec_size_t memsz, const vec_par_sort_ops_t *ops, void *ctx) {
+  vec_par_sort_job_ job;
+  vec_size_t chunks = 1, threads = (vec_size_t)vec_par_threads();
+  if (n < 2) {
+    return VEC_OK;
+  }
+  job.scratch = VEC_MALLOC(n * memsz);
+  if (job.scratch == NULL) {
+    return VEC_ERR_NO_MEMORY;
+  }
+  // a few chunks per thread so stealing can even out the chunk sorts
+  if (n > vec_par_serial_max_ && threads > 1) {
+    while (chunks < threads * 2 && n / (chunks * 4) >= vec_par_grain_) {
+      chunks *= 4;
+    }
+  }
+  job.data = data;
+  job.n = n;
+  job.memsz = memsz;
+  job.width = (n + chunks - 1) / chunks;
+  job.block = vec_par_grain_;
+  job.ops = ops;
+  job.ctx = ctx;
+  vec_par_loop_(chunks, 1, 0, vec_par_sort_chunks_, &job);
+
+  job.src = job.data;
+  job.dst = job.scratch;
+  for (; job.width < n; job.width *= 2) {
+    uint8_t *t = job.dst;
+    vec_par_loop_((n + job.block - 1) / job.block, 1, 0, vec_par_sort_merge_, &job);
+    job.dst = (uint8_t *)job.src;
+    job.src = t;
+  }
+  if (job.src != job.data) {
+    memcpy(job.data, job.src, n * memsz);
+  }
+  VEC_FREE(job.scratch);
+  return VEC_OK;
+}
+
+
+// Element operations for vec_par_sort, elements are moved with memcpy
+typedef struct {
+  int (*fn)(const void *, const void *);
+  vec_size_t memsz;
+} vec_par_sort_cmp_;
+
+
+static void vec_par_sort_merge_bytes_(const void *a_, vec_size_t m, const void *b_, vec_size_t k, void *out_, void *ctx_) {
+  const vec_par_sort_cmp_ *ctx = ctx_;
+  vec_size_t memsz = ctx->memsz;
+  const uint8_t *a = a_, *b = b_, *ae = a + m * memsz, *be = b + k * memsz;
+  uint8_t *out = out_;
+  while (a < ae && b < be) {
+    // equal elements are taken from the first run first to keep the sort stable
+    if (ctx->fn(b, a) < 0) {
+      memcpy(out, b, memsz);
+      b += memsz;
+    } else {
+      memcpy(out, a, memsz);
+      a += memsz;
+    }
+    out += memsz;
+  }
+  memcpy(out, a, (size_t)(ae - a));
+  memcpy(out + (ae - a), b, (size_t)(be - b));
+}
+
+
+static vec_size_t vec_par_sort_split_bytes_(const void *a_, vec_size_t m, const void *b_, vec_size_t k, vec_size_t pos, void *ctx_) {
+  const vec_par_sort_cmp_ *ctx = ctx_;
+  const uint8_t *a = a_, *b = b_;
+  vec_size_t lo = pos > k ? pos - k : 0, hi = pos < m ? pos : m;
+  while (lo < hi) {
+    vec_size_t i = lo + (hi - lo) / 2;
+    if (ctx->fn(b + (pos - i - 1) * ctx->memsz, a + i * ctx->memsz) < 0) {
+      hi = i;
+    } else {
+      lo = i + 1;
+    }
+  }
+  return lo;
+}
+
+
+static void vec_par_sort_bytes_(void *data_, void *scratch_, vec_size_t n, void *ctx_) {
+  const vec_par_sort_cmp_ *ctx = ctx_;
+  vec_size_t memsz = ctx->memsz, lo, i, j, w;
+  uint8_t *data = data_, *scratch = scratch_, *src = data, *dst = scratch;
+  // insertion sort runs, the scratch buffer is free to hold the element being moved
+  for (lo = 0; lo < n; lo += VEC_PAR_SORT_RUN) {
+    vec_size_t hi = n - lo < VEC_PAR_SORT_RUN ? n : lo + VEC_PAR_SORT_RUN;
+    for (i = lo + 1; i < hi; ++i) {
+      for (j = i; j > lo && ctx->fn(data + i * memsz, data + (j - 1) * memsz) < 0; --j);
+      if (j < i) {
+        memcpy(scratch, data + i * memsz, memsz);
+        memmove(data + (j + 1) * memsz, data + j * memsz, (i - j) * memsz);
+        memcpy(data + j * memsz, scratch, memsz);
+      }
+    }
+  }
+  for (w = VEC_PAR_SORT_RUN; w < n; w *= 2) {
+    uint8_t *t = dst;
+    for (lo = 0; lo < n; lo += 2 * w) {
+      vec_size_t m = n - lo < w ? n - lo : w;
+      vec_size_t k = n - lo - m < w ? n - lo - m : w;
+      vec_par_sort_merge_bytes_(src + lo * memsz, m, src + (lo + m) * memsz, k, dst + lo * memsz, ctx_);
+    }
+    dst = src;
+    src = t;
+  }
+  if (src != data) {
+    memcpy(data, src, n * memsz);
+  }
+}
+
+
+int vec_par_sort_(void *data, vec_size_t n, vec_size_t memsz, int (*fn)(const void *, const void *)) {
+  static const vec_par_sort_ops_t ops = {
+    vec_par_sort_bytes_, vec_par_sort_split_bytes_, vec_par_sort_merge_bytes_
+  };
+  vec_par_sort_cmp_ ctx;
+  ctx.fn = fn;
+  ctx.memsz = memsz;
+  return vec_par_sort_ops_(data, n, memsz, &ops, &ctx);
+}
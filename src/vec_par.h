@@ -0,0 +1,367 @@
+/**
+ * Copyright (c) 2014 rxi (https://github.com/rxi/vec)
+ *
+ * v0.3.x modifications (c) 2022 Jacob Repp (https://github.com/jrepp/vec)
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the MIT license. See https://github.com/rxi/vec/LICENSE for details.
+ */
+
+#ifndef INCLUDED_VEC_PAR_H
+#define INCLUDED_VEC_PAR_H
+
+#include "vec.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+//
+// Parallel loops over vectors on a thread pool owned by vec. The pool uses pthreads with
+// GCC and clang, elsewhere or with VEC_NO_THREADS defined every loop runs on the caller.
+//
+// Loops are scheduled by work stealing: each thread keeps the index ranges it has split off
+// in its own deque and threads that run out of work steal ranges from the others, so loops
+// with an uneven cost per element stay balanced.
+//
+
+// Default number of elements handed to a thread at a time (see vec_par_set_grain)
+#if !defined(VEC_PAR_GRAIN)
+#define VEC_PAR_GRAIN 4096
+#endif
+
+// Default length up to which loops run serially on the caller (see vec_par_set_serial_max)
+#if !defined(VEC_PAR_SERIAL_MAX)
+#define VEC_PAR_SERIAL_MAX 32768
+#endif
+
+// Most partial results of a parallel fold, long vectors are folded in larger chunks
+#define VEC_PAR_FOLD_CHUNKS 256
+
+// Length of the runs the parallel sort sorts by insertion before merging
+#define VEC_PAR_SORT_RUN 32
+
+// A loop body over the elements [lo, hi)
+typedef void (*vec_par_body_t)(void *ctx, vec_size_t lo, vec_size_t hi);
+
+// Scheduler counters of a pool thread, counted over the parallel loops only
+typedef struct {
+  uint64_t tasks;         // ranges run by the body
+  uint64_t steals;        // ranges taken from another thread
+  uint64_t failed_steals; // rounds over the other threads that found no range
+  uint64_t idle_ns;       // time spent looking for a range to steal
+} vec_par_stats_t;
+
+// Start the pool with `nthreads` threads including the caller, 0 uses one per online CPU.
+// Returns VEC_OK, or VEC_ERR when the pool is already running, threads are unavailable or
+// can't be created.
+int VEC_API(vec_par_init)(int nthreads);
+
+// Stop and join the pool threads, loops run serially until the next vec_par_init
+void VEC_API(vec_par_shutdown)(void);
+
+// Number of threads running the loops including the caller, 1 when the pool is stopped
+int VEC_API(vec_par_threads)(void);
+
+// Set the number of elements handed to a thread at a time, 0 restores VEC_PAR_GRAIN
+void VEC_API(vec_par_set_grain)(vec_size_t grain);
+
+// Number of elements handed to a thread at a time
+vec_size_t VEC_API(vec_par_grain)(void);
+
+// Set the length up to which loops run serially, 0 restores VEC_PAR_SERIAL_MAX
+void VEC_API(vec_par_set_serial_max)(vec_size_t n);
+
+// Copy the counters of up to `count` threads into `stats`, the caller is thread 0. Returns
+// the number of pool threads, 0 when the pool is stopped.
+int VEC_API(vec_par_stats)(vec_par_stats_t *stats, int count);
+
+// Zero the counters of every pool thread
+void VEC_API(vec_par_stats_reset)(void);
+
+// Run `body` over [0, n) and wait for every element. The range is split in halves at
+// multiples of the grain size down to chunks of at most a grain, idle threads steal the
+// halves not yet started. Short loops, loops started from inside a body or while another
+// thread's loop is running, and loops without a pool run as a single serial call.
+void VEC_API(vec_par_for)(vec_size_t n, vec_par_body_t body, void *ctx);
+
+// As vec_par_for with chunks of `grain` elements
+void VEC_API(vec_par_for_)(vec_size_t n, vec_size_t grain, vec_par_body_t body, void *ctx);
+
+// Element operations of the parallel merge sort, see VEC_DEFINE_PAR_SORT
+typedef struct {
+  // stable sort the `n` elements of `data` in place using `scratch` of `n` elements
+  void (*sort)(void *data, void *scratch, vec_size_t n, void *ctx);
+  // number of elements of the sorted run `a` among the first `pos` elements of the merge
+  vec_size_t (*split)(const void *a, vec_size_t m, const void *b, vec_size_t k, vec_size_t pos, void *ctx);
+  // merge the sorted runs `a` and `b` into `out`, taking equal elements from `a` first
+  void (*merge)(const void *a, vec_size_t m, const void *b, vec_size_t k, void *out, void *ctx);
+} vec_par_sort_ops_t;
+
+int VEC_API(vec_par_sort_ops_)(void *data, vec_size_t n, vec_size_t memsz, const vec_par_sort_ops_t *ops, void *ctx);
+int VEC_API(vec_par_sort_)(void *data, vec_size_t n, vec_size_t memsz, int (*fn)(const void *, const void *));
+
+
+// `dst` = f(v[i]) for each element of `src` in parallel, returns VEC_OK or VEC_ERR when
+// `dst` can't be reserved. Requires VEC_DEFINE_PAR for `name`.
+#define vec_par_map(dst, src, f, name) \
+  name##_par_map(dst, src, f)
+
+
+// Call f(v[i], arg) for each element of `v` in parallel
+#define vec_par_each(v, f, arg, name) \
+  name##_par_each(v, f, arg)
+
+
+// Call f(&v[i], arg) for each element of `v` in parallel, `f` may modify the elements
+#define vec_par_each_ptr(v, f, arg, name) \
+  name##_par_each_ptr(v, f, arg)
+
+
+// Fold the elements of `v` into `ov` with the associative `f` in parallel, returns the
+// result. Chunks are folded separately and their results combined in order, so `f` need
+// not be commutative.
+#define vec_par_fold(v, ov, f, name) \
+  name##_par_fold(v, ov, f)
+
+
+// Stable sort of `v` with the qsort-compatible compare `fn` in parallel, chunks are sorted
+// on the pool and then merged. Uses one scratch buffer of the vector's size from
+// VEC_MALLOC, returns VEC_OK or VEC_ERR_NO_MEMORY when it can't be allocated.
+#define vec_par_sort(v, fn) \
+  vec_par_sort_((v)->data, (v)->length, sizeof(*(v)->data), fn)
+
+
+// Parallel stable sort of a vector with a sort generated by VEC_DEFINE_PAR_SORT
+#define vec_par_sort_inline(v, name) \
+  name##_par_sort((v)->data, (v)->length)
+
+
+//
+// VEC_DEFINE_PAR(T, name) generates the parallel loops for the vector type `name_t`
+//
+//   int  name_par_map(name_t *dst, const name_t *src, T (*f)(T))
+//   void name_par_each(const name_t *v, void (*f)(T, void *), void *arg)
+//   void name_par_each_ptr(name_t *v, void (*f)(T *, void *), void *arg)
+//   T    name_par_fold(const name_t *v, T ov, T (*f)(T, T))
+//
+#define VEC_DEFINE_PAR(T, name)                                                     \
+  typedef struct {                                                                  \
+    T *dst;                                                                         \
+    T const *src;                                                                   \
+    T (*f)(T);                                                                      \
+  } name##_par_map_ctx_;                                                            \
+                                                                                    \
+  VEC_INLINE void name##_par_map_body_(void *ctx_, vec_size_t lo, vec_size_t hi) {  \
+    name##_par_map_ctx_ *ctx = (name##_par_map_ctx_ *)ctx_;                         \
+    T *VEC_RESTRICT d = ctx->dst;                                                   \
+    T const *VEC_RESTRICT s = ctx->src;                                             \
+    for (; lo < hi; ++lo) {                                                         \
+      d[lo] = ctx->f(s[lo]);                                                        \
+    }                                                                               \
+  }                                                                                 \
+                                                                                    \
+  VEC_INLINE int name##_par_map(name##_t *dst, const name##_t *src, T (*f)(T)) {    \
+    name##_par_map_ctx_ ctx;                                                        \
+    if (vec_reserve_(vec_unpack_(dst), src->length) != VEC_OK) {                    \
+      return VEC_ERR;                                                               \
+    }                                                                               \
+    ctx.dst = dst->data;                                                            \
+    ctx.src = src->data;                                                            \
+    ctx.f = f;                                                                      \
+    vec_par_for(src->length, name##_par_map_body_, &ctx);                           \
+    dst->length = src->length;                                                      \
+    return VEC_OK;                                                                  \
+  }                                                                                 \
+                                                                                    \
+  typedef struct {                                                                  \
+    T const *data;                                                                  \
+    void (*f)(T, void *);                                                           \
+    void *arg;                                                                      \
+  } name##_par_each_ctx_;                                                           \
+                                                                                    \
+  VEC_INLINE void name##_par_each_body_(void *ctx_, vec_size_t lo, vec_size_t hi) { \
+    name##_par_each_ctx_ *ctx = (name##_par_each_ctx_ *)ctx_;                       \
+    for (; lo < hi; ++lo) {                                                         \
+      ctx->f(ctx->data[lo], ctx->arg);                                              \
+    }                                                                               \
+  }                                                                                 \
+                                                                                    \
+  VEC_INLINE void name##_par_each(const name##_t *v, void (*f)(T, void *),          \
+                                  void *arg) {                                      \
+    name##_par_each_ctx_ ctx;                                                       \
+    ctx.data = v->data;                                                             \
+    ctx.f = f;                                                                      \
+    ctx.arg = arg;                                                                  \
+    vec_par_for(v->length, name##_par_each_body_, &ctx);                            \
+  }                                                                                 \
+                                                                                    \
+  typedef struct {                                                                  \
+    T *data;                                                                        \
+    void (*f)(T *, void *);                                                         \
+    void *arg;                                                                      \
+  } name##_par_each_ptr_ctx_;                                                       \
+                                                                                    \
+  VEC_INLINE void name##_par_each_ptr_body_(void *ctx_, vec_size_t lo,              \
+                                            vec_size_t hi) {                        \
+    name##_par_each_ptr_ctx_ *ctx = (name##_par_each_ptr_ctx_ *)ctx_;               \
+    for (; lo < hi; ++lo) {                                                         \
+      ctx->f(&ctx->data[lo], ctx->arg);                                             \
+    }                                                                               \
+  }                                                                                 \
+                                                                                    \
+  VEC_INLINE void name##_par_each_ptr(name##_t *v, void (*f)(T *, void *),          \
+                                      void *arg) {                                  \
+    name##_par_each_ptr_ctx_ ctx;                                                   \
+    ctx.data = v->data;                                                             \
+    ctx.f = f;                                                                      \
+    ctx.arg = arg;                                                                  \
+    vec_par_for(v->length, name##_par_each_ptr_body_, &ctx);                        \
+  }                                                                                 \
+                                                                                    \
+  typedef struct {                                                                  \
+    T const *src;                                                                   \
+    T (*f)(T, T);                                                                   \
+    vec_size_t grain;                                                               \
+    T partial[VEC_PAR_FOLD_CHUNKS];                                                 \
+  } name##_par_fold_ctx_;                                                           \
+                                                                                    \
+  VEC_INLINE void name##_par_fold_body_(void *ctx_, vec_size_t lo, vec_size_t hi) { \
+    name##_par_fold_ctx_ *ctx = (name##_par_fold_ctx_ *)ctx_;                       \
+    T const *VEC_RESTRICT s = ctx->src;                                             \
+    /* a serial run covers every chunk in one call */                               \
+    for (; lo < hi; lo += ctx->grain) {                                             \
+      vec_size_t i, end = hi - lo < ctx->grain ? hi : lo + ctx->grain;              \
+      T ov = s[lo];                                                                 \
+      for (i = lo + 1; i < end; ++i) {                                              \
+        ov = ctx->f(ov, s[i]);                                                      \
+      }                                                                             \
+      ctx->partial[lo / ctx->grain] = ov;                                           \
+    }                                                                               \
+  }                                                                                 \
+                                                                                    \
+  VEC_INLINE T name##_par_fold(const name##_t *v, T ov, T (*f)(T, T)) {             \
+    name##_par_fold_ctx_ ctx;                                                       \
+    vec_size_t n = v->length, i, chunks;                                            \
+    if (n == 0) {                                                                   \
+      return ov;                                                                    \
+    }                                                                               \
+    ctx.src = v->data;                                                              \
+    ctx.f = f;                                                                      \
+    ctx.grain = (n + VEC_PAR_FOLD_CHUNKS - 1) / VEC_PAR_FOLD_CHUNKS;                \
+    if (ctx.grain < vec_par_grain()) {                                              \
+      ctx.grain = vec_par_grain();                                                  \
+    }                                                                               \
+    vec_par_for_(n, ctx.grain, name##_par_fold_body_, &ctx);                        \
+    chunks = (n + ctx.grain - 1) / ctx.grain;                                       \
+    for (i = 0; i < chunks; ++i) {                                                  \
+      ov = f(ov, ctx.partial[i]);                                                   \
+    }                                                                               \
+    return ov;                                                                      \
+  }
+
+
+VEC_DEFINE_PAR(void*, vec_void)
+VEC_DEFINE_PAR(char*, vec_str)
+VEC_DEFINE_PAR(int, vec_int)
+VEC_DEFINE_PAR(int32_t, vec_int32)
+VEC_DEFINE_PAR(uint32_t, vec_uint32)
+VEC_DEFINE_PAR(int64_t, vec_int64)
+VEC_DEFINE_PAR(uint64_t, vec_uint64)
+VEC_DEFINE_PAR(char, vec_char)
+VEC_DEFINE_PAR(uint8_t, vec_uint8)
+VEC_DEFINE_PAR(float, vec_float)
+VEC_DEFINE_PAR(double, vec_double)
+
+
+//
+// VEC_DEFINE_PAR_SORT(name, T, less_expr) generates a stable parallel merge sort for
+// elements of type `T` with the comparison inlined. `less_expr` is an expression over the
+// pointers `a` and `b` (`T const *`) as for VEC_DEFINE_SORT.
+//
+//   int name_par_sort(T *data, vec_size_t n)
+//
+#define VEC_DEFINE_PAR_SORT(name, T, less_expr)                                        \
+  VEC_INLINE int name##_par_sort_less_(T const *a, T const *b) {                       \
+    return (less_expr);                                                                \
+  }                                                                                    \
+                                                                                       \
+  VEC_INLINE void name##_par_sort_merge_(const void *a_, vec_size_t m, const void *b_, \
+                                         vec_size_t k, void *out_, void *ctx) {        \
+    T const *a = (T const *)a_, *ae = a + m, *b = (T const *)b_, *be = b + k;          \
+    T *out = (T *)out_;                                                                \
+    (void) ctx;                                                                        \
+    while (a < ae && b < be) {                                                         \
+      *out++ = name##_par_sort_less_(b, a) ? *b++ : *a++;                              \
+    }                                                                                  \
+    while (a < ae) *out++ = *a++;                                                      \
+    while (b < be) *out++ = *b++;                                                      \
+  }                                                                                    \
+                                                                                       \
+  VEC_INLINE vec_size_t name##_par_sort_split_(const void *a_, vec_size_t m,           \
+                                               const void *b_, vec_size_t k,           \
+                                               vec_size_t pos, void *ctx) {            \
+    T const *a = (T const *)a_, *b = (T const *)b_;                                    \
+    vec_size_t lo = pos > k ? pos - k : 0, hi = pos < m ? pos : m;                     \
+    (void) ctx;                                                                        \
+    while (lo < hi) {                                                                  \
+      vec_size_t i = lo + (hi - lo) / 2;                                               \
+      if (name##_par_sort_less_(&b[pos - i - 1], &a[i])) {                             \
+        hi = i;                                                                        \
+      } else {                                                                         \
+        lo = i + 1;                                                                    \
+      }                                                                                \
+    }                                                                                  \
+    return lo;                                                                         \
+  }                                                                                    \
+                                                                                       \
+  VEC_INLINE void name##_par_sort_chunk_(void *data_, void *scratch_, vec_size_t n,    \
+                                         void *ctx) {                                  \
+    T *data = (T *)data_, *src = data, *dst = (T *)scratch_;                           \
+    vec_size_t lo, i, j, w;                                                            \
+    for (lo = 0; lo < n; lo += VEC_PAR_SORT_RUN) {                                     \
+      vec_size_t hi = n - lo < VEC_PAR_SORT_RUN ? n : lo + VEC_PAR_SORT_RUN;           \
+      for (i = lo + 1; i < hi; ++i) {                                                  \
+        T x = data[i];                                                                 \
+        for (j = i; j > lo && name##_par_sort_less_(&x, &data[j - 1]); --j) {          \
+          data[j] = data[j - 1];                                                       \
+        }                                                                              \
+        data[j] = x;                                                                   \
+      }                                                                                \
+    }                                                                                  \
+    for (w = VEC_PAR_SORT_RUN; w < n; w *= 2) {                                        \
+      T *t = dst;                                                                      \
+      for (lo = 0; lo < n; lo += 2 * w) {                                              \
+        vec_size_t m = n - lo < w ? n - lo : w;                                        \
+        vec_size_t k = n - lo - m < w ? n - lo - m : w;                                \
+        name##_par_sort_merge_(src + lo, m, src + lo + m, k, dst + lo, ctx);           \
+      }                                                                                \
+      dst = src;                                                                       \
+      src = t;                                                                         \
+    }                                                                                  \
+    if (src != data) {                                                                 \
+      memcpy(data, src, n * sizeof(T));                                                \
+    }                                                                                  \
+  }                                                                                    \
+                                                                                       \
+  VEC_INLINE int name##_par_sort(T *data, vec_size_t n) {                              \
+    static const vec_par_sort_ops_t ops = {                                            \
+      name##_par_sort_chunk_, name##_par_sort_split_, name##_par_sort_merge_           \
+    };                                                                                 \
+    return vec_par_sort_ops_(data, n, sizeof(T), &ops, NULL);                          \
+  }
+
+
+#if defined(__cplusplus)
+}
+#endif
+
+//
+// Single header mode, see VEC_IMPLEMENTATION in vec.h
+//
+#if defined(VEC_IMPLEMENTATION) && !defined(INCLUDED_VEC_PAR_IMPLEMENTATION)
+#define INCLUDED_VEC_PAR_IMPLEMENTATION
+#include "vec_par.c"
+#endif
+
+#endif // INCLUDED_VEC_PAR_H
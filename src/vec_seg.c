@@ -0,0 +1,86 @@
+/**
+ * Copyright (c) 2014 rxi (https://github.com/rxi/vec)
+ *
+ * v0.3.x modifications (c) 2022 Jacob Repp (https://github.com/jrepp/vec)
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the MIT license. See https://github.com/rxi/vec/LICENSE for details.
+ */
+
+#include "vec_seg.h"
+
+
+void vec_seg_deinit_(uint8_t **segments, size_t *length, size_t *capacity, vec_size_t memsz) {
+  vec_size_t s;
+  (void) memsz;
+  for (s = 0; s < VEC_SEG_SEGMENTS; ++s) {
+    if (segments[s] != NULL) {
+      VEC_FREE(segments[s]);
+      segments[s] = NULL;
+    }
+  }
+  *length = 0;
+  *capacity = 0;
+}
+
+
+// Allocate the segment after the last one, the capacity is always a whole number of segments
+int vec_seg_expand_(uint8_t **segments, size_t *length, size_t *capacity, vec_size_t memsz) {
+  vec_size_t s = *capacity == 0 ? 0 : vec_seg_of_(*capacity, VEC_SEG_FIRST);
+  vec_size_t count = (vec_size_t)VEC_SEG_FIRST << s;
+  (void) length;
+  if (s >= VEC_SEG_SEGMENTS || count > (vec_size_t)-1 / memsz) {
+    return VEC_ERR_NO_MEMORY;
+  }
+  segments[s] = (uint8_t *)VEC_MALLOC(count * memsz);
+  if (segments[s] == NULL) {
+    return VEC_ERR_NO_MEMORY;
+  }
+  *capacity += count;
+  return VEC_OK;
+}
+
+
+int vec_seg_reserve_(uint8_t **segments, size_t *length, size_t *capacity, vec_size_t memsz, vec_size_t n) {
+  while (*capacity < n) {
+    int err = vec_seg_expand_(segments, length, capacity, memsz);
+    if (err != VEC_OK) {
+      return err;
+    }
+  }
+  return VEC_OK;
+}
+
+
+void vec_seg_compact_(uint8_t **segments, size_t *length, size_t *capacity, vec_size_t memsz) {
+  vec_size_t keep = *length == 0 ? 0 : vec_seg_of_(*length - 1, VEC_SEG_FIRST) + 1, s;
+  (void) memsz;
+  for (s = keep; s < VEC_SEG_SEGMENTS && segments[s] != NULL; ++s) {
+    VEC_FREE(segments[s]);
+    segments[s] = NULL;
+  }
+  *capacity = keep == 0 ? 0 : (vec_size_t)VEC_SEG_FIRST * (((vec_size_t)1 << keep) - 1);
+}
+
+
+// Copies segment by segment, also used by vec_concurrent_flatten
+int vec_seg_flatten_(uint8_t *const *segments, vec_size_t first, vec_size_t n, vec_size_t memsz,
+                     uint8_t **data, vec_size_t *options, size_t *length, vec_size_t *capacity, vec_size_t dst_memsz) {
+  vec_size_t s, copied = 0;
+  if (memsz != dst_memsz) {
+    return VEC_ERR;
+  }
+  if (vec_reserve_(data, options, length, capacity, memsz, *length + n) != VEC_OK) {
+    return VEC_ERR;
+  }
+  for (s = 0; copied < n; ++s) {
+    vec_size_t count = first << s;
+    if (count > n - copied) {
+      count = n - copied;
+    }
+    memcpy(*data + (*length + copied) * memsz, segments[s], count * memsz);
+    copied += count;
+  }
+  *length += n;
+  return VEC_OK;
+}
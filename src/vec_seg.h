@@ -0,0 +1,228 @@
+/**
+ * Copyright (c) 2014 rxi (https://github.com/rxi/vec)
+ *
+ * v0.3.x modifications (c) 2022 Jacob Repp (https://github.com/jrepp/vec)
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the MIT license. See https://github.com/rxi/vec/LICENSE for details.
+ */
+
+#ifndef INCLUDED_VEC_SEG_H
+#define INCLUDED_VEC_SEG_H
+
+#include <limits.h>
+#include "vec.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+//
+// Segmented vectors keep their elements in segments that double in size. Growing
+// allocates the next segment and never copies, so element addresses are stable for the
+// life of the vector and there is no peak of twice the memory while growing. Element i is
+// found in constant time from the position of the highest bit of i / VEC_SEG_FIRST + 1.
+//
+
+// Elements in the first segment, a power of two. Segment s holds VEC_SEG_FIRST << s.
+#if !defined(VEC_SEG_FIRST)
+#define VEC_SEG_FIRST 64
+#endif
+
+// Number of segments, more than can be allocated on a 64 bit address space
+#define VEC_SEG_SEGMENTS 48
+
+
+// Given a segmented vector unpack it into arguments for the helper functions
+#define vec_seg_unpack_(v) \
+  (uint8_t**)(v)->segments, &(v)->length, &(v)->capacity, sizeof(**(v)->segments)
+
+
+// Declare a new segmented vector type
+#define vec_seg_define_fields(T) \
+   T *segments[VEC_SEG_SEGMENTS]; size_t length, capacity;
+
+
+// Initialize segmented vector fields, no memory is allocated until the first push
+#define vec_seg_init(v) \
+  (void) (memset((v)->segments, 0, sizeof((v)->segments)), (v)->length = 0, (v)->capacity = 0)
+
+
+// Free the segments
+#define vec_seg_deinit(v) \
+  vec_seg_deinit_(vec_seg_unpack_(v))
+
+
+// Length of the segmented vector in elements
+#define vec_seg_length(v) ((v)->length)
+
+
+// Capacity of the allocated segments in elements
+#define vec_seg_capacity(v) ((v)->capacity)
+
+
+// Element at index without a bounds check
+#define vec_seg_at_(v, i) \
+  ((v)->segments[vec_seg_of_(i, VEC_SEG_FIRST)][vec_seg_off_(i, vec_seg_of_(i, VEC_SEG_FIRST), VEC_SEG_FIRST)])
+
+
+// Get an element at index
+#define vec_seg_get(v, i) \
+  vec_seg_at_(v, (VEC_CHECK(v, i), i))
+
+
+// Get an element by pointer at index, the pointer stays valid until the vector is freed
+// or compacted below it
+#define vec_seg_get_ptr(v, i) \
+  (&vec_seg_get(v, i))
+
+
+// Push an element, returns VEC_OK or VEC_ERR
+#define vec_seg_push(v, val)                                             \
+  ( (VEC_LIKELY((v)->length < (v)->capacity)                             \
+     || VEC_OK == vec_seg_expand_(vec_seg_unpack_(v)))                   \
+     ? (                                                                 \
+        vec_seg_at_(v, (v)->length) = (val),                             \
+        (v)->length++,                                                   \
+        VEC_OK                                                           \
+       )                                                                 \
+     : VEC_ERR                                                           \
+  )
+
+
+// Remove the last element, returns the new length
+#define vec_seg_pop(v) \
+  ((v)->length > 0 ? (--(v)->length) : 0)
+
+
+// Allocate the segments for `n` elements, returns VEC_OK or VEC_ERR_NO_MEMORY
+#define vec_seg_reserve(v, n) \
+  vec_seg_reserve_(vec_seg_unpack_(v), n)
+
+
+// Set the length to 0 and keep the segments
+#define vec_seg_clear(v) \
+  ((v)->length = 0)
+
+
+// Free the segments past the one holding the last element
+#define vec_seg_compact(v) \
+  vec_seg_compact_(vec_seg_unpack_(v))
+
+
+// Append the elements to the contiguous vector `dst` of the same element type, returns
+// VEC_OK or VEC_ERR when `dst` can't grow
+#define vec_seg_flatten(v, dst)                                                 \
+  vec_seg_flatten_((uint8_t *const *)(v)->segments, VEC_SEG_FIRST, (v)->length, \
+                   sizeof(**(v)->segments), vec_unpack_(dst))
+
+
+// Iterate over each element, `var` is the element and `iter` the index. The loop walks
+// the segments instead of locating every index.
+#define vec_seg_foreach(v, var, iter)                                                 \
+  for (vec_size_t s__ = ((iter) = 0, 0), b__ = 0, e__ = VEC_SEG_FIRST;                \
+       (iter) < (v)->length                                                           \
+       && ((iter) < e__ || (b__ = e__, e__ += (vec_size_t)VEC_SEG_FIRST << ++s__, 1)) \
+       && (((var) = (v)->segments[s__][(iter) - b__]), 1);                            \
+       ++(iter))
+
+
+// Iterate over each element, `var` is a pointer to the element and `iter` the index
+#define vec_seg_foreach_ptr(v, var, iter)                                             \
+  for (vec_size_t s__ = ((iter) = 0, 0), b__ = 0, e__ = VEC_SEG_FIRST;                \
+       (iter) < (v)->length                                                           \
+       && ((iter) < e__ || (b__ = e__, e__ += (vec_size_t)VEC_SEG_FIRST << ++s__, 1)) \
+       && (((var) = &(v)->segments[s__][(iter) - b__]), 1);                           \
+       ++(iter))
+
+
+// Run `body` for each element of `v`, element `j__` of segment `s__`
+#define vec_seg_loop_(v, body)                                                   \
+  do {                                                                           \
+    vec_size_t b__ = 0, s__ = 0;                                                 \
+    for (; b__ < (v)->length; b__ += (vec_size_t)VEC_SEG_FIRST << s__, ++s__) {  \
+      vec_size_t n__ = (v)->length - b__, j__;                                   \
+      if (n__ > (vec_size_t)VEC_SEG_FIRST << s__) {                              \
+        n__ = (vec_size_t)VEC_SEG_FIRST << s__;                                  \
+      }                                                                          \
+      for (j__ = 0; j__ < n__; ++j__) {                                          \
+        body;                                                                    \
+      }                                                                          \
+    }                                                                            \
+  } while (0)
+
+
+// Execute a function on each element of v
+#define vec_seg_each(v, f, ...) \
+  vec_seg_loop_(v, (void)f((v)->segments[s__][j__] , ## __VA_ARGS__ ))
+
+
+// Execute a function on each element of v by pointer
+#define vec_seg_each_ptr(v, f, ...) \
+  vec_seg_loop_(v, (void)f(&(v)->segments[s__][j__] , ## __VA_ARGS__ ))
+
+
+// Apply dst[i] = f(src[i], ...) for each element of src, dst is a segmented vector and is
+// left unchanged when its segments can't be allocated
+#define vec_seg_map(dst, src, f, ...)                                            \
+  do {                                                                           \
+    if (VEC_OK != vec_seg_reserve((dst), (src)->length)) {                       \
+      break;                                                                     \
+    }                                                                            \
+    (dst)->length = (src)->length;                                               \
+    vec_seg_loop_(src, (dst)->segments[s__][j__] =                               \
+                         (f)((src)->segments[s__][j__] , ## __VA_ARGS__ ));      \
+  } while (0)
+
+
+// Apply ov = f(ov, v[i], ...) for each element of v
+#define vec_seg_fold(v, ov, f, ...) \
+  vec_seg_loop_(v, ov = (f)(ov, (v)->segments[s__][j__] , ## __VA_ARGS__ ))
+
+
+// Segment holding index `i` when the first segment holds `first` elements, a power of two
+VEC_INLINE vec_size_t vec_seg_of_(vec_size_t i, vec_size_t first) {
+  unsigned long long x = (unsigned long long)(i / first) + 1;
+#if defined(VEC_CLZ)
+  return (vec_size_t)(sizeof(x) * CHAR_BIT - 1 - VEC_CLZ(x));
+#else
+  vec_size_t s = 0;
+  while (x >>= 1) {
+    ++s;
+  }
+  return s;
+#endif
+}
+
+
+// Offset of index `i` in its segment `s`
+VEC_INLINE vec_size_t vec_seg_off_(vec_size_t i, vec_size_t s, vec_size_t first) {
+  return i - first * (((vec_size_t)1 << s) - 1);
+}
+
+
+void VEC_API(vec_seg_deinit_)(uint8_t **segments, size_t *length, size_t *capacity, vec_size_t memsz);
+
+int VEC_API(vec_seg_expand_)(uint8_t **segments, size_t *length, size_t *capacity, vec_size_t memsz);
+
+int VEC_API(vec_seg_reserve_)(uint8_t **segments, size_t *length, size_t *capacity, vec_size_t memsz, vec_size_t n);
+
+void VEC_API(vec_seg_compact_)(uint8_t **segments, size_t *length, size_t *capacity, vec_size_t memsz);
+
+int VEC_API(vec_seg_flatten_)(uint8_t *const *segments, vec_size_t first, vec_size_t n, vec_size_t memsz,
+                              uint8_t **data, vec_size_t *options, size_t *length, vec_size_t *capacity, vec_size_t dst_memsz);
+
+
+#if defined(__cplusplus)
+}
+#endif
+
+//
+// Single header mode, see VEC_IMPLEMENTATION in vec.h
+//
+#if defined(VEC_IMPLEMENTATION) && !defined(INCLUDED_VEC_SEG_IMPLEMENTATION)
+#define INCLUDED_VEC_SEG_IMPLEMENTATION
+#include "vec_seg.c"
+#endif
+
+#endif // INCLUDED_VEC_SEG_H
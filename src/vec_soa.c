@@ -0,0 +1,79 @@
+/**
+ * Copyright (c) 2014 rxi (https://github.com/rxi/vec)
+ *
+ * v0.3.x modifications (c) 2022 Jacob Repp (https://github.com/jrepp/vec)
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the MIT license. See https://github.com/rxi/vec/LICENSE for details.
+ */
+
+#include "vec_soa.h"
+
+
+void vec_soa_deinit_(uint8_t **const *cols, vec_size_t ncols, size_t *length, size_t *capacity) {
+  vec_size_t k;
+  // the first column is the start of the allocation
+  VEC_FREE(*cols[0]);
+  for (k = 0; k < ncols; ++k) {
+    *cols[k] = NULL;
+  }
+  *length = 0;
+  *capacity = 0;
+}
+
+
+// Move the columns to one allocation of `n` rows, the column offsets are aligned to
+// VEC_SOA_ALIGN
+static int vec_soa_resize_(uint8_t **const *cols, const vec_size_t *sizes, vec_size_t ncols,
+                           const size_t *length, size_t *capacity, vec_size_t n) {
+  vec_size_t offsets[VEC_SOA_MAX_COLUMNS], bytes = 0, k;
+  uint8_t *block;
+  if (ncols > VEC_SOA_MAX_COLUMNS) {
+    return VEC_ERR;
+  }
+  for (k = 0; k < ncols; ++k) {
+    offsets[k] = (bytes + VEC_SOA_ALIGN - 1) & ~(vec_size_t)(VEC_SOA_ALIGN - 1);
+    if (n > ((vec_size_t)-1 - offsets[k]) / sizes[k]) {
+      return VEC_ERR_NO_MEMORY;
+    }
+    bytes = offsets[k] + n * sizes[k];
+  }
+  block = (uint8_t *)VEC_MALLOC(bytes);
+  if (block == NULL) {
+    return VEC_ERR_NO_MEMORY;
+  }
+  for (k = 0; k < ncols; ++k) {
+    if (*length > 0) {
+      memcpy(block + offsets[k], *cols[k], *length * sizes[k]);
+    }
+  }
+  VEC_FREE(*cols[0]);
+  for (k = 0; k < ncols; ++k) {
+    *cols[k] = block + offsets[k];
+  }
+  *capacity = n;
+  return VEC_OK;
+}
+
+
+VEC_COLD int vec_soa_expand_(uint8_t **const *cols, const vec_size_t *sizes, vec_size_t ncols,
+                             const size_t *length, size_t *capacity, vec_size_t n) {
+  vec_size_t new_capacity;
+  if (*length + n <= *capacity) {
+    return VEC_OK;
+  }
+  new_capacity = (*capacity == 0) ? VEC_INIT_CAPACITY : VEC_GROW_CAPACITY(*capacity);
+  if (new_capacity < *length + n) {
+    new_capacity = *length + n;
+  }
+  return vec_soa_resize_(cols, sizes, ncols, length, capacity, new_capacity);
+}
+
+
+int vec_soa_reserve_(uint8_t **const *cols, const vec_size_t *sizes, vec_size_t ncols,
+                     const size_t *length, size_t *capacity, vec_size_t n) {
+  if (n <= *capacity) {
+    return VEC_OK;
+  }
+  return vec_soa_resize_(cols, sizes, ncols, length, capacity, n);
+}
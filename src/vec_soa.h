@@ -0,0 +1,230 @@
+/**
+ * Copyright (c) 2014 rxi (https://github.com/rxi/vec)
+ *
+ * v0.3.x modifications (c) 2022 Jacob Repp (https://github.com/jrepp/vec)
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the MIT license. See https://github.com/rxi/vec/LICENSE for details.
+ */
+
+#ifndef INCLUDED_VEC_SOA_H
+#define INCLUDED_VEC_SOA_H
+
+#include "vec.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+//
+// Struct of arrays vectors store each field of a record in its own column, so a loop over
+// one field reads only that field and the compiler can vectorize it. The columns share one
+// allocation and grow together, the first column is at the start of the allocation.
+//
+
+// Alignment of the column offsets in the allocation, a power of two
+#if !defined(VEC_SOA_ALIGN)
+#define VEC_SOA_ALIGN 64
+#endif
+
+// Most fields of a struct of arrays vector
+#define VEC_SOA_MAX_COLUMNS 16
+
+
+// Expand `m(T, field)` for each `(T, field)` argument
+#define VEC_SOA_EACH_(m, ...) \
+  VEC_SOA_CAT_(VEC_SOA_EACH_, VEC_SOA_NARGS_(__VA_ARGS__))(m, __VA_ARGS__)
+
+#define VEC_SOA_CAT_(a, b) VEC_SOA_CAT2_(a, b)
+#define VEC_SOA_CAT2_(a, b) a##b
+#define VEC_SOA_NARGS_(...) \
+  VEC_SOA_NARGS2_(__VA_ARGS__, 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define VEC_SOA_NARGS2_(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, _14, _15, _16, n, ...) n
+
+#define VEC_SOA_EACH_1(m, a) m a
+#define VEC_SOA_EACH_2(m, a, ...) m a VEC_SOA_EACH_1(m, __VA_ARGS__)
+#define VEC_SOA_EACH_3(m, a, ...) m a VEC_SOA_EACH_2(m, __VA_ARGS__)
+#define VEC_SOA_EACH_4(m, a, ...) m a VEC_SOA_EACH_3(m, __VA_ARGS__)
+#define VEC_SOA_EACH_5(m, a, ...) m a VEC_SOA_EACH_4(m, __VA_ARGS__)
+#define VEC_SOA_EACH_6(m, a, ...) m a VEC_SOA_EACH_5(m, __VA_ARGS__)
+#define VEC_SOA_EACH_7(m, a, ...) m a VEC_SOA_EACH_6(m, __VA_ARGS__)
+#define VEC_SOA_EACH_8(m, a, ...) m a VEC_SOA_EACH_7(m, __VA_ARGS__)
+#define VEC_SOA_EACH_9(m, a, ...) m a VEC_SOA_EACH_8(m, __VA_ARGS__)
+#define VEC_SOA_EACH_10(m, a, ...) m a VEC_SOA_EACH_9(m, __VA_ARGS__)
+#define VEC_SOA_EACH_11(m, a, ...) m a VEC_SOA_EACH_10(m, __VA_ARGS__)
+#define VEC_SOA_EACH_12(m, a, ...) m a VEC_SOA_EACH_11(m, __VA_ARGS__)
+#define VEC_SOA_EACH_13(m, a, ...) m a VEC_SOA_EACH_12(m, __VA_ARGS__)
+#define VEC_SOA_EACH_14(m, a, ...) m a VEC_SOA_EACH_13(m, __VA_ARGS__)
+#define VEC_SOA_EACH_15(m, a, ...) m a VEC_SOA_EACH_14(m, __VA_ARGS__)
+#define VEC_SOA_EACH_16(m, a, ...) m a VEC_SOA_EACH_15(m, __VA_ARGS__)
+
+// Pieces of VEC_DEFINE_SOA expanded for each field, `v` is the vector being worked on
+#define VEC_SOA_COLUMN_(T, f) T *f;
+#define VEC_SOA_FIELD_(T, f) T f;
+#define VEC_SOA_COLUMN_PTR_(T, f) (uint8_t **)&v->f,
+#define VEC_SOA_SIZE_(T, f) sizeof(T),
+#define VEC_SOA_PUT_(T, f) v->f[idx] = row.f;
+#define VEC_SOA_GET_(T, f) row.f = v->f[idx];
+#define VEC_SOA_SWAP_(T, f) { T tmp = v->f[idx1]; v->f[idx1] = v->f[idx2]; v->f[idx2] = tmp; }
+#define VEC_SOA_SPLICE_(T, f) \
+  memmove(v->f + start, v->f + start + count, (v->length - start - count) * sizeof(T));
+#define VEC_SOA_SWAPSPLICE_(T, f) \
+  memmove(v->f + start, v->f + v->length - count, count * sizeof(T));
+
+
+//
+// VEC_DEFINE_SOA(name, (T1, field1), (T2, field2), ...) declares the struct of arrays vector
+// `name_t` with a column `T1 *field1` for each field, its row type `name_row_t` and
+//
+//   void name_init(name_t *v)
+//   void name_deinit(name_t *v)
+//   int name_reserve(name_t *v, vec_size_t n)
+//   int name_push(name_t *v, name_row_t row)
+//   name_row_t name_get(const name_t *v, vec_size_t idx)
+//   void name_set(name_t *v, vec_size_t idx, name_row_t row)
+//   void name_swap(name_t *v, vec_size_t idx1, vec_size_t idx2)
+//   void name_splice(name_t *v, vec_size_t start, vec_size_t count)
+//   void name_swapsplice(name_t *v, vec_size_t start, vec_size_t count)
+//
+// with up to VEC_SOA_MAX_COLUMNS fields. vec_length, vec_capacity, vec_clear and
+// vec_truncate also work, the columns are read and written as `v->field[i]`.
+//
+#define VEC_DEFINE_SOA(name, ...)                                                      \
+  typedef struct {                                                                     \
+    VEC_SOA_EACH_(VEC_SOA_COLUMN_, __VA_ARGS__)                                        \
+    size_t length, capacity;                                                           \
+  } name##_t;                                                                          \
+                                                                                       \
+  typedef struct {                                                                     \
+    VEC_SOA_EACH_(VEC_SOA_FIELD_, __VA_ARGS__)                                         \
+  } name##_row_t;                                                                      \
+                                                                                       \
+  VEC_INLINE void name##_init(name##_t *v) {                                           \
+    memset(v, 0, sizeof(*v));                                                          \
+  }                                                                                    \
+                                                                                       \
+  VEC_INLINE void name##_deinit(name##_t *v) {                                         \
+    uint8_t **cols[] = { VEC_SOA_EACH_(VEC_SOA_COLUMN_PTR_, __VA_ARGS__) };            \
+    vec_soa_deinit_(cols, vec_countof(cols), &v->length, &v->capacity);                \
+  }                                                                                    \
+                                                                                       \
+  VEC_INLINE int name##_reserve(name##_t *v, vec_size_t n) {                           \
+    uint8_t **cols[] = { VEC_SOA_EACH_(VEC_SOA_COLUMN_PTR_, __VA_ARGS__) };            \
+    static const vec_size_t sizes[] = { VEC_SOA_EACH_(VEC_SOA_SIZE_, __VA_ARGS__) };   \
+    return vec_soa_reserve_(cols, sizes, vec_countof(cols), &v->length,                \
+                            &v->capacity, n);                                          \
+  }                                                                                    \
+                                                                                       \
+  VEC_INLINE int name##_push(name##_t *v, name##_row_t row) {                          \
+    vec_size_t idx = v->length;                                                        \
+    if (VEC_UNLIKELY(idx >= v->capacity)) {                                            \
+      uint8_t **cols[] = { VEC_SOA_EACH_(VEC_SOA_COLUMN_PTR_, __VA_ARGS__) };          \
+      static const vec_size_t sizes[] = { VEC_SOA_EACH_(VEC_SOA_SIZE_, __VA_ARGS__) }; \
+      if (VEC_OK != vec_soa_expand_(cols, sizes, vec_countof(cols), &v->length,        \
+                                    &v->capacity, 1)) {                                \
+        return VEC_ERR;                                                                \
+      }                                                                                \
+    }                                                                                  \
+    VEC_SOA_EACH_(VEC_SOA_PUT_, __VA_ARGS__)                                           \
+    v->length++;                                                                       \
+    return VEC_OK;                                                                     \
+  }                                                                                    \
+                                                                                       \
+  VEC_INLINE name##_row_t name##_get(const name##_t *v, vec_size_t idx) {              \
+    name##_row_t row;                                                                  \
+    VEC_SOA_EACH_(VEC_SOA_GET_, __VA_ARGS__)                                           \
+    return row;                                                                        \
+  }                                                                                    \
+                                                                                       \
+  VEC_INLINE void name##_set(name##_t *v, vec_size_t idx, name##_row_t row) {          \
+    VEC_SOA_EACH_(VEC_SOA_PUT_, __VA_ARGS__)                                           \
+  }                                                                                    \
+                                                                                       \
+  VEC_INLINE void name##_swap(name##_t *v, vec_size_t idx1, vec_size_t idx2) {         \
+    VEC_SOA_EACH_(VEC_SOA_SWAP_, __VA_ARGS__)                                          \
+  }                                                                                    \
+                                                                                       \
+  VEC_INLINE void name##_splice(name##_t *v, vec_size_t start, vec_size_t count) {     \
+    VEC_SOA_EACH_(VEC_SOA_SPLICE_, __VA_ARGS__)                                        \
+    v->length -= count;                                                                \
+  }                                                                                    \
+                                                                                       \
+  VEC_INLINE void name##_swapsplice(name##_t *v, vec_size_t start,                     \
+                                    vec_size_t count) {                                \
+    VEC_SOA_EACH_(VEC_SOA_SWAPSPLICE_, __VA_ARGS__)                                    \
+    v->length -= count;                                                                \
+  }
+
+
+//
+// Column loops, `field` names the column of the struct of arrays vector `v`. The loops
+// read one column so they stream only that field through the cache.
+//
+
+// Execute a function on each element of a column
+#define vec_soa_each(v, field, f, ...)                                    \
+  do {                                                                    \
+    VEC_TYPEOF((v)->field[0]) const *s__ = (v)->field;                    \
+    for (vec_size_t i__ = 0, l__ = (v)->length; i__ < l__; ++i__) {       \
+      (void)f(s__[i__] , ## __VA_ARGS__ );                                \
+    }                                                                     \
+  } while (0)
+
+
+// Apply v->field[i] = f(v->field[i], ...) for each element of a column
+#define vec_soa_apply(v, field, f, ...)                                   \
+  do {                                                                    \
+    VEC_TYPEOF((v)->field[0]) *VEC_RESTRICT s__ = (v)->field;             \
+    for (vec_size_t i__ = 0, l__ = (v)->length; i__ < l__; ++i__) {       \
+      s__[i__] = (f)(s__[i__] , ## __VA_ARGS__ );                         \
+    }                                                                     \
+  } while (0)
+
+
+// Apply dst[i] = f(v->field[i], ...) for each element of a column, dst is a vector
+#define vec_soa_map(dst, v, field, f, ...)                                \
+  do {                                                                    \
+    if (VEC_OK != vec_reserve((dst), (v)->length)) {                      \
+      break;                                                              \
+    }                                                                     \
+    (dst)->length = (v)->length;                                          \
+    VEC_TYPEOF((v)->field[0]) const *VEC_RESTRICT s__ = (v)->field;       \
+    VEC_TYPEOF((dst)->data[0]) *VEC_RESTRICT d__ = (dst)->data;           \
+    for (vec_size_t i__ = 0, l__ = (v)->length; i__ < l__; ++i__) {       \
+      d__[i__] = (f)(s__[i__] , ## __VA_ARGS__ );                         \
+    }                                                                     \
+  } while (0)
+
+
+// Apply ov = f(ov, v->field[i], ...) for each element of a column
+#define vec_soa_fold(v, field, ov, f, ...)                                \
+  do {                                                                    \
+    VEC_TYPEOF((v)->field[0]) const *VEC_RESTRICT s__ = (v)->field;       \
+    for (vec_size_t i__ = 0, l__ = (v)->length; i__ < l__; ++i__) {       \
+      ov = (f)(ov, s__[i__] , ## __VA_ARGS__ );                           \
+    }                                                                     \
+  } while (0)
+
+
+void VEC_API(vec_soa_deinit_)(uint8_t **const *cols, vec_size_t ncols, size_t *length, size_t *capacity);
+
+VEC_COLD int VEC_API(vec_soa_expand_)(uint8_t **const *cols, const vec_size_t *sizes, vec_size_t ncols,
+                                      const size_t *length, size_t *capacity, vec_size_t n);
+
+int VEC_API(vec_soa_reserve_)(uint8_t **const *cols, const vec_size_t *sizes, vec_size_t ncols,
+                              const size_t *length, size_t *capacity, vec_size_t n);
+
+
+#if defined(__cplusplus)
+}
+#endif
+
+//
+// Single header mode, see VEC_IMPLEMENTATION in vec.h
+//
+#if defined(VEC_IMPLEMENTATION) && !defined(INCLUDED_VEC_SOA_IMPLEMENTATION)
+#define INCLUDED_VEC_SOA_IMPLEMENTATION
+#include "vec_soa.c"
+#endif
+
+#endif // INCLUDED_VEC_SOA_H
@@ -14,6 +14,19 @@ extern int test_vec_custom();
 extern int test_vec_fixed();
 extern int test_vec_functional();
 extern int test_vec_mem_failures();
+extern int test_vec_typed();
+extern int test_vec_kernels();
+extern int test_vec_sort();
+extern int test_vec_par();
+extern int test_vec_concurrent();
+extern int test_vec_seg();
+extern int test_vec_deque();
+extern int test_vec_soa();
+extern int test_vec_arena();
+extern int test_vec_allocator();
+extern int test_vec_bufpool();
+extern int test_vec_sbo();
+extern int test_vec_mapped();
 
 typedef int (*test_func)(void);
 
@@ -28,6 +41,19 @@ test_suite_t tests[] = {
   { "vec_fixed", test_vec_fixed },
   { "vec_functional", test_vec_functional },
   { "vec_mem_failures", test_vec_mem_failures },
+  { "vec_typed", test_vec_typed },
+  { "vec_kernels", test_vec_kernels },
+  { "vec_sort", test_vec_sort },
+  { "vec_par", test_vec_par },
+  { "vec_concurrent", test_vec_concurrent },
+  { "vec_seg", test_vec_seg },
+  { "vec_deque", test_vec_deque },
+  { "vec_soa", test_vec_soa },
+  { "vec_arena", test_vec_arena },
+  { "vec_allocator", test_vec_allocator },
+  { "vec_bufpool", test_vec_bufpool },
+  { "vec_sbo", test_vec_sbo },
+  { "vec_mapped", test_vec_mapped },
 };
 
 int main() {
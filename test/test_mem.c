@@ -34,6 +34,16 @@ static int force_fail_malloc = 0;
 static int force_fail_realloc = 0;
 static mem_header_t *regions = NULL;
 
+// The vec_par and vec_concurrent tests allocate from several threads at once
+#if defined(__GNUC__) || defined(__clang__)
+static int mem_lock = 0;
+#define MEM_LOCK() while (__atomic_exchange_n(&mem_lock, 1, __ATOMIC_ACQUIRE)) {}
+#define MEM_UNLOCK() __atomic_store_n(&mem_lock, 0, __ATOMIC_RELEASE)
+#else
+#define MEM_LOCK() ((void)0)
+#define MEM_UNLOCK() ((void)0)
+#endif
+
 
 static int assert_valid_pattern(uint8_t *pattern, size_t size, uint8_t byte) {
   for (size_t i = 0; i < size; ++i) {
@@ -71,7 +81,7 @@ void set_fail_realloc(int enable) {
   force_fail_realloc = enable;
 }
 
-void *test_malloc(size_t bytes) {
+static void *mem_malloc(size_t bytes) {
   if (force_fail_malloc) {
     return NULL;
   }
@@ -103,14 +113,14 @@ void *test_malloc(size_t bytes) {
   return (void *)(header + 1);
 }
 
-void *test_realloc(void *existing_request, size_t bytes) {
+static void *mem_realloc(void *existing_request, size_t bytes) {
   if (force_fail_realloc) {
     return NULL;
   }
 
   // Convert realloc into malloc
   if (existing_request == NULL) {
-    return test_malloc(bytes);
+    return mem_malloc(bytes);
   }
 
   // get the current header and footer and validate their memory protections
@@ -180,7 +190,7 @@ void *test_realloc(void *existing_request, size_t bytes) {
   return (void *)(new_header + 1);
 }
 
-void test_free(void *request) {
+static void mem_free(void *request) {
   if (request == NULL) {
     return;
   }
@@ -203,3 +213,23 @@ void test_free(void *request) {
 
   assert(!"header not found in valid regions during free");
 }
+
+void *test_malloc(size_t bytes) {
+  MEM_LOCK();
+  void *p = mem_malloc(bytes);
+  MEM_UNLOCK();
+  return p;
+}
+
+void *test_realloc(void *existing_request, size_t bytes) {
+  MEM_LOCK();
+  void *p = mem_realloc(existing_request, bytes);
+  MEM_UNLOCK();
+  return p;
+}
+
+void test_free(void *request) {
+  MEM_LOCK();
+  mem_free(request);
+  MEM_UNLOCK();
+}
@@ -0,0 +1,156 @@
+/**
+ * Copyright (c) 2014 rxi (https://github.com/rxi/vec)
+ *
+ * v0.3.x modifications (c) 2022 Jacob Repp (https://github.com/jrepp/vec)
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the MIT license. See https://github.com/rxi/vec/LICENSE for details.
+ */
+
+#include "test_help.h"
+
+typedef struct { vec_define_fields_alloc(int) } vec_int_alloc_t;
+
+// Allocator context counting its calls and the bytes it has handed out
+typedef struct {
+  size_t allocs, reallocs, frees, live;
+  int fail;
+} counting_t;
+
+static void *counting_alloc(void *user, size_t bytes) {
+  counting_t *c = user;
+  if (c->fail) return NULL;
+  c->allocs++;
+  c->live += bytes;
+  return malloc(bytes);
+}
+
+static void *counting_realloc(void *user, void *ptr, size_t old_bytes, size_t new_bytes) {
+  counting_t *c = user;
+  void *p;
+  if (c->fail) return NULL;
+  p = realloc(ptr, new_bytes);
+  if (p != NULL) {
+    c->reallocs++;
+    c->live = c->live - old_bytes + new_bytes;
+  }
+  return p;
+}
+
+static void counting_free(void *user, void *ptr, size_t bytes) {
+  counting_t *c = user;
+  c->frees++;
+  c->live -= bytes;
+  free(ptr);
+}
+
+int test_vec_allocator() {
+  { test_section("vec_init_with_allocator");
+    counting_t counts = { 0, 0, 0, 0, 0 };
+    vec_allocator_t a = { counting_alloc, counting_realloc, counting_free, NULL };
+    vec_int_alloc_t v;
+    vec_int_t plain;
+    size_t mallocs = stats_->malloc_count;
+    int ok = 1;
+    a.user = &counts;
+    vec_init_with_allocator(&v, &a);
+    vec_init(&plain);
+    test_assert(v.allocator == &a && v.data == NULL && vec_capacity(&v) == 0);
+    for (int i = 0; i < 1000; ++i) {
+      ok &= VEC_OK == vec_push(&v, i);
+      ok &= VEC_OK == vec_push(&plain, i);
+    }
+    test_assert(ok && counts.allocs == 1 && counts.reallocs > 0);
+    test_assert(counts.live == vec_capacity(&v) * sizeof(int));
+    // only the plain vector went through VEC_MALLOC
+    test_assert(stats_->malloc_count == mallocs + 1);
+    for (vec_size_t i = 0; i < 1000; ++i) ok &= vec_get(&v, i) == (int)i;
+    test_assert(ok);
+    test_assert(VEC_OK == vec_reserve(&v, 5000) && counts.live == 5000 * sizeof(int));
+    test_assert(VEC_OK == vec_compact(&v) && counts.live == 1000 * sizeof(int));
+    vec_clear(&v);
+    test_assert(VEC_OK == vec_compact(&v) && v.data == NULL && counts.live == 0);
+    test_assert(counts.frees == 1 && (v.options & VEC_ALLOCATOR));
+    test_assert(VEC_OK == vec_push(&v, 7) && counts.allocs == 2);
+    vec_deinit(&v);
+    test_assert(counts.frees == 2 && counts.live == 0);
+    test_assert(v.data == NULL && v.options == VEC_DYNAMIC);
+    vec_deinit(&plain);
+  }
+
+  { test_section("vec_allocator_no_realloc");
+    counting_t counts = { 0, 0, 0, 0, 0 };
+    vec_allocator_t a = { counting_alloc, NULL, counting_free, NULL };
+    vec_allocator_t b = { counting_alloc, NULL, counting_free, NULL };
+    vec_int_alloc_t u, v, w;
+    int ok = 1;
+    a.user = &counts;
+    b.user = &counts;
+    vec_init_with_allocator(&v, &a);
+    for (int i = 0; i < 100; ++i) ok &= VEC_OK == vec_push(&v, i);
+    // without realloc every growth is an alloc, copy and free
+    test_assert(ok && counts.reallocs == 0 && counts.allocs == counts.frees + 1);
+    test_assert(counts.live == vec_capacity(&v) * sizeof(int));
+    for (vec_size_t i = 0; i < 100; ++i) ok &= vec_get(&v, i) == (int)i;
+    test_assert(ok);
+    // the allocator of w only changes when the data is handed over
+    vec_init_with_allocator(&w, &b);
+    vec_init_with_allocator(&u, &a);
+    vec_swap_data_alloc(&w, &u);
+    test_assert(w.allocator == &b);
+    vec_swap_data_alloc(&w, &v);
+    test_assert(w.allocator == &a && vec_length(&w) == 100 && v.data == NULL);
+    vec_deinit(&w);
+    test_assert(counts.live == 0 && counts.allocs == counts.frees);
+  }
+
+  { test_section("vec_allocator_swap_plain");
+    counting_t counts = { 0, 0, 0, 0, 0 };
+    vec_allocator_t a = { counting_alloc, counting_realloc, counting_free, NULL };
+    vec_int_alloc_t v;
+    vec_int_t plain;
+    int ok = 1;
+    a.user = &counts;
+    vec_init_with_allocator(&v, &a);
+    vec_init(&plain);
+    for (int i = 0; i < 50; ++i) ok &= VEC_OK == vec_push(&v, i);
+    test_assert(ok);
+    // plain has no allocator field, the elements are copied to VEC_MALLOC memory
+    vec_swap_data(&plain, &v);
+    test_assert(vec_length(&plain) == 50 && (plain.options & VEC_ALLOCATOR) == 0);
+    for (vec_size_t i = 0; i < 50; ++i) ok &= vec_get(&plain, i) == (int)i;
+    test_assert(ok);
+    test_assert(vec_length(&v) == 0 && v.data != NULL && counts.live > 0);
+    vec_deinit(&plain);
+    vec_deinit(&v);
+    test_assert(counts.live == 0);
+  }
+
+  { test_section("vec_allocator_null");
+    vec_int_alloc_t v;
+    test_assert(VEC_ERR == vec_init_with_allocator(&v, NULL));
+    test_assert(VEC_ERR == vec_push(&v, 1) && vec_oom(&v));
+    test_assert(v.data == NULL && vec_length(&v) == 0);
+    vec_deinit(&v);
+  }
+
+  { test_section("vec_allocator_oom");
+    counting_t counts = { 0, 0, 0, 0, 0 };
+    vec_allocator_t a = { counting_alloc, counting_realloc, counting_free, NULL };
+    vec_int_alloc_t v;
+    a.user = &counts;
+    vec_init_with_allocator(&v, &a);
+    counts.fail = 1;
+    test_assert(VEC_ERR == vec_push(&v, 1) && vec_oom(&v));
+    counts.fail = 0;
+    for (int i = 0; i < 8; ++i) vec_push(&v, i);
+    counts.fail = 1;
+    test_assert(VEC_ERR == vec_reserve(&v, 100));
+    counts.fail = 0;
+    test_assert(vec_length(&v) == 8 && vec_last(&v) == 7);
+    vec_deinit(&v);
+    test_assert(counts.live == 0);
+  }
+
+  return 0;
+}
@@ -0,0 +1,114 @@
+/**
+ * Copyright (c) 2014 rxi (https://github.com/rxi/vec)
+ *
+ * v0.3.x modifications (c) 2022 Jacob Repp (https://github.com/jrepp/vec)
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the MIT license. See https://github.com/rxi/vec/LICENSE for details.
+ */
+
+#include "test_help.h"
+
+int test_vec_arena() {
+  { test_section("vec_arena_alloc");
+    vec_arena_t arena;
+    uint8_t *a, *b, *c;
+    vec_arena_init(&arena, 0);
+    test_assert(arena.chunk_size == VEC_ARENA_CHUNK && arena.chunks == NULL);
+    a = vec_arena_alloc(&arena, 3);
+    b = vec_arena_alloc(&arena, 100);
+    test_assert(a != NULL && b != NULL && a != b);
+    test_assert((uintptr_t)a % 16 == 0 && (uintptr_t)b % 16 == 0);
+    memset(a, 1, 3);
+    memset(b, 2, 100);
+    // the last block grows in place, the others move
+    test_assert(vec_arena_realloc(b, 1000) == b);
+    c = vec_arena_realloc(a, 64);
+    test_assert(c != a && c[0] == 1 && c[2] == 1);
+    test_assert(vec_arena_realloc(b, 10) == b && b[9] == 2);
+    // the last block is given back on free
+    vec_arena_free(c);
+    test_assert(vec_arena_alloc(&arena, 8) == c);
+    vec_arena_free(b);
+    vec_arena_reset(&arena);
+    test_assert(arena.chunks != NULL && arena.chunks->next == NULL);
+    test_assert(vec_arena_alloc(&arena, 3) == a);
+    vec_arena_deinit(&arena);
+    test_assert(arena.chunks == NULL);
+  }
+
+  { test_section("vec_init_with_arena");
+    vec_arena_t arena;
+    vec_int_t v, w;
+    int *first;
+    int ok = 1;
+    vec_arena_init(&arena, 0);
+    test_assert(VEC_OK == vec_init_with_arena(&v, &arena));
+    test_assert(vec_length(&v) == 0 && vec_capacity(&v) == 0 && v.data != NULL);
+    first = v.data;
+    // growth extends the block in place, no copies
+    for (int i = 0; i < 1000; ++i) ok &= VEC_OK == vec_push(&v, i);
+    test_assert(ok && v.data == first);
+    // interleaved vectors still work, the one that isn't last is copied
+    test_assert(VEC_OK == vec_init_with_arena(&w, &arena));
+    for (int i = 0; i < 1000; ++i) {
+      ok &= VEC_OK == vec_push(&v, 1000 + i);
+      if (i < 100) ok &= VEC_OK == vec_push(&w, -i);
+    }
+    test_assert(ok && v.data != first);
+    for (int i = 0; i < 2000; ++i) ok &= v.data[i] == i;
+    for (int i = 0; i < 100; ++i) ok &= w.data[i] == -i;
+    test_assert(ok);
+    vec_compact(&w);
+    test_assert(vec_capacity(&w) == 100);
+    vec_clear(&w);
+    vec_compact(&w);
+    test_assert(vec_capacity(&w) == 0 && w.data != NULL);
+    test_assert(VEC_OK == vec_push(&w, 5) && w.data[0] == 5);
+    vec_deinit(&w);
+    test_assert(w.data == NULL && w.options == VEC_DYNAMIC);
+    // everything is released at once
+    vec_arena_reset(&arena);
+    test_assert(VEC_OK == vec_init_with_arena(&v, &arena));
+    test_assert(v.data == first);
+    vec_arena_deinit(&arena);
+  }
+
+  { test_section("vec_arena_chunks");
+    vec_arena_t arena;
+    vec_uint64_t v, w;
+    int ok = 1;
+    vec_arena_init(&arena, 256);
+    vec_init_with_arena(&v, &arena);
+    vec_init_with_arena(&w, &arena);
+    for (uint64_t i = 0; i < 5000; ++i) {
+      ok &= VEC_OK == vec_push(&v, i);
+      ok &= VEC_OK == vec_push(&w, i * 3);
+    }
+    test_assert(ok && arena.chunks->next != NULL);
+    for (vec_size_t i = 0; i < 5000; ++i) ok &= v.data[i] == i && w.data[i] == i * 3;
+    test_assert(ok);
+    vec_arena_reset(&arena);
+    test_assert(arena.chunks->next == NULL);
+    vec_arena_deinit(&arena);
+  }
+
+  { test_section("vec_arena_oom");
+    vec_arena_t arena;
+    vec_int_t v;
+    vec_arena_init(&arena, 128);
+    set_fail_malloc(1);
+    test_assert(VEC_ERR_NO_MEMORY == vec_init_with_arena(&v, &arena));
+    test_assert(VEC_ERR == vec_push(&v, 1) && vec_oom(&v));
+    set_fail_malloc(0);
+    test_assert(VEC_OK == vec_init_with_arena(&v, &arena));
+    for (int i = 0; i < 20; ++i) vec_push(&v, i);
+    set_fail_malloc(1);
+    vec_pusharr(&v, v.data, 20);
+    set_fail_malloc(0);
+    test_assert(vec_oom(&v) && vec_length(&v) == 20 && v.data[19] == 19);
+    vec_arena_deinit(&arena);
+  }
+
+  return 0;
+}
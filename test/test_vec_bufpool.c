@@ -0,0 +1,139 @@
+/**
+ * Copyright (c) 2014 rxi (https://github.com/rxi/vec)
+ *
+ * v0.3.x modifications (c) 2022 Jacob Repp (https://github.com/jrepp/vec)
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the MIT license. See https://github.com/rxi/vec/LICENSE for details.
+ */
+
+#include "test_help.h"
+#include "vec_bufpool.h"
+
+typedef struct { vec_define_fields_alloc(int) } bufpool_int_t;
+typedef struct { vec_define_fields_alloc(double) } bufpool_double_t;
+
+// Push 0 .. n - 1 into a fresh vector of the pool
+static int bufpool_fill(bufpool_int_t *v, vec_bufpool_t *pool, int n) {
+  int ok = 1;
+  vec_init_with_allocator(v, vec_bufpool_allocator(pool));
+  for (int i = 0; i < n; ++i) ok &= VEC_OK == vec_push(v, i);
+  for (vec_size_t i = 0; i < (vec_size_t)n; ++i) ok &= vec_get(v, i) == (int)i;
+  return ok;
+}
+
+int test_vec_bufpool() {
+  { test_section("vec_bufpool_classes");
+    vec_bufpool_t pool;
+    vec_bufpool_init(&pool, sizeof(int));
+    // the classes follow the capacities of a growing vector
+    test_assert(pool.bytes[0] == VEC_INIT_CAPACITY * sizeof(int));
+    test_assert(pool.bytes[1] == VEC_GROW_CAPACITY(VEC_INIT_CAPACITY) * sizeof(int));
+    test_assert(pool.bytes[2] == 50 * sizeof(int));
+    test_assert(vec_bufpool_hits(&pool) == 0 && vec_bufpool_misses(&pool) == 0);
+    vec_bufpool_deinit(&pool);
+    vec_bufpool_init(&pool, 1);
+    test_assert(pool.bytes[0] == sizeof(vec_bufpool_block_t));
+    vec_bufpool_deinit(&pool);
+  }
+
+  { test_section("vec_bufpool_recycle");
+    vec_bufpool_t pool;
+    bufpool_int_t v;
+    size_t mallocs;
+    vec_bufpool_init(&pool, sizeof(int));
+    // 0 -> 8 -> 20 -> 50, each class is taken from VEC_MALLOC once
+    test_assert(bufpool_fill(&v, &pool, 50) && vec_capacity(&v) == 50);
+    test_assert(vec_bufpool_misses(&pool) == 3 && pool.count[0] == 1 && pool.count[1] == 1);
+    vec_deinit(&v);
+    test_assert(pool.count[2] == 1);
+    // the same churn again is served by the free lists
+    mallocs = stats_->malloc_count;
+    for (int r = 0; r < 10; ++r) {
+      test_assert(bufpool_fill(&v, &pool, 50));
+      vec_deinit(&v);
+    }
+    test_assert(stats_->malloc_count == mallocs);
+    test_assert(vec_bufpool_misses(&pool) == 3 && vec_bufpool_hits(&pool) == 30);
+    vec_bufpool_deinit(&pool);
+    test_assert(pool.free[0] == NULL && pool.count[2] == 0);
+  }
+
+  { test_section("vec_bufpool_in_class");
+    vec_bufpool_t pool;
+    bufpool_double_t v;
+    double *data;
+    int ok = 1;
+    vec_bufpool_init(&pool, sizeof(int));
+    // doubles take two units, 8 of them land in the class of 20 units
+    vec_init_with_allocator(&v, vec_bufpool_allocator(&pool));
+    for (int i = 0; i < 8; ++i) ok &= VEC_OK == vec_push(&v, i * 0.5);
+    test_assert(ok && vec_bufpool_misses(&pool) == 1);
+    // resizing within the class keeps the buffer
+    data = v.data;
+    test_assert(VEC_OK == vec_reserve(&v, 10) && v.data == data);
+    vec_pop(&v);
+    test_assert(VEC_OK == vec_compact(&v) && v.data == data && vec_capacity(&v) == 7);
+    test_assert(vec_bufpool_hits(&pool) == 2 && vec_bufpool_misses(&pool) == 1);
+    for (vec_size_t i = 0; i < 7; ++i) ok &= vec_get(&v, i) == i * 0.5;
+    test_assert(ok);
+    vec_deinit(&v);
+    vec_bufpool_deinit(&pool);
+  }
+
+  { test_section("vec_bufpool_large");
+    vec_bufpool_t pool;
+    bufpool_int_t v;
+    vec_bufpool_init(&pool, sizeof(int));
+    // above the last class the buffers come from VEC_MALLOC and aren't kept
+    test_assert(bufpool_fill(&v, &pool, 10000));
+    vec_deinit(&v);
+    test_assert(pool.count[VEC_BUFPOOL_CLASSES - 1] == 1);
+    vec_init_with_allocator(&v, vec_bufpool_allocator(&pool));
+    test_assert(VEC_OK == vec_reserve(&v, 100000));
+    vec_deinit(&v);
+    test_assert(pool.count[VEC_BUFPOOL_CLASSES - 1] == 1);
+    vec_bufpool_deinit(&pool);
+  }
+
+  { test_section("vec_bufpool_depth");
+    vec_bufpool_t pool;
+    bufpool_int_t v[VEC_BUFPOOL_DEPTH + 4];
+    int ok = 1;
+    vec_bufpool_init(&pool, sizeof(int));
+    for (int k = 0; k < VEC_BUFPOOL_DEPTH + 4; ++k) ok &= bufpool_fill(&v[k], &pool, 5);
+    for (int k = 0; k < VEC_BUFPOOL_DEPTH + 4; ++k) vec_deinit(&v[k]);
+    test_assert(ok && pool.count[0] == VEC_BUFPOOL_DEPTH);
+    vec_bufpool_deinit(&pool);
+  }
+
+  { test_section("vec_bufpool_oom");
+    vec_bufpool_t pool;
+    bufpool_int_t v;
+    vec_bufpool_init(&pool, sizeof(int));
+    test_assert(bufpool_fill(&v, &pool, 8));
+    set_fail_malloc(1);
+    test_assert(VEC_ERR == vec_push(&v, 8) && vec_oom(&v));
+    set_fail_malloc(0);
+    test_assert(vec_length(&v) == 8 && vec_last(&v) == 7);
+    vec_deinit(&v);
+    vec_bufpool_deinit(&pool);
+  }
+
+#if defined(VEC_THREAD_LOCAL)
+  { test_section("vec_bufpool_local");
+    vec_bufpool_t *pool = vec_bufpool_local();
+    bufpool_int_t v;
+    test_assert(pool == vec_bufpool_local());
+    test_assert(pool->bytes[0] == VEC_INIT_CAPACITY * VEC_BUFPOOL_UNIT);
+    test_assert(bufpool_fill(&v, pool, 100));
+    vec_deinit(&v);
+    test_assert(bufpool_fill(&v, pool, 100));
+    vec_deinit(&v);
+    test_assert(vec_bufpool_hits(pool) == 4 && vec_bufpool_misses(pool) == 4);
+    vec_bufpool_deinit(pool);
+  }
+#endif
+
+  return 0;
+}
@@ -0,0 +1,174 @@
+/**
+ * Copyright (c) 2014 rxi (https://github.com/rxi/vec)
+ *
+ * v0.3.x modifications (c) 2022 Jacob Repp (https://github.com/jrepp/vec)
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the MIT license. See https://github.com/rxi/vec/LICENSE for details.
+ */
+
+#include "test_help.h"
+#include "vec_concurrent.h"
+#include "vec_par.h"
+
+typedef struct {
+  int key;
+  char name[12];
+} conc_item_t;
+
+typedef struct { vec_define_fields(conc_item_t) } vec_conc_item_t;
+
+VEC_DEFINE_CONCURRENT(conc_item_t, conc_item)
+
+// Every loop index is pushed once, the published prefix is checked while pushing
+typedef struct {
+  vec_uint64_concurrent_t *c;
+  int ok;
+} conc_ctx_t;
+
+static void conc_push(void *ctx_, vec_size_t lo, vec_size_t hi) {
+  conc_ctx_t *ctx = ctx_;
+  for (; lo < hi; ++lo) {
+    vec_size_t n;
+    if (vec_concurrent_push(ctx->c, (uint64_t)lo + 1, vec_uint64) != VEC_OK) {
+      ctx->ok = 0;
+    }
+    // every element below the length is written, none is the zero of an empty slot
+    n = vec_concurrent_length(ctx->c);
+    if (n > 0 && *vec_concurrent_get_ptr(ctx->c, n - 1) == 0) {
+      ctx->ok = 0;
+    }
+  }
+}
+
+static int check_concurrent(vec_size_t n) {
+  vec_uint64_concurrent_t c;
+  vec_uint64_t flat;
+  conc_ctx_t ctx;
+  unsigned char *seen = calloc(n + 1, 1);
+  int ok = seen != NULL;
+  vec_concurrent_init(&c);
+  vec_init(&flat);
+  // the segments are zeroed so a slot read before it is written shows up
+  ok &= VEC_OK == vec_concurrent_reserve(&c, n);
+  for (vec_size_t s = 0; s < VEC_CONCURRENT_SEGMENTS && c.segments[s] != NULL; ++s) {
+    memset(c.segments[s], 0, ((vec_size_t)VEC_CONCURRENT_FIRST << s) * sizeof(uint64_t));
+  }
+  ctx.c = &c;
+  ctx.ok = 1;
+  vec_par_for_(n, 100, conc_push, &ctx);
+  ok &= ctx.ok;
+  ok &= vec_concurrent_length(&c) == n;
+  ok &= VEC_OK == vec_concurrent_flatten(&c, &flat);
+  ok &= flat.length == n;
+  for (vec_size_t i = 0; ok && i < n; ++i) {
+    ok &= flat.data[i] >= 1 && flat.data[i] <= n && seen[flat.data[i]]++ == 0;
+    ok &= flat.data[i] == vec_concurrent_get(&c, i);
+  }
+  vec_deinit(&flat);
+  vec_concurrent_deinit(&c);
+  free(seen);
+  return ok;
+}
+
+int test_vec_concurrent() {
+  { test_section("vec_concurrent_push");
+    vec_int_concurrent_t c;
+    vec_int_t flat;
+    int ok = 1;
+    vec_concurrent_init(&c);
+    vec_init(&flat);
+    test_assert(vec_concurrent_length(&c) == 0);
+    // crosses the first few segment boundaries
+    for (int i = 0; i < 1000; ++i) {
+      ok &= VEC_OK == vec_concurrent_push(&c, i * 3, vec_int);
+    }
+    test_assert(ok);
+    test_assert(vec_concurrent_length(&c) == 1000);
+    for (int i = 0; i < 1000; ++i) ok &= vec_concurrent_get(&c, i) == i * 3;
+    test_assert(ok);
+    test_assert(c.segments[3] != NULL && c.segments[5] == NULL);
+    // flatten appends to what the vector already holds
+    vec_push(&flat, -1);
+    test_assert(VEC_OK == vec_concurrent_flatten(&c, &flat));
+    test_assert(flat.length == 1001 && flat.data[0] == -1);
+    for (int i = 0; i < 1000; ++i) ok &= flat.data[i + 1] == i * 3;
+    test_assert(ok);
+    vec_concurrent_clear(&c);
+    test_assert(vec_concurrent_length(&c) == 0);
+    test_assert(c.segments[0] != NULL);
+    test_assert(VEC_OK == vec_concurrent_push(&c, 7, vec_int));
+    test_assert(vec_concurrent_length(&c) == 1 && vec_concurrent_get(&c, 0) == 7);
+    vec_concurrent_deinit(&c);
+    test_assert(c.segments[0] == NULL && vec_concurrent_length(&c) == 0);
+    vec_deinit(&flat);
+  }
+
+  { test_section("vec_concurrent_segments");
+    test_assert(vec_concurrent_seg_(0) == 0);
+    test_assert(vec_concurrent_seg_(VEC_CONCURRENT_FIRST - 1) == 0);
+    test_assert(vec_concurrent_seg_(VEC_CONCURRENT_FIRST) == 1);
+    test_assert(vec_concurrent_off_(VEC_CONCURRENT_FIRST, 1) == 0);
+    test_assert(vec_concurrent_seg_(3 * VEC_CONCURRENT_FIRST - 1) == 1);
+    test_assert(vec_concurrent_seg_(3 * VEC_CONCURRENT_FIRST) == 2);
+    test_assert(vec_concurrent_off_(7 * VEC_CONCURRENT_FIRST - 1, 2) == 4 * VEC_CONCURRENT_FIRST - 1);
+  }
+
+  { test_section("vec_concurrent_struct");
+    conc_item_concurrent_t c;
+    vec_conc_item_t flat;
+    conc_item_t item;
+    int ok = 1;
+    vec_concurrent_init(&c);
+    vec_init(&flat);
+    memset(&item, 0, sizeof(item));
+    strcpy(item.name, "item");
+    for (int i = 0; i < 300; ++i) {
+      item.key = i;
+      ok &= VEC_OK == conc_item_concurrent_push(&c, item);
+    }
+    test_assert(ok);
+    test_assert(VEC_OK == vec_concurrent_flatten(&c, &flat));
+    for (int i = 0; i < 300; ++i) ok &= flat.data[i].key == i && !strcmp(flat.data[i].name, "item");
+    test_assert(ok);
+    vec_concurrent_deinit(&c);
+    vec_deinit(&flat);
+  }
+
+  { test_section("vec_concurrent_oom");
+    vec_int_concurrent_t c;
+    vec_int_t ints;
+    vec_concurrent_init(&c);
+    vec_init(&ints);
+    set_fail_malloc(1);
+    test_assert(VEC_ERR_NO_MEMORY == vec_concurrent_reserve(&c, 10));
+    test_assert(VEC_ERR == vec_concurrent_push(&c, 1, vec_int));
+    set_fail_malloc(0);
+    // the failed push keeps its index, the failure sticks until the vector is cleared
+    test_assert(vec_concurrent_failed(&c));
+    test_assert(VEC_ERR == vec_concurrent_push(&c, 2, vec_int));
+    test_assert(VEC_ERR == vec_concurrent_reserve(&c, 10));
+    test_assert(vec_concurrent_length(&c) == 0);
+    test_assert(VEC_OK == vec_concurrent_flatten(&c, &ints));
+    test_assert(ints.length == 0);
+    vec_concurrent_clear(&c);
+    test_assert(!vec_concurrent_failed(&c));
+    test_assert(VEC_OK == vec_concurrent_push(&c, 3, vec_int));
+    test_assert(vec_concurrent_length(&c) == 1 && vec_concurrent_get(&c, 0) == 3);
+    vec_concurrent_deinit(&c);
+    vec_deinit(&ints);
+  }
+
+  { test_section("vec_concurrent_threads");
+    test_assert(check_concurrent(5000));
+    vec_par_set_serial_max(1000);
+    if (VEC_OK == vec_par_init(4)) {
+      test_assert(check_concurrent(1001));
+      test_assert(check_concurrent(100000));
+      vec_par_shutdown();
+    }
+    vec_par_set_serial_max(0);
+  }
+
+  return 0;
+}
@@ -0,0 +1,182 @@
+/**
+ * Copyright (c) 2014 rxi (https://github.com/rxi/vec)
+ *
+ * v0.3.x modifications (c) 2022 Jacob Repp (https://github.com/jrepp/vec)
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the MIT license. See https://github.com/rxi/vec/LICENSE for details.
+ */
+
+#include "test_help.h"
+#include "vec_deque.h"
+
+typedef struct { vec_deque_define_fields(int) } deque_int_t;
+
+typedef struct {
+  int id;
+  char name[12];
+} deque_item_t;
+
+typedef struct { vec_deque_define_fields(deque_item_t) } deque_item_vec_t;
+
+// True when the deque holds first, first + 1, ... from the front
+static int deque_holds_run(deque_int_t *d, int first, vec_size_t n) {
+  int ok = vec_deque_length(d) == n;
+  for (vec_size_t i = 0; ok && i < n; ++i) {
+    ok &= vec_deque_get(d, i) == first + (int)i;
+  }
+  return ok;
+}
+
+int test_vec_deque() {
+  { test_section("vec_deque_fifo");
+    deque_int_t d;
+    int ok = 1, next = 0;
+    vec_deque_init(&d);
+    test_assert(vec_deque_length(&d) == 0 && vec_deque_capacity(&d) == 0);
+    for (int i = 0; i < 6; ++i) ok &= VEC_OK == vec_deque_push_back(&d, i);
+    test_assert(ok && vec_deque_capacity(&d) == 8);
+    // cycle through the buffer many times without growing
+    for (int i = 6; i < 1000; ++i) {
+      ok &= vec_deque_pop_front(&d) == next++;
+      ok &= VEC_OK == vec_deque_push_back(&d, i);
+    }
+    test_assert(ok && vec_deque_capacity(&d) == 8);
+    test_assert(deque_holds_run(&d, 994, 6));
+    test_assert(vec_deque_front(&d) == 994 && vec_deque_back(&d) == 999);
+    test_assert(vec_deque_pop_back(&d) == 999);
+    test_assert(vec_deque_back(&d) == 998 && vec_deque_length(&d) == 5);
+    vec_deque_clear(&d);
+    test_assert(vec_deque_length(&d) == 0 && d.head == 0 && vec_deque_capacity(&d) == 8);
+    vec_deque_deinit(&d);
+    test_assert(d.data == NULL && vec_deque_capacity(&d) == 0);
+  }
+
+  { test_section("vec_deque_push_front");
+    deque_int_t d;
+    int ok = 1;
+    vec_deque_init(&d);
+    for (int i = 99; i >= 0; --i) ok &= VEC_OK == vec_deque_push_front(&d, i);
+    test_assert(ok && deque_holds_run(&d, 0, 100));
+    for (int i = 99; i >= 50; --i) ok &= vec_deque_pop_back(&d) == i;
+    test_assert(ok && deque_holds_run(&d, 0, 50));
+    vec_deque_push_front(&d, -1);
+    vec_deque_push_back(&d, 50);
+    test_assert(deque_holds_run(&d, -1, 52));
+    vec_deque_deinit(&d);
+  }
+
+  { test_section("vec_deque_grow_wrapped");
+    deque_int_t d;
+    vec_deque_init(&d);
+    test_assert(VEC_OK == vec_deque_reserve(&d, 8));
+    for (int i = 0; i < 8; ++i) vec_deque_push_back(&d, i);
+    for (int i = 0; i < 5; ++i) (void) vec_deque_pop_front(&d);
+    for (int i = 8; i < 13; ++i) vec_deque_push_back(&d, i);
+    // full and wrapped, the next push grows and unwraps
+    test_assert(vec_deque_length(&d) == 8 && d.head == 5);
+    test_assert(VEC_OK == vec_deque_push_back(&d, 13));
+    test_assert(d.head == 0 && vec_deque_capacity(&d) > 8);
+    test_assert(deque_holds_run(&d, 5, 9));
+    for (vec_size_t i = 0; i < 9; ++i) test_assert(d.data[i] == 5 + (int)i);
+    vec_deque_deinit(&d);
+  }
+
+  { test_section("vec_deque_arr");
+    deque_int_t d;
+    int src[20], dst[20], ok = 1;
+    for (int i = 0; i < 20; ++i) src[i] = i;
+    vec_deque_init(&d);
+    vec_deque_reserve(&d, 16);
+    for (int i = 0; i < 12; ++i) vec_deque_push_back(&d, -1);
+    test_assert(vec_deque_pop_front_arr(&d, dst, 10) == 10);
+    // the tail has 4 free slots before the end of the buffer, the rest wraps
+    test_assert(VEC_OK == vec_deque_push_back_arr(&d, src, 10));
+    test_assert(vec_deque_capacity(&d) == 16 && d.head == 10);
+    test_assert(vec_deque_pop_front_arr(&d, dst, 2) == 2 && dst[0] == -1 && dst[1] == -1);
+    // the elements are split over the end of the buffer
+    test_assert(vec_deque_pop_front_arr(&d, dst, 20) == 10);
+    for (int i = 0; i < 10; ++i) ok &= dst[i] == i;
+    test_assert(ok && vec_deque_length(&d) == 0 && d.head == 0);
+    test_assert(vec_deque_pop_front_arr(&d, dst, 5) == 0);
+    // growing from a wrapped layout keeps the order
+    vec_deque_push_back_arr(&d, src, 12);
+    vec_deque_pop_front_arr(&d, dst, 8);
+    vec_deque_push_back_arr(&d, src + 12, 8);
+    test_assert(VEC_OK == vec_deque_push_back_arr(&d, src, 20));
+    test_assert(vec_deque_length(&d) == 32 && d.head == 0);
+    test_assert(vec_deque_pop_front_arr(&d, dst, 12) == 12);
+    for (int i = 0; i < 12; ++i) ok &= dst[i] == 8 + i;
+    test_assert(ok && deque_holds_run(&d, 0, 20));
+    vec_deque_deinit(&d);
+  }
+
+  { test_section("vec_deque_foreach");
+    deque_int_t d;
+    vec_size_t iter;
+    int x, *p, ok = 1, count = 0;
+    vec_deque_init(&d);
+    vec_deque_foreach(&d, x, iter) {
+      ++count;
+    }
+    test_assert(count == 0);
+    for (int i = 0; i < 8; ++i) vec_deque_push_back(&d, i);
+    for (int i = 0; i < 6; ++i) (void) vec_deque_pop_front(&d);
+    for (int i = 8; i < 12; ++i) vec_deque_push_back(&d, i);
+    vec_deque_foreach(&d, x, iter) {
+      ok &= x == 6 + (int)iter;
+      ++count;
+    }
+    test_assert(ok && count == 6);
+    vec_deque_foreach_ptr(&d, p, iter) {
+      *p *= 2;
+    }
+    test_assert(vec_deque_front(&d) == 12 && vec_deque_back(&d) == 22);
+    vec_deque_deinit(&d);
+  }
+
+  { test_section("vec_deque_fixed");
+    deque_int_t d;
+    int buf[4];
+    vec_deque_init_with_fixed(&d, buf, 4);
+    for (int i = 0; i < 4; ++i) test_assert(VEC_OK == vec_deque_push_front(&d, i));
+    test_assert(VEC_ERR == vec_deque_push_back(&d, 4));
+    test_assert(VEC_ERR_NO_REALLOC == vec_deque_reserve(&d, 5));
+    test_assert(vec_deque_pop_back(&d) == 0 && vec_deque_front(&d) == 3);
+    test_assert(d.data == buf);
+    vec_deque_deinit(&d);
+  }
+
+  { test_section("vec_deque_struct");
+    deque_item_vec_t d;
+    deque_item_t item, out[3];
+    vec_deque_init(&d);
+    memset(&item, 0, sizeof(item));
+    strcpy(item.name, "deque");
+    for (int i = 0; i < 20; ++i) {
+      item.id = i;
+      vec_deque_push_back(&d, item);
+    }
+    test_assert(vec_deque_pop_front(&d).id == 0);
+    test_assert(vec_deque_get_ptr(&d, 1)->id == 2);
+    test_assert(vec_deque_pop_front_arr(&d, out, 3) == 3);
+    test_assert(out[2].id == 3 && !strcmp(out[2].name, "deque"));
+    vec_deque_deinit(&d);
+  }
+
+  { test_section("vec_deque_oom");
+    deque_int_t d;
+    int src[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+    vec_deque_init(&d);
+    vec_deque_push_back(&d, 0);
+    set_fail_malloc(1);
+    test_assert(VEC_ERR_NO_MEMORY == vec_deque_reserve(&d, 100));
+    test_assert(VEC_ERR_NO_MEMORY == vec_deque_push_back_arr(&d, src, 8));
+    test_assert(vec_oom(&d));
+    set_fail_malloc(0);
+    test_assert(vec_deque_length(&d) == 1 && vec_deque_front(&d) == 0);
+    vec_deque_deinit(&d);
+  }
+
+  return 0;
+}
@@ -35,6 +35,27 @@ static int64_t sum_ptr(int64_t out, int64_t *in) {
   return out + *in;
 }
 
+static int is_odd(int64_t value) {
+  return (int)(value & 1);
+}
+
+static int is_multiple(int64_t value, int64_t factor) {
+  return 0 == value % factor;
+}
+
+static int is_odd_ptr(int64_t *value) {
+  return (int)(*value & 1);
+}
+
+typedef struct {
+  int64_t key;
+  char payload[56];
+} wide_t;
+
+static int wide_is_odd(wide_t value) {
+  return (int)(value.key & 1);
+}
+
 static void each(int64_t i) {
   each_action++;
   each_sum += i;
@@ -240,5 +261,88 @@ int test_vec_functional() {
     vec_deinit(&v);
   }
 
+  { test_section("vec_remove_if");
+    vec_int64_t v;
+    vec_init(&v);
+    fill_vec(&v);
+    vec_remove_if(&v, is_odd);
+    test_assert(v.length == count / 2);
+    for (vec_size_t i = 0; i < v.length; ++i) {
+      test_assert(v.data[i] == (int64_t)i * 2);
+    }
+
+    // extra arguments are passed through to the predicate
+    vec_remove_if(&v, is_multiple, 4);
+    test_assert(v.length == count / 4);
+    for (vec_size_t i = 0; i < v.length; ++i) {
+      test_assert(v.data[i] == (int64_t)i * 4 + 2);
+    }
+
+    vec_remove_if_ptr(&v, is_odd_ptr);
+    test_assert(v.length == count / 4);
+
+    vec_clear(&v);
+    vec_remove_if(&v, is_odd);
+    test_assert(v.length == 0);
+    vec_deinit(&v);
+  }
+
+  { test_section("vec_remove_if_wide");
+    VEC_PRE_ALIGN struct { vec_define_fields(wide_t) } VEC_POST_ALIGN v;
+    vec_init(&v);
+    for (int64_t i = 0; i < 100; ++i) {
+      wide_t w;
+      memset(&w, 0, sizeof(w));
+      w.key = i;
+      w.payload[0] = (char)i;
+      test_assert(VEC_OK == vec_push(&v, w));
+    }
+    vec_remove_if(&v, wide_is_odd);
+    test_assert(v.length == 50);
+    for (vec_size_t i = 0; i < v.length; ++i) {
+      test_assert(v.data[i].key == (int64_t)i * 2);
+      test_assert(v.data[i].payload[0] == (char)(i * 2));
+    }
+    vec_deinit(&v);
+  }
+
+  { test_section("vec_remove_if_unstable");
+    vec_int64_t v;
+    int64_t total = 0;
+    vec_init(&v);
+    fill_vec(&v);
+    vec_remove_if_unstable(&v, is_odd);
+    test_assert(v.length == count / 2);
+    for (vec_size_t i = 0; i < v.length; ++i) {
+      test_assert(!is_odd(v.data[i]));
+      total += v.data[i];
+    }
+    // every even value is still present exactly once
+    test_assert(total == (int64_t)(count / 2) * (int64_t)(count / 2 - 1));
+    vec_deinit(&v);
+  }
+
+  { test_section("vec_filter");
+    vec_int64_t v, v2;
+    vec_init(&v);
+    vec_init(&v2);
+    fill_vec(&v);
+    vec_filter(&v2, &v, is_odd);
+    test_assert(v.length == count);
+    test_assert(v2.length == count / 2);
+    for (vec_size_t i = 0; i < v2.length; ++i) {
+      test_assert(v2.data[i] == (int64_t)i * 2 + 1);
+    }
+
+    vec_filter(&v2, &v, is_multiple, 10);
+    test_assert(v2.length == count / 10);
+    test_assert(is_power(&v2));
+
+    vec_filter_ptr(&v2, &v, is_odd_ptr);
+    test_assert(v2.length == count / 2);
+    vec_deinit(&v);
+    vec_deinit(&v2);
+  }
+
   return 0;
 }
@@ -0,0 +1,20 @@
+/**
+ * Copyright (c) 2014 rxi (https://github.com/rxi/vec)
+ *
+ * v0.3.x modifications (c) 2022 Jacob Repp (https://github.com/jrepp/vec)
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the MIT license. See https://github.com/rxi/vec/LICENSE for details.
+ */
+
+// The test suite is linked against this translation unit instead of vec.c, vec_par.c,
+// vec_concurrent.c, vec_seg.c, vec_deque.c, vec_soa.c and vec_bufpool.c to cover the single
+// header build (see VEC_IMPLEMENTATION in vec.h)
+#define VEC_IMPLEMENTATION
+#include "test_help.h"
+#include "vec_par.h"
+#include "vec_concurrent.h"
+#include "vec_seg.h"
+#include "vec_deque.h"
+#include "vec_soa.h"
+#include "vec_bufpool.h"
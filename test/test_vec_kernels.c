@@ -0,0 +1,305 @@
+/**
+ * Copyright (c) 2014 rxi (https://github.com/rxi/vec)
+ *
+ * v0.3.x modifications (c) 2022 Jacob Repp (https://github.com/jrepp/vec)
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the MIT license. See https://github.com/rxi/vec/LICENSE for details.
+ */
+
+#include "test_help.h"
+
+// Byte blobs covering the primitive sizes and a struct size with no SIMD kernel
+#define TEST_DEFINE_BLOB(N)                                                  \
+  typedef struct { uint8_t b[N]; } blob##N##_t;                              \
+  typedef struct { vec_define_fields(blob##N##_t) } vec_blob##N##_t;         \
+                                                                             \
+  static blob##N##_t make_blob##N(size_t i) {                                \
+    blob##N##_t x;                                                           \
+    for (size_t j = 0; j < N; ++j) x.b[j] = (uint8_t)(i * 31 + j);           \
+    return x;                                                                \
+  }                                                                          \
+                                                                             \
+  static int check_reverse##N(size_t n) {                                    \
+    vec_blob##N##_t v;                                                       \
+    int ok = 1;                                                              \
+    vec_init(&v);                                                            \
+    for (size_t i = 0; i < n; ++i) vec_push(&v, make_blob##N(i));            \
+    vec_reverse(&v);                                                         \
+    for (size_t i = 0; i < n; ++i) {                                         \
+      blob##N##_t e = make_blob##N(n - 1 - i);                               \
+      ok &= 0 == memcmp(&v.data[i], &e, N);                                  \
+    }                                                                        \
+    vec_reverse(&v);                                                         \
+    for (size_t i = 0; i < n; ++i) {                                         \
+      blob##N##_t e = make_blob##N(i);                                       \
+      ok &= 0 == memcmp(&v.data[i], &e, N);                                  \
+    }                                                                        \
+    vec_deinit(&v);                                                          \
+    return ok;                                                               \
+  }                                                                          \
+                                                                             \
+  static int check_scan##N(size_t n) {                                       \
+    vec_blob##N##_t v;                                                       \
+    blob##N##_t key;                                                         \
+    vec_size_t idx, count;                                                   \
+    int ok = 1;                                                              \
+    memset(&key, 0xff, sizeof(key));                                         \
+    vec_init(&v);                                                            \
+    for (size_t i = 0; i < n; ++i) vec_push(&v, make_blob##N(i % 8));        \
+    vec_find(&v, key, idx);                                                  \
+    ok &= idx == VEC_NOT_FOUND;                                              \
+    if (n > 0) {                                                             \
+      v.data[n / 3] = key;                                                   \
+      v.data[n - 1] = key;                                                   \
+      vec_find(&v, key, idx);                                                \
+      ok &= idx == n / 3;                                                    \
+      vec_rfind(&v, key, idx);                                               \
+      ok &= idx == n - 1;                                                    \
+      vec_count(&v, key, count);                                             \
+      ok &= count == (n / 3 == n - 1 ? 1u : 2u);                             \
+    }                                                                        \
+    vec_deinit(&v);                                                          \
+    return ok;                                                               \
+  }                                                                          \
+                                                                             \
+  static int check_swap##N(void) {                                           \
+    vec_blob##N##_t v;                                                       \
+    blob##N##_t a = make_blob##N(1), b = make_blob##N(2);                    \
+    int ok;                                                                  \
+    vec_init(&v);                                                            \
+    vec_push(&v, a);                                                         \
+    vec_push(&v, b);                                                         \
+    vec_swap(&v, 0, 1);                                                      \
+    ok = 0 == memcmp(&v.data[0], &b, N) && 0 == memcmp(&v.data[1], &a, N);   \
+    vec_deinit(&v);                                                          \
+    return ok;                                                               \
+  }
+
+// Plant the key at two positions of a key free vector and check every search agrees
+#define TEST_DEFINE_SCAN(name, T)                                            \
+  typedef struct { vec_define_fields(T) } vec_scan_##name##_t;               \
+                                                                             \
+  static int check_scan_##name(size_t n) {                                   \
+    vec_scan_##name##_t v;                                                   \
+    const T key = (T)201;                                                    \
+    vec_size_t idx, count;                                                   \
+    int ok = 1;                                                              \
+    vec_init(&v);                                                            \
+    for (size_t i = 0; i < n; ++i) vec_push(&v, (T)(i % 100));               \
+    vec_find(&v, key, idx);                                                  \
+    ok &= idx == VEC_NOT_FOUND;                                              \
+    vec_rfind(&v, key, idx);                                                 \
+    ok &= idx == VEC_NOT_FOUND;                                              \
+    vec_count(&v, key, count);                                               \
+    ok &= count == 0;                                                        \
+    for (size_t a = 0; a < n; a += 1 + a / 4) {                              \
+      size_t b = a + (n - a) / 2;                                            \
+      v.data[a] = key;                                                       \
+      v.data[b] = key;                                                       \
+      vec_find(&v, key, idx);                                                \
+      ok &= idx == a;                                                        \
+      vec_rfind(&v, key, idx);                                               \
+      ok &= idx == b;                                                        \
+      vec_count(&v, key, count);                                             \
+      ok &= count == (a == b ? 1u : 2u);                                     \
+      v.data[a] = (T)(a % 100);                                              \
+      v.data[b] = (T)(b % 100);                                              \
+    }                                                                        \
+    vec_deinit(&v);                                                          \
+    return ok;                                                               \
+  }
+
+TEST_DEFINE_SCAN(u8, uint8_t)
+TEST_DEFINE_SCAN(u16, uint16_t)
+TEST_DEFINE_SCAN(u32, uint32_t)
+TEST_DEFINE_SCAN(u64, uint64_t)
+TEST_DEFINE_SCAN(f32, float)
+TEST_DEFINE_SCAN(f64, double)
+
+// A struct with padding between its members
+typedef struct {
+  char tag;
+  int value;
+} padded_t;
+
+typedef struct { vec_define_fields(padded_t) } vec_padded_t;
+
+// Enough matches to wrap the byte lane counters of the count kernels
+static int check_count_many(void) {
+  vec_uint8_t v;
+  vec_size_t count;
+  int ok = 1;
+  vec_init(&v);
+  for (size_t i = 0; i < 20011; ++i) vec_push(&v, (uint8_t)(i % 3 ? 7 : 9));
+  vec_count(&v, 7, count);
+  ok &= count == 13340;
+  vec_count(&v, 9, count);
+  ok &= count == 6671;
+  vec_deinit(&v);
+  return ok;
+}
+
+TEST_DEFINE_BLOB(1)
+TEST_DEFINE_BLOB(2)
+TEST_DEFINE_BLOB(4)
+TEST_DEFINE_BLOB(8)
+TEST_DEFINE_BLOB(16)
+TEST_DEFINE_BLOB(40)
+TEST_DEFINE_BLOB(67)
+
+// lengths around the 16 and 32 byte block boundaries of every element size
+static int check_lengths(int (*check)(size_t)) {
+  int ok = 1;
+  for (size_t n = 0; n < 80; ++n) ok &= check(n);
+  ok &= check(1000);
+  ok &= check(1001);
+  return ok;
+}
+
+int test_vec_kernels() {
+  int detected = vec_simd_level();
+  for (int level = VEC_SIMD_NONE; level <= detected; ++level) {
+    test_section("vec_reverse_simd_level");
+    test_assert(vec_simd_set_level(level) == level);
+    test_assert(check_lengths(check_reverse1));
+    test_assert(check_lengths(check_reverse2));
+    test_assert(check_lengths(check_reverse4));
+    test_assert(check_lengths(check_reverse8));
+    test_assert(check_lengths(check_reverse16));
+    test_assert(check_lengths(check_reverse40));
+    test_assert(check_lengths(check_reverse67));
+  }
+  for (int level = VEC_SIMD_NONE; level <= detected; ++level) {
+    test_section("vec_find_simd_level");
+    test_assert(vec_simd_set_level(level) == level);
+    test_assert(check_lengths(check_scan_u8));
+    test_assert(check_lengths(check_scan_u16));
+    test_assert(check_lengths(check_scan_u32));
+    test_assert(check_lengths(check_scan_u64));
+    test_assert(check_lengths(check_scan_f32));
+    test_assert(check_lengths(check_scan_f64));
+    test_assert(check_lengths(check_scan1));
+    test_assert(check_lengths(check_scan2));
+    test_assert(check_lengths(check_scan4));
+    test_assert(check_lengths(check_scan8));
+    test_assert(check_lengths(check_scan16));
+    test_assert(check_lengths(check_scan40));
+    test_assert(check_lengths(check_scan67));
+    test_assert(check_count_many());
+  }
+  test_assert(vec_simd_set_level(VEC_SIMD_AVX2) == detected);
+
+  { test_section("vec_find_float_equality");
+    vec_double_t v;
+    vec_size_t idx;
+    vec_init(&v);
+    for (int i = 0; i < 100; ++i) vec_push(&v, 1.0);
+    v.data[70] = 0.0 / 0.0;
+    v.data[90] = -0.0;
+    // `==` semantics, NaN never matches and -0.0 matches 0.0
+    vec_find(&v, v.data[70], idx);
+    test_assert(idx == VEC_NOT_FOUND);
+    vec_find(&v, 0.0, idx);
+    test_assert(idx == 90);
+    vec_deinit(&v);
+  }
+
+  { test_section("vec_find_pointer");
+    int values[64];
+    vec_void_t v;
+    vec_size_t idx, count;
+    vec_init(&v);
+    for (int i = 0; i < 64; ++i) vec_push(&v, &values[i]);
+    vec_find(&v, &values[37], idx);
+    test_assert(idx == 37);
+    vec_rfind(&v, &values[3], idx);
+    test_assert(idx == 3);
+    vec_count(&v, &values[63], count);
+    test_assert(count == 1);
+    vec_deinit(&v);
+  }
+
+  { test_section("vec_find_key_conversion");
+    vec_uint8_t bytes;
+    vec_uint32_t words;
+    vec_float_t floats;
+    vec_int_t ints;
+    vec_size_t idx, count;
+    vec_init(&bytes);
+    vec_init(&words);
+    vec_init(&floats);
+    vec_init(&ints);
+    for (int i = 0; i < 100; ++i) {
+      vec_push(&bytes, (uint8_t)(i % 2 ? 7 : 255));
+      vec_push(&words, (uint32_t)(i == 60 ? 0xffffffffu : 1u));
+      vec_push(&floats, i == 40 ? 0.1f : 0.5f);
+      vec_push(&ints, 2);
+    }
+    // a key the element type can't hold equals no element, as with `==`
+    vec_find(&bytes, 263, idx);
+    test_assert(idx == VEC_NOT_FOUND);
+    vec_rfind(&bytes, -1, idx);
+    test_assert(idx == VEC_NOT_FOUND);
+    vec_count(&bytes, 263, count);
+    test_assert(count == 0);
+    vec_count(&bytes, 7, count);
+    test_assert(count == 50);
+    vec_find(&floats, 0.1, idx);
+    test_assert(idx == VEC_NOT_FOUND);
+    vec_find(&floats, 0.1f, idx);
+    test_assert(idx == 40);
+    vec_count(&floats, 0.5, count);
+    test_assert(count == 99);
+    vec_find(&ints, 2.5, idx);
+    test_assert(idx == VEC_NOT_FOUND);
+    vec_find(&ints, 2.0, idx);
+    test_assert(idx == 0);
+    // the usual conversions still apply, -1 compares equal to the largest uint32_t
+    vec_find(&words, -1, idx);
+    test_assert(idx == 60);
+    vec_deinit(&bytes);
+    vec_deinit(&words);
+    vec_deinit(&floats);
+    vec_deinit(&ints);
+  }
+
+  { test_section("vec_find_struct_padding");
+    vec_padded_t v;
+    padded_t item;
+    vec_size_t idx, count;
+    vec_init(&v);
+    // struct elements compare byte for byte, zeroed items have matching padding
+    for (int i = 0; i < 50; ++i) {
+      memset(&item, 0, sizeof(item));
+      item.tag = (char)('a' + i % 5);
+      item.value = i % 5;
+      vec_push(&v, item);
+    }
+    memset(&item, 0, sizeof(item));
+    item.tag = 'c';
+    item.value = 2;
+    vec_find(&v, item, idx);
+    test_assert(idx == 2);
+    vec_rfind(&v, item, idx);
+    test_assert(idx == 47);
+    vec_count(&v, item, count);
+    test_assert(count == 10);
+    item.value = 3;
+    vec_find(&v, item, idx);
+    test_assert(idx == VEC_NOT_FOUND);
+    vec_deinit(&v);
+  }
+
+  { test_section("vec_swap_sizes");
+    test_assert(check_swap1());
+    test_assert(check_swap2());
+    test_assert(check_swap4());
+    test_assert(check_swap8());
+    test_assert(check_swap16());
+    test_assert(check_swap40());
+    test_assert(check_swap67());
+  }
+
+  return 0;
+}
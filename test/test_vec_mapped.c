@@ -0,0 +1,79 @@
+/**
+ * Copyright (c) 2014 rxi (https://github.com/rxi/vec)
+ *
+ * v0.3.x modifications (c) 2022 Jacob Repp (https://github.com/jrepp/vec)
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the MIT license. See https://github.com/rxi/vec/LICENSE for details.
+ */
+
+#include "test_help.h"
+
+#if !defined(VEC_NO_MMAP) && (defined(__unix__) || defined(__APPLE__))
+#define TEST_MAPPED(v) (((v)->options & VEC_MAPPED_DATA) != 0)
+#else
+#define TEST_MAPPED(v) 1
+#endif
+
+// True when the vector holds 0 .. n - 1
+static int mapped_holds(const vec_int_t *v, vec_size_t n) {
+  int ok = vec_length(v) == n;
+  for (vec_size_t i = 0; ok && i < n; ++i) ok &= vec_get(v, i) == (int)i;
+  return ok;
+}
+
+int test_vec_mapped() {
+  { test_section("vec_map_threshold");
+    test_assert(vec_map_threshold() == VEC_MAP_THRESHOLD);
+    vec_map_set_threshold(4096);
+    test_assert(vec_map_threshold() == 4096);
+    vec_map_set_threshold(0);
+    test_assert(vec_map_threshold() == VEC_MAP_THRESHOLD);
+  }
+
+  { test_section("vec_init_mapped");
+    vec_int_t v;
+    int ok = 1;
+    vec_map_set_threshold(64 * 1024);
+    vec_init_mapped(&v);
+    test_assert(v.data == NULL && (v.options & VEC_MAPPED) && !(v.options & VEC_MAPPED_DATA));
+    for (int i = 0; i < 1000; ++i) ok &= VEC_OK == vec_push(&v, i);
+    // below the threshold the elements are on VEC_MALLOC
+    test_assert(ok && !(v.options & VEC_MAPPED_DATA));
+    for (int i = 1000; i < 200000; ++i) ok &= VEC_OK == vec_push(&v, i);
+    test_assert(ok && TEST_MAPPED(&v) && mapped_holds(&v, 200000));
+    test_assert(VEC_OK == vec_reserve(&v, 1000000) && mapped_holds(&v, 200000));
+    // compacting shrinks the mapping
+    test_assert(VEC_OK == vec_compact(&v) && vec_capacity(&v) == 200000);
+    test_assert(TEST_MAPPED(&v) && mapped_holds(&v, 200000));
+    // and below the threshold the elements go back to VEC_MALLOC
+    vec_truncate(&v, 100);
+    test_assert(VEC_OK == vec_compact(&v) && !(v.options & VEC_MAPPED_DATA));
+    test_assert(mapped_holds(&v, 100));
+    vec_deinit(&v);
+    test_assert(v.data == NULL && v.options == VEC_DYNAMIC);
+    vec_map_set_threshold(0);
+  }
+
+  { test_section("vec_mapped_release");
+    vec_int_t v, w;
+    vec_map_set_threshold(64 * 1024);
+    vec_init_mapped(&v);
+    vec_init(&w);
+    test_assert(VEC_OK == vec_reserve(&v, 100000) && TEST_MAPPED(&v));
+    for (int i = 0; i < 100000; ++i) vec_push(&v, i);
+    // the mapping moves with the data
+    vec_swap_data(&w, &v);
+    test_assert(TEST_MAPPED(&w) && mapped_holds(&w, 100000));
+    vec_clear(&w);
+    test_assert(VEC_OK == vec_compact(&w) && w.data == NULL && !(w.options & VEC_MAPPED_DATA));
+    test_assert(VEC_OK == vec_push(&w, 0) && mapped_holds(&w, 1));
+    vec_deinit(&w);
+    vec_init_mapped(&v);
+    test_assert(VEC_OK == vec_reserve(&v, 100000));
+    vec_deinit(&v);
+    vec_map_set_threshold(0);
+  }
+
+  return 0;
+}
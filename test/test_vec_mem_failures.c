@@ -160,6 +160,27 @@ int test_vec_mem_failures() {
     vec_deinit(&v);
   }
 
+  { test_section("vec_insertarr_failure");
+    vec_int_t v;
+    vec_init(&v);
+    int values[] = {1, 2, 3, 4, 5, 6, 7, 8};
+    set_fail_malloc(1);
+    vec_insertarr(&v, 0, values, vec_countof(values));
+    test_assert(vec_oom(&v));
+    test_assert(vec_empty(&v));
+    v.options &= ~VEC_OOM;
+    set_fail_malloc(0);
+    vec_insertarr(&v, 0, values, vec_countof(values));
+    test_assert(!vec_oom(&v));
+    set_fail_realloc(1);
+    vec_insertarr(&v, 4, values, vec_countof(values));
+    set_fail_realloc(0);
+    test_assert(vec_oom(&v));
+    test_assert(vec_length(&v) == vec_countof(values));
+    test_assert(v.data[4] == 5);
+    vec_deinit(&v);
+  }
+
   { test_section("vec_compact_failure");
     test_assert(stats_->memory == 0);
     vec_int_t v;
@@ -216,5 +237,19 @@ int test_vec_mem_failures() {
     test_assert(stats_->free_count == stats.free_count + 1);
     test_assert(stats_->malloc_count == stats.malloc_count + 1);
   }
+  { test_section("vec_sort_radix_malloc_failure");
+    vec_int_t v;
+    vec_init(&v);
+    for (int i = 0; i < 100; ++i) vec_push(&v, 100 - i);
+    vec_compact(&v);
+    set_fail_malloc(1);
+    test_assert(VEC_ERR_NO_MEMORY == vec_sort_radix(&v));
+    test_assert(v.data[0] == 100 && v.data[99] == 1);
+    set_fail_malloc(0);
+    test_assert(VEC_OK == vec_sort_radix(&v));
+    test_assert(v.data[0] == 1 && v.data[99] == 100);
+    vec_deinit(&v);
+  }
+
   return 0;
 }
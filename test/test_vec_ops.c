@@ -50,6 +50,62 @@ int test_vec_ops() {
     vec_deinit(&v);
   }
 
+  { test_section("vec_splice_indices");
+    vec_int_t v;
+    vec_init(&v);
+    int i;
+    for (i = 0; i < 100; i++) vec_push(&v, i);
+    vec_size_t none[1] = { 0 };
+    vec_splice_indices(&v, none, 0);
+    test_assert(v.length == 100);
+
+    // every third element, a duplicate and an index past the end are tolerated
+    vec_size_t idx[40];
+    vec_size_t n = 0;
+    for (i = 0; i < 100; i += 3) idx[n++] = (vec_size_t)i;
+    idx[n++] = 99;
+    idx[n++] = 99;
+    idx[n++] = 1000;
+    vec_splice_indices(&v, idx, n);
+    test_assert(v.length == 100 - 34);
+    for (i = 0; i < (int)v.length; i++) {
+      test_assert(v.data[i] % 3 != 0);
+    }
+    test_assert(v.data[0] == 1 && v.data[1] == 2 && v.data[2] == 4);
+    test_assert(v.data[v.length - 1] == 98);
+
+    // the last and first elements
+    vec_size_t ends[2] = { 0, 0 };
+    ends[1] = v.length - 1;
+    vec_splice_indices(&v, ends, 2);
+    test_assert(v.length == 64);
+    test_assert(v.data[0] == 2 && v.data[v.length - 1] == 97);
+    vec_deinit(&v);
+  }
+
+  { test_section("vec_splice_ranges");
+    vec_int_t v;
+    vec_init(&v);
+    int i;
+    for (i = 0; i < 100; i++) vec_push(&v, i);
+    // [0, 10), [15, 20) overlapping [18, 25), an empty span and a span clamped to the end
+    vec_range_t ranges[] = { { 0, 10 }, { 15, 5 }, { 18, 7 }, { 50, 0 }, { 90, 1000 } };
+    vec_splice_ranges(&v, ranges, vec_countof(ranges));
+    test_assert(v.length == 100 - 10 - 10 - 10);
+    test_assert(v.data[0] == 10);
+    test_assert(v.data[4] == 14);
+    test_assert(v.data[5] == 25);
+    test_assert(v.data[v.length - 1] == 89);
+    for (i = 1; i < (int)v.length; i++) {
+      test_assert(v.data[i - 1] < v.data[i]);
+    }
+
+    vec_range_t all[] = { { 0, 1000 } };
+    vec_splice_ranges(&v, all, 1);
+    test_assert(v.length == 0);
+    vec_deinit(&v);
+  }
+
   { test_section("vec_swapsplice");
     vec_int_t v;
     vec_init(&v);
@@ -77,6 +133,10 @@ int test_vec_ops() {
     test_assert(vec_insert(&v, 10, 123) == 0);
     vec_insert(&v, v.length, 789);
     test_assert(v.data[v.length - 1] == 789);
+    // idx is evaluated once
+    i = 5;
+    vec_insert(&v, i++, 456);
+    test_assert(i == 6 && v.data[5] == 456 && v.data[6] == 994);
     vec_deinit(&v);
   }
 
@@ -237,6 +297,60 @@ int test_vec_ops() {
     vec_deinit(&v2);
   }
 
+  { test_section("vec_extend_self");
+    vec_int_t v;
+    vec_init(&v);
+    for (int i = 0; i < 8; i++) vec_push(&v, i);
+    vec_extend(&v, &v);
+    test_assert(v.length == 16);
+    test_assert(v.data[7] == 7 && v.data[8] == 0 && v.data[15] == 7);
+    vec_deinit(&v);
+  }
+
+  { test_section("vec_pusharr_bulk");
+    int a[1000];
+    vec_int_t v;
+    vec_init(&v);
+    for (int i = 0; i < 1000; i++) a[i] = i * 3;
+    vec_pusharr(&v, a, 0);
+    test_assert(v.length == 0);
+    for (int i = 0; i < 10; i++) vec_pusharr(&v, a, 1000);
+    test_assert(v.length == 10000);
+    test_assert(v.data[0] == 0 && v.data[999] == 999 * 3);
+    test_assert(v.data[9000] == 0 && v.data[9999] == 999 * 3);
+    test_assert(!vec_oom(&v));
+    vec_deinit(&v);
+  }
+
+  { test_section("vec_insertarr");
+    int a[5] = { 5, 6, 7, 8, 9 };
+    vec_int_t v;
+    vec_init(&v);
+    vec_insertarr(&v, 0, a, 5);
+    test_assert(v.length == 5 && v.data[0] == 5 && v.data[4] == 9);
+    vec_insertarr(&v, 2, a, 2);
+    test_assert(v.length == 7);
+    test_assert(v.data[0] == 5 && v.data[1] == 6 && v.data[2] == 5 &&
+                v.data[3] == 6 && v.data[4] == 7 && v.data[6] == 9);
+    vec_insertarr(&v, v.length, a, 1);
+    test_assert(v.length == 8 && vec_last(&v) == 5);
+    vec_insertarr(&v, 3, a, 0);
+    test_assert(v.length == 8 && v.data[3] == 6);
+    vec_deinit(&v);
+  }
+
+  { test_section("vec_insertarr_convert");
+    int a[3] = { 1, 2, 3 };
+    vec_double_t v;
+    vec_init(&v);
+    vec_push(&v, 0.5);
+    vec_push(&v, 4.5);
+    vec_insertarr(&v, 1, a, 3);
+    test_assert(v.length == 5);
+    test_assert(v.data[0] == 0.5 && v.data[1] == 1.0 && v.data[3] == 3.0 && v.data[4] == 4.5);
+    vec_deinit(&v);
+  }
+
   { test_section("vec_find");
     vec_int_t v;
     vec_init(&v);
@@ -269,6 +383,20 @@ int test_vec_ops() {
     vec_deinit(&v);
   }
 
+  { test_section("vec_count");
+    vec_int_t v;
+    vec_init(&v);
+    size_t i, n;
+    for (i = 0; i < 100; i++) vec_push(&v, (int)(i % 26));
+    vec_count(&v, 3, n);
+    test_assert(n == 4);
+    vec_count(&v, 25, n);
+    test_assert(n == 3);
+    vec_count(&v, -1, n);
+    test_assert(n == 0);
+    vec_deinit(&v);
+  }
+
   { test_section("vec_remove");
     vec_int_t v;
     vec_init(&v);
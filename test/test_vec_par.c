@@ -0,0 +1,296 @@
+/**
+ * Copyright (c) 2014 rxi (https://github.com/rxi/vec)
+ *
+ * v0.3.x modifications (c) 2022 Jacob Repp (https://github.com/jrepp/vec)
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the MIT license. See https://github.com/rxi/vec/LICENSE for details.
+ */
+
+#include "test_help.h"
+#include "vec_par.h"
+
+static int par_square(int x) {
+  return x * x;
+}
+
+static uint64_t par_add(uint64_t a, uint64_t b) {
+  return a + b;
+}
+
+// associative but not commutative, the fold must combine in order
+static int par_last(int a, int b) {
+  (void) a;
+  return b;
+}
+
+static void par_bump(int *x, void *arg) {
+  *x += *(const int *)arg;
+}
+
+static void par_see(uint64_t x, void *arg) {
+  ((unsigned char *)arg)[x]++;
+}
+
+// Elements past the first few thousand cost far more than the rest
+static void par_uneven(uint64_t *x, void *arg) {
+  uint64_t spins = *x < 2000 ? 1 : 200, h = *x;
+  (void) arg;
+  while (spins--) {
+    h = h * 6364136223846793005ull + 1442695040888963407ull;
+  }
+  *x = h;
+}
+
+// Count the visits of each index, every index must be visited once
+static void par_mark(void *ctx, vec_size_t lo, vec_size_t hi) {
+  unsigned char *seen = ctx;
+  for (; lo < hi; ++lo) {
+    seen[lo]++;
+  }
+}
+
+// A loop started from inside a loop body runs serially on that thread
+static void par_nested(void *ctx, vec_size_t lo, vec_size_t hi) {
+  unsigned char *seen = ctx;
+  vec_par_for(hi - lo, par_mark, seen + lo);
+}
+
+static int check_par(vec_size_t n) {
+  vec_int_t v, squares;
+  vec_uint64_t w;
+  unsigned char *seen = malloc(n + 1);
+  uint64_t sum = 0;
+  int bump = 3, ok = seen != NULL;
+  vec_init(&v);
+  vec_init(&squares);
+  vec_init(&w);
+  for (vec_size_t i = 0; i < n; ++i) {
+    vec_push(&v, (int)(i % 1000));
+    vec_push(&w, (uint64_t)i);
+    sum += i;
+  }
+
+  ok &= VEC_OK == vec_par_map(&squares, &v, par_square, vec_int);
+  ok &= squares.length == n;
+  for (vec_size_t i = 0; i < n; ++i) ok &= squares.data[i] == (int)(i % 1000) * (int)(i % 1000);
+
+  ok &= vec_par_fold(&w, 7, par_add, vec_uint64) == sum + 7;
+  ok &= vec_par_fold(&v, -1, par_last, vec_int) == (n ? v.data[n - 1] : -1);
+
+  vec_par_each_ptr(&v, par_bump, &bump, vec_int);
+  for (vec_size_t i = 0; i < n; ++i) ok &= v.data[i] == (int)(i % 1000) + 3;
+
+  if (seen != NULL) {
+    memset(seen, 0, n + 1);
+    vec_par_each(&w, par_see, seen, vec_uint64);
+    for (vec_size_t i = 0; i < n; ++i) ok &= seen[i] == 1;
+    memset(seen, 0, n + 1);
+    vec_par_for(n, par_mark, seen);
+    for (vec_size_t i = 0; i < n; ++i) ok &= seen[i] == 1;
+    memset(seen, 0, n + 1);
+    vec_par_for(n, par_nested, seen);
+    for (vec_size_t i = 0; i < n; ++i) ok &= seen[i] == 1;
+    ok &= seen[n] == 0;
+  }
+
+  vec_deinit(&v);
+  vec_deinit(&squares);
+  vec_deinit(&w);
+  free(seen);
+  return ok;
+}
+
+static uint64_t par_rand(uint64_t *state) {
+  uint64_t x = *state;
+  x ^= x >> 12;
+  x ^= x << 25;
+  x ^= x >> 27;
+  *state = x;
+  return x * 0x2545f4914f6cdd1dull;
+}
+
+typedef struct {
+  int key;
+  vec_size_t seq;
+} par_item_t;
+
+typedef struct { vec_define_fields(par_item_t) } vec_par_item_t;
+
+VEC_DEFINE_PAR_SORT(par_item, par_item_t, a->key < b->key)
+VEC_DEFINE_PAR_SORT(par_int, int, *a < *b)
+
+// Compares the key only, the sequence numbers check the order of equal keys is kept
+static int cmp_par_item(const void *a_, const void *b_) {
+  const par_item_t *a = a_, *b = b_;
+  return a->key < b->key ? -1 : a->key > b->key;
+}
+
+static int cmp_par_int(const void *a_, const void *b_) {
+  int a = *(const int *)a_, b = *(const int *)b_;
+  return a < b ? -1 : a > b;
+}
+
+static int check_par_sorted(const vec_par_item_t *v, vec_size_t n) {
+  unsigned char *seen = calloc(n + 1, 1);
+  int ok = seen != NULL && v->length == n;
+  for (vec_size_t i = 0; ok && i < n; ++i) {
+    ok &= v->data[i].seq < n && seen[v->data[i].seq]++ == 0;
+    if (i > 0) {
+      const par_item_t *a = &v->data[i - 1], *b = &v->data[i];
+      ok &= a->key < b->key || (a->key == b->key && a->seq < b->seq);
+    }
+  }
+  free(seen);
+  return ok;
+}
+
+// Sort `n` items with `m` distinct keys both ways and `n` ints against qsort
+static int check_par_sort(vec_size_t n, int m) {
+  vec_par_item_t items, typed;
+  vec_int_t v, expect;
+  uint64_t seed = 0x9e3779b97f4a7c15ull + n;
+  int ok = 1;
+  vec_init(&items);
+  vec_init(&typed);
+  vec_init(&v);
+  vec_init(&expect);
+  for (vec_size_t i = 0; i < n; ++i) {
+    par_item_t item;
+    // every third length is sorted in reverse to merge runs that are already in order
+    item.key = n % 3 == 0 ? (int)(n - i) / m : (int)(par_rand(&seed) % (uint64_t)m);
+    item.seq = i;
+    vec_push(&items, item);
+    vec_push(&typed, item);
+    vec_push(&v, (int)par_rand(&seed));
+  }
+  vec_extend(&expect, &v);
+  if (n > 0) {
+    vec_sort(&expect, cmp_par_int);
+  }
+  ok &= VEC_OK == vec_par_sort(&items, cmp_par_item);
+  ok &= check_par_sorted(&items, n);
+  ok &= VEC_OK == vec_par_sort_inline(&typed, par_item);
+  ok &= check_par_sorted(&typed, n);
+  ok &= VEC_OK == vec_par_sort_inline(&v, par_int);
+  for (vec_size_t i = 0; i < n; ++i) ok &= v.data[i] == expect.data[i];
+  vec_deinit(&items);
+  vec_deinit(&typed);
+  vec_deinit(&v);
+  vec_deinit(&expect);
+  return ok;
+}
+
+// Run the uneven loop and check the element results and the scheduler counters
+static int check_par_stats(vec_size_t n) {
+  vec_uint64_t v;
+  vec_par_stats_t stats[8];
+  uint64_t tasks = 0, steals = 0;
+  int threads, ok = 1;
+  vec_init(&v);
+  for (vec_size_t i = 0; i < n; ++i) {
+    vec_push(&v, (uint64_t)i);
+  }
+  vec_par_stats_reset();
+  vec_par_each_ptr(&v, par_uneven, NULL, vec_uint64);
+  threads = vec_par_stats(stats, 8);
+  for (int i = 0; i < threads && i < 8; ++i) {
+    tasks += stats[i].tasks;
+    steals += stats[i].steals;
+  }
+  // every range run is at most a grain and every steal is run
+  ok &= threads == 0 || tasks >= (n + vec_par_grain() - 1) / vec_par_grain();
+  ok &= steals <= tasks;
+  for (vec_size_t i = 0; i < n; ++i) {
+    uint64_t h = i, spins = i < 2000 ? 1 : 200;
+    while (spins--) h = h * 6364136223846793005ull + 1442695040888963407ull;
+    ok &= v.data[i] == h;
+  }
+  vec_deinit(&v);
+  return ok;
+}
+
+int test_vec_par() {
+  { test_section("vec_par_serial");
+    // without a pool every loop runs on the caller
+    test_assert(vec_par_threads() == 1);
+    test_assert(check_par(0));
+    test_assert(check_par(1));
+    test_assert(check_par(100000));
+    test_assert(vec_par_stats(NULL, 0) == 0);
+    test_assert(check_par_sort(0, 1));
+    test_assert(check_par_sort(1, 1));
+    test_assert(check_par_sort(1000, 10));
+    test_assert(check_par_sort(40000, 100));
+  }
+
+  { test_section("vec_par_pool");
+    vec_par_set_grain(1000);
+    vec_par_set_serial_max(5000);
+    test_assert(vec_par_grain() == 1000);
+    if (VEC_OK == vec_par_init(4)) {
+      test_assert(vec_par_threads() == 4);
+      test_assert(VEC_ERR == vec_par_init(2));
+      test_assert(check_par(10));
+      test_assert(check_par(5001));
+      test_assert(check_par(123457));
+      vec_par_shutdown();
+      test_assert(vec_par_threads() == 1);
+    }
+    vec_par_set_grain(0);
+    vec_par_set_serial_max(0);
+    test_assert(vec_par_grain() == VEC_PAR_GRAIN);
+  }
+
+  { test_section("vec_par_stats");
+    vec_par_stats_t stats[4];
+    vec_par_set_grain(100);
+    vec_par_set_serial_max(1000);
+    if (VEC_OK == vec_par_init(4)) {
+      test_assert(vec_par_stats(stats, 4) == 4);
+      test_assert(check_par_stats(50000));
+      // a short loop runs serially and isn't counted
+      vec_par_stats_reset();
+      test_assert(check_par(1000));
+      test_assert(vec_par_stats(stats, 4) == 4);
+      for (int i = 0; i < 4; ++i) {
+        test_assert(stats[i].tasks == 0 && stats[i].steals == 0 && stats[i].idle_ns == 0);
+      }
+      vec_par_shutdown();
+    }
+    test_assert(check_par_stats(5000));
+    vec_par_set_grain(0);
+    vec_par_set_serial_max(0);
+    test_assert(vec_par_grain() == VEC_PAR_GRAIN);
+  }
+
+  { test_section("vec_par_sort");
+    vec_par_set_grain(100);
+    vec_par_set_serial_max(1000);
+    if (VEC_OK == vec_par_init(4)) {
+      test_assert(check_par_sort(2, 1));
+      test_assert(check_par_sort(1001, 3));
+      test_assert(check_par_sort(1700, 1000));
+      test_assert(check_par_sort(65537, 50));
+      test_assert(check_par_sort(100000, 1 << 20));
+      test_assert(check_par_sort(99999, 7));
+      vec_par_shutdown();
+    }
+    vec_par_set_grain(0);
+    vec_par_set_serial_max(0);
+  }
+
+  { test_section("vec_par_restart");
+    // the pool can be started again after a shutdown
+    if (VEC_OK == vec_par_init(0)) {
+      test_assert(vec_par_threads() >= 1);
+      test_assert(check_par(100000));
+      vec_par_shutdown();
+    }
+    vec_par_shutdown();
+    test_assert(vec_par_threads() == 1);
+    test_assert(check_par(1000));
+  }
+
+  return 0;
+}
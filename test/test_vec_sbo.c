@@ -0,0 +1,127 @@
+/**
+ * Copyright (c) 2014 rxi (https://github.com/rxi/vec)
+ *
+ * v0.3.x modifications (c) 2022 Jacob Repp (https://github.com/jrepp/vec)
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the MIT license. See https://github.com/rxi/vec/LICENSE for details.
+ */
+
+#include "test_help.h"
+
+typedef struct { vec_define_fields_sbo(int, 8) } vec_int_sbo_t;
+
+typedef struct {
+  short id;
+  char tag[3];
+} sbo_item_t;
+
+typedef struct { vec_define_fields_sbo(sbo_item_t, 2) } vec_item_sbo_t;
+
+int test_vec_sbo() {
+  { test_section("vec_init_sbo");
+    vec_int_sbo_t v;
+    size_t mallocs = stats_->malloc_count;
+    int ok = 1;
+    vec_init_sbo(&v);
+    test_assert(v.data == v.sbo && vec_capacity(&v) == 8 && vec_length(&v) == 0);
+    for (int i = 0; i < 8; ++i) ok &= VEC_OK == vec_push(&v, i);
+    test_assert(ok && v.data == v.sbo && stats_->malloc_count == mallocs);
+    vec_insert(&v, 0, -1);
+    // the ninth element moves the vector to the heap
+    test_assert(v.data != v.sbo && stats_->malloc_count == mallocs + 1);
+    test_assert((v.options & VEC_OWNS_MEMORY) && !(v.options & VEC_SBO));
+    for (vec_size_t i = 0; i < 9; ++i) ok &= vec_get(&v, i) == (int)i - 1;
+    test_assert(ok);
+    for (int i = 8; i < 100; ++i) ok &= VEC_OK == vec_push(&v, i);
+    test_assert(ok && vec_last(&v) == 99);
+    vec_deinit_sbo(&v);
+    test_assert(v.data == v.sbo && vec_capacity(&v) == 8 && (v.options & VEC_SBO));
+    test_assert(stats_->free_count >= 1);
+    vec_push(&v, 5);
+    test_assert(v.data == v.sbo && v.sbo[0] == 5);
+    vec_deinit(&v);
+    test_assert(v.data == NULL && v.options == VEC_DYNAMIC);
+  }
+
+  { test_section("vec_sbo_compact");
+    vec_int_sbo_t v;
+    vec_init_sbo(&v);
+    vec_push(&v, 1);
+    test_assert(VEC_OK == vec_compact(&v) && v.data == v.sbo && vec_capacity(&v) == 8);
+    test_assert(VEC_OK == vec_reserve(&v, 4) && v.data == v.sbo);
+    test_assert(VEC_OK == vec_reserve(&v, 20) && v.data != v.sbo && vec_first(&v) == 1);
+    test_assert(VEC_OK == vec_compact(&v) && vec_capacity(&v) == 1 && vec_first(&v) == 1);
+    vec_deinit_sbo(&v);
+  }
+
+  { test_section("vec_sbo_swap_data");
+    vec_int_sbo_t a, b;
+    vec_int_t heap;
+    int ok = 1;
+    vec_init_sbo(&a);
+    vec_init_sbo(&b);
+    vec_init(&heap);
+    for (int i = 0; i < 5; ++i) vec_push(&a, i);
+    // inline elements are copied out, the source stays inline
+    vec_swap_data(&heap, &a);
+    test_assert(vec_length(&heap) == 5 && heap.data != a.sbo);
+    test_assert(vec_length(&a) == 0 && a.data == a.sbo && (a.options & VEC_SBO));
+    for (vec_size_t i = 0; i < 5; ++i) ok &= vec_get(&heap, i) == (int)i;
+    test_assert(ok);
+    vec_pusharr(&a, heap.data, 5);
+    vec_swap_data(&b, &a);
+    test_assert(vec_length(&b) == 5 && vec_get(&b, 4) == 4 && b.data != a.sbo);
+    // heap elements are handed over
+    vec_pusharr(&a, heap.data, 5);
+    vec_pusharr(&a, heap.data, 5);
+    test_assert(a.data != a.sbo);
+    vec_swap_data(&b, &a);
+    test_assert(vec_length(&b) == 10 && vec_get(&b, 9) == 4 && a.data == NULL);
+    vec_deinit(&b);
+    vec_deinit(&heap);
+  }
+
+  { test_section("vec_sbo_swap_data_oom");
+    vec_int_sbo_t a;
+    vec_int_t heap;
+    vec_init_sbo(&a);
+    vec_init(&heap);
+    for (int i = 0; i < 5; ++i) vec_push(&a, i);
+    // the copy can't be made, the elements stay in the source
+    set_fail_malloc(1);
+    vec_swap_data(&heap, &a);
+    set_fail_malloc(0);
+    test_assert(vec_length(&heap) == 0 && vec_oom(&heap));
+    test_assert(vec_length(&a) == 5 && a.data == a.sbo && vec_get(&a, 4) == 4);
+    vec_swap_data(&heap, &a);
+    test_assert(vec_length(&heap) == 5 && vec_get(&heap, 4) == 4 && vec_length(&a) == 0);
+    vec_deinit(&heap);
+  }
+
+  { test_section("vec_sbo_struct");
+    vec_item_sbo_t v;
+    sbo_item_t item = { 0, "ab" };
+    vec_init_sbo(&v);
+    test_assert(((uintptr_t)v.data % sizeof(short)) == 0);
+    for (short i = 0; i < 5; ++i) {
+      item.id = i;
+      vec_push(&v, item);
+    }
+    test_assert(v.data != v.sbo && vec_get(&v, 4).id == 4 && !strcmp(vec_get(&v, 0).tag, "ab"));
+    vec_deinit_sbo(&v);
+  }
+
+  { test_section("vec_sbo_oom");
+    vec_int_sbo_t v;
+    vec_init_sbo(&v);
+    for (int i = 0; i < 8; ++i) vec_push(&v, i);
+    set_fail_malloc(1);
+    test_assert(VEC_ERR == vec_push(&v, 8) && vec_oom(&v));
+    set_fail_malloc(0);
+    test_assert(v.data == v.sbo && vec_length(&v) == 8 && vec_last(&v) == 7);
+    vec_deinit_sbo(&v);
+  }
+
+  return 0;
+}
@@ -0,0 +1,176 @@
+/**
+ * Copyright (c) 2014 rxi (https://github.com/rxi/vec)
+ *
+ * v0.3.x modifications (c) 2022 Jacob Repp (https://github.com/jrepp/vec)
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the MIT license. See https://github.com/rxi/vec/LICENSE for details.
+ */
+
+#include "test_help.h"
+#include "vec_seg.h"
+
+typedef struct { vec_seg_define_fields(int) } seg_int_t;
+typedef struct { vec_seg_define_fields(double) } seg_double_t;
+
+typedef struct {
+  int id;
+  char tag[20];
+} seg_item_t;
+
+typedef struct { vec_seg_define_fields(seg_item_t) } seg_item_vec_t;
+typedef struct { vec_define_fields(seg_item_t) } vec_seg_item_t;
+
+static int seg_sum;
+
+static void seg_add(int x) {
+  seg_sum += x;
+}
+
+static void seg_scale(int *x, int by) {
+  *x *= by;
+}
+
+static double seg_half(int x) {
+  return x / 2.0;
+}
+
+static int seg_plus(int a, int b) {
+  return a + b;
+}
+
+int test_vec_seg() {
+  { test_section("vec_seg_push");
+    seg_int_t v;
+    int ok = 1;
+    vec_seg_init(&v);
+    test_assert(vec_seg_length(&v) == 0 && vec_seg_capacity(&v) == 0);
+    for (int i = 0; i < 10000; ++i) {
+      ok &= VEC_OK == vec_seg_push(&v, i);
+    }
+    test_assert(ok);
+    test_assert(vec_seg_length(&v) == 10000);
+    // segments of 64, 128, ... elements, the capacity is a whole number of them
+    test_assert(vec_seg_capacity(&v) == 64 * 255);
+    for (vec_size_t i = 0; i < 10000; ++i) ok &= vec_seg_get(&v, i) == (int)i;
+    test_assert(ok);
+    test_assert(vec_seg_pop(&v) == 9999);
+    test_assert(vec_seg_get(&v, 9998) == 9998);
+    vec_seg_deinit(&v);
+    test_assert(vec_seg_length(&v) == 0 && v.segments[0] == NULL);
+  }
+
+  { test_section("vec_seg_stable_addresses");
+    seg_int_t v;
+    int *first, *mid;
+    vec_seg_init(&v);
+    for (int i = 0; i < 100; ++i) vec_seg_push(&v, i);
+    first = vec_seg_get_ptr(&v, 0);
+    mid = vec_seg_get_ptr(&v, 99);
+    // growing never moves an element
+    for (int i = 100; i < 100000; ++i) vec_seg_push(&v, i);
+    test_assert(first == vec_seg_get_ptr(&v, 0) && *first == 0);
+    test_assert(mid == vec_seg_get_ptr(&v, 99) && *mid == 99);
+    vec_seg_clear(&v);
+    test_assert(vec_seg_length(&v) == 0 && vec_seg_capacity(&v) > 100000);
+    vec_seg_push(&v, 7);
+    test_assert(first == vec_seg_get_ptr(&v, 0) && *first == 7);
+    vec_seg_compact(&v);
+    test_assert(vec_seg_capacity(&v) == 64 && v.segments[1] == NULL);
+    test_assert(vec_seg_get(&v, 0) == 7);
+    vec_seg_pop(&v);
+    vec_seg_compact(&v);
+    test_assert(vec_seg_capacity(&v) == 0 && v.segments[0] == NULL);
+    vec_seg_deinit(&v);
+  }
+
+  { test_section("vec_seg_reserve");
+    seg_int_t v;
+    vec_seg_init(&v);
+    test_assert(VEC_OK == vec_seg_reserve(&v, 0));
+    test_assert(VEC_OK == vec_seg_reserve(&v, 65));
+    test_assert(vec_seg_capacity(&v) == 192);
+    test_assert(VEC_OK == vec_seg_reserve(&v, 192));
+    test_assert(vec_seg_capacity(&v) == 192 && v.segments[2] == NULL);
+    set_fail_malloc(1);
+    test_assert(VEC_ERR_NO_MEMORY == vec_seg_reserve(&v, 193));
+    for (int i = 0; i < 192; ++i) vec_seg_push(&v, i);
+    test_assert(VEC_ERR == vec_seg_push(&v, 192));
+    set_fail_malloc(0);
+    test_assert(vec_seg_length(&v) == 192);
+    test_assert(VEC_OK == vec_seg_push(&v, 192));
+    test_assert(vec_seg_get(&v, 192) == 192);
+    vec_seg_deinit(&v);
+  }
+
+  { test_section("vec_seg_iterate");
+    seg_int_t v;
+    seg_double_t halves;
+    vec_size_t iter, count = 0;
+    int x, *p, ok = 1, total = 0;
+    vec_seg_init(&v);
+    vec_seg_init(&halves);
+    vec_seg_foreach(&v, x, iter) {
+      ++count;
+    }
+    test_assert(count == 0);
+    for (int i = 0; i < 1000; ++i) vec_seg_push(&v, i);
+
+    vec_seg_foreach(&v, x, iter) {
+      ok &= x == (int)iter;
+      ++count;
+    }
+    test_assert(ok && count == 1000);
+    vec_seg_foreach_ptr(&v, p, iter) {
+      ok &= p == vec_seg_get_ptr(&v, iter);
+      if (iter == 500) break;
+    }
+    test_assert(ok && iter == 500);
+
+    seg_sum = 0;
+    vec_seg_each(&v, seg_add);
+    test_assert(seg_sum == 999 * 1000 / 2);
+    vec_seg_each_ptr(&v, seg_scale, 3);
+    test_assert(vec_seg_get(&v, 999) == 2997);
+
+    vec_seg_fold(&v, total, seg_plus);
+    test_assert(total == 3 * 999 * 1000 / 2);
+
+    vec_seg_map(&halves, &v, seg_half);
+    test_assert(vec_seg_length(&halves) == 1000);
+    for (vec_size_t i = 0; i < 1000; ++i) ok &= vec_seg_get(&halves, i) == i * 1.5;
+    test_assert(ok);
+    vec_seg_deinit(&v);
+    vec_seg_deinit(&halves);
+  }
+
+  { test_section("vec_seg_flatten");
+    seg_item_vec_t v;
+    vec_seg_item_t flat;
+    seg_item_t item;
+    int ok = 1;
+    vec_seg_init(&v);
+    vec_init(&flat);
+    memset(&item, 0, sizeof(item));
+    strcpy(item.tag, "seg");
+    for (int i = 0; i < 500; ++i) {
+      item.id = i;
+      ok &= VEC_OK == vec_seg_push(&v, item);
+    }
+    test_assert(ok);
+    // flatten appends to what the vector already holds
+    item.id = -1;
+    vec_push(&flat, item);
+    test_assert(VEC_OK == vec_seg_flatten(&v, &flat));
+    test_assert(flat.length == 501 && flat.data[0].id == -1);
+    for (vec_size_t i = 0; i < 500; ++i) {
+      ok &= flat.data[i + 1].id == (int)i && !strcmp(flat.data[i + 1].tag, "seg");
+      ok &= flat.data[i + 1].id == vec_seg_get_ptr(&v, i)->id;
+    }
+    test_assert(ok);
+    vec_seg_deinit(&v);
+    vec_deinit(&flat);
+  }
+
+  return 0;
+}
@@ -0,0 +1,151 @@
+/**
+ * Copyright (c) 2014 rxi (https://github.com/rxi/vec)
+ *
+ * v0.3.x modifications (c) 2022 Jacob Repp (https://github.com/jrepp/vec)
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the MIT license. See https://github.com/rxi/vec/LICENSE for details.
+ */
+
+#include "test_help.h"
+#include "vec_soa.h"
+
+VEC_DEFINE_SOA(soa_particles, (float, x), (float, y), (uint32_t, id), (uint8_t, alive))
+VEC_DEFINE_SOA(soa_single, (int64_t, value))
+
+static float soa_sum_x;
+
+static void soa_add(float x) {
+  soa_sum_x += x;
+}
+
+static float soa_scale(float x, float by) {
+  return x * by;
+}
+
+static double soa_widen(uint32_t id) {
+  return id + 0.5;
+}
+
+static uint64_t soa_plus(uint64_t acc, uint32_t id) {
+  return acc + id;
+}
+
+static soa_particles_row_t soa_row(uint32_t i) {
+  soa_particles_row_t row;
+  row.x = (float)i;
+  row.y = (float)i * 2;
+  row.id = i;
+  row.alive = (uint8_t)(i & 1);
+  return row;
+}
+
+static int soa_row_is(const soa_particles_t *v, vec_size_t idx, uint32_t i) {
+  soa_particles_row_t row = soa_particles_get(v, idx);
+  return row.x == (float)i && row.y == (float)i * 2 && row.id == i && row.alive == (i & 1);
+}
+
+int test_vec_soa() {
+  { test_section("vec_soa_push");
+    soa_particles_t v;
+    int ok = 1;
+    soa_particles_init(&v);
+    test_assert(vec_length(&v) == 0 && v.x == NULL);
+    for (uint32_t i = 0; i < 1000; ++i) ok &= VEC_OK == soa_particles_push(&v, soa_row(i));
+    test_assert(ok && vec_length(&v) == 1000);
+    for (uint32_t i = 0; i < 1000; ++i) ok &= soa_row_is(&v, i, i);
+    test_assert(ok);
+    test_assert(v.id[999] == 999 && v.alive[999] == 1);
+    // the columns follow each other in one allocation
+    test_assert((uint8_t *)v.y == (uint8_t *)v.x + ((v.capacity * sizeof(float) + 63) & ~(size_t)63));
+    test_assert(((uint8_t *)v.id - (uint8_t *)v.x) % VEC_SOA_ALIGN == 0);
+    test_assert(((uint8_t *)v.alive - (uint8_t *)v.x) % VEC_SOA_ALIGN == 0);
+    soa_particles_set(&v, 10, soa_row(77));
+    test_assert(soa_row_is(&v, 10, 77));
+    vec_clear(&v);
+    test_assert(vec_length(&v) == 0 && vec_capacity(&v) >= 1000);
+    soa_particles_deinit(&v);
+    test_assert(v.x == NULL && v.alive == NULL && vec_capacity(&v) == 0);
+  }
+
+  { test_section("vec_soa_reserve");
+    soa_particles_t v;
+    uint8_t *x;
+    soa_particles_init(&v);
+    test_assert(VEC_OK == soa_particles_reserve(&v, 100));
+    test_assert(vec_capacity(&v) == 100);
+    x = (uint8_t *)v.x;
+    for (uint32_t i = 0; i < 100; ++i) soa_particles_push(&v, soa_row(i));
+    test_assert((uint8_t *)v.x == x);
+    test_assert(VEC_OK == soa_particles_reserve(&v, 50));
+    test_assert(VEC_OK == soa_particles_reserve(&v, 300));
+    test_assert(vec_capacity(&v) == 300 && soa_row_is(&v, 99, 99));
+    set_fail_malloc(1);
+    test_assert(VEC_ERR_NO_MEMORY == soa_particles_reserve(&v, 1000));
+    for (uint32_t i = 100; i < 300; ++i) soa_particles_push(&v, soa_row(i));
+    test_assert(VEC_ERR == soa_particles_push(&v, soa_row(300)));
+    set_fail_malloc(0);
+    test_assert(vec_length(&v) == 300 && soa_row_is(&v, 299, 299));
+    soa_particles_deinit(&v);
+  }
+
+  { test_section("vec_soa_splice");
+    soa_particles_t v;
+    soa_particles_init(&v);
+    for (uint32_t i = 0; i < 10; ++i) soa_particles_push(&v, soa_row(i));
+    soa_particles_swap(&v, 0, 9);
+    test_assert(soa_row_is(&v, 0, 9) && soa_row_is(&v, 9, 0));
+    soa_particles_swap(&v, 0, 9);
+    soa_particles_splice(&v, 2, 3);
+    test_assert(vec_length(&v) == 7);
+    test_assert(soa_row_is(&v, 1, 1) && soa_row_is(&v, 2, 5) && soa_row_is(&v, 6, 9));
+    soa_particles_swapsplice(&v, 0, 2);
+    test_assert(vec_length(&v) == 5);
+    test_assert(soa_row_is(&v, 0, 8) && soa_row_is(&v, 1, 9) && soa_row_is(&v, 2, 5));
+    soa_particles_deinit(&v);
+  }
+
+  { test_section("vec_soa_columns");
+    soa_particles_t v;
+    vec_double_t widened;
+    uint64_t total = 0;
+    int ok = 1;
+    soa_particles_init(&v);
+    vec_init(&widened);
+    for (uint32_t i = 0; i < 100; ++i) soa_particles_push(&v, soa_row(i));
+
+    soa_sum_x = 0;
+    vec_soa_each(&v, x, soa_add);
+    test_assert(soa_sum_x == 4950);
+
+    vec_soa_apply(&v, y, soa_scale, 0.5f);
+    for (vec_size_t i = 0; i < 100; ++i) ok &= v.y[i] == (float)i && v.x[i] == (float)i;
+    test_assert(ok);
+
+    vec_soa_fold(&v, id, total, soa_plus);
+    test_assert(total == 4950);
+
+    vec_soa_map(&widened, &v, id, soa_widen);
+    test_assert(vec_length(&widened) == 100);
+    for (vec_size_t i = 0; i < 100; ++i) ok &= widened.data[i] == i + 0.5;
+    test_assert(ok);
+    vec_deinit(&widened);
+    soa_particles_deinit(&v);
+  }
+
+  { test_section("vec_soa_single");
+    soa_single_t v;
+    soa_single_row_t row;
+    soa_single_init(&v);
+    for (int64_t i = 0; i < 20; ++i) {
+      row.value = -i;
+      soa_single_push(&v, row);
+    }
+    test_assert(soa_single_get(&v, 19).value == -19);
+    soa_single_splice(&v, 0, 19);
+    test_assert(vec_length(&v) == 1 && v.value[0] == -19);
+    soa_single_deinit(&v);
+  }
+
+  return 0;
+}
@@ -0,0 +1,471 @@
+/**
+ * Copyright (c) 2014 rxi (https://github.com/rxi/vec)
+ *
+ * v0.3.x modifications (c) 2022 Jacob Repp (https://github.com/jrepp/vec)
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the MIT license. See https://github.com/rxi/vec/LICENSE for details.
+ */
+
+#include "test_help.h"
+
+static uint64_t test_rand(uint64_t *state) {
+  uint64_t x = *state;
+  x ^= x >> 12;
+  x ^= x << 25;
+  x ^= x >> 27;
+  *state = x;
+  return x * 0x2545f4914f6cdd1dull;
+}
+
+// Random values of every magnitude and sign, with runs of duplicates
+#define TEST_DEFINE_SORT_CHECK(name, V, T, gen)                              \
+  static int cmp_##name(const void *a_, const void *b_) {                    \
+    T a = *(const T *)a_, b = *(const T *)b_;                                \
+    return a < b ? -1 : a > b;                                               \
+  }                                                                          \
+                                                                             \
+  static int check_radix_##name(size_t n, int spare) {                       \
+    V v, expect;                                                             \
+    uint64_t seed = 0x9e3779b97f4a7c15ull + n;                               \
+    int ok = 1;                                                              \
+    vec_init(&v);                                                            \
+    vec_init(&expect);                                                       \
+    vec_reserve(&v, spare ? n * 2 : n);                                      \
+    for (size_t i = 0; i < n; ++i) {                                         \
+      uint64_t r = test_rand(&seed);                                         \
+      T x = (T)(gen);                                                        \
+      vec_push(&v, x);                                                       \
+      vec_push(&expect, x);                                                  \
+    }                                                                        \
+    if (n > 0) vec_sort(&expect, cmp_##name);                                \
+    ok &= VEC_OK == vec_sort_radix(&v);                                      \
+    ok &= v.length == n;                                                     \
+    for (size_t i = 0; i < n; ++i) {                                         \
+      ok &= v.data[i] == expect.data[i];                                     \
+    }                                                                        \
+    vec_deinit(&v);                                                          \
+    vec_deinit(&expect);                                                     \
+    return ok;                                                               \
+  }                                                                          \
+                                                                             \
+  static int check_radix_lengths_##name(void) {                              \
+    static const size_t lengths[] = { 0, 1, 2, 31, 32, 33, 100, 1000, 4099 }; \
+    int ok = 1;                                                              \
+    for (size_t i = 0; i < vec_countof(lengths); ++i) {                      \
+      ok &= check_radix_##name(lengths[i], 0);                               \
+      ok &= check_radix_##name(lengths[i], 1);                               \
+    }                                                                        \
+    return ok;                                                               \
+  }
+
+TEST_DEFINE_SORT_CHECK(u8, vec_uint8_t, uint8_t, r)
+TEST_DEFINE_SORT_CHECK(char, vec_char_t, char, r % 7 ? r : 0)
+TEST_DEFINE_SORT_CHECK(int, vec_int_t, int, (r & 1) ? (int64_t)r >> (r & 31) : (int64_t)(r % 100) - 50)
+TEST_DEFINE_SORT_CHECK(i32, vec_int32_t, int32_t, r >> (r & 31))
+TEST_DEFINE_SORT_CHECK(u32, vec_uint32_t, uint32_t, r >> (r & 31))
+TEST_DEFINE_SORT_CHECK(i64, vec_int64_t, int64_t, (int64_t)r >> (r & 63))
+TEST_DEFINE_SORT_CHECK(u64, vec_uint64_t, uint64_t, r >> (r & 63))
+TEST_DEFINE_SORT_CHECK(f32, vec_float_t, float, ((int64_t)r >> (r & 63)) / 3.0f)
+TEST_DEFINE_SORT_CHECK(f64, vec_double_t, double, ((int64_t)r >> (r & 63)) / 7.0)
+
+typedef struct {
+  int key;
+  int seq;
+  char name[24];
+} sort_item_t;
+
+typedef struct { vec_define_fields(sort_item_t) } vec_sort_item_t;
+
+VEC_DEFINE_SORT(sort_int, int, *a < *b)
+VEC_DEFINE_SORT(sort_item, sort_item_t, a->key < b->key || (a->key == b->key && a->seq < b->seq))
+
+static int cmp_sort_int(const void *a_, const void *b_) {
+  int a = *(const int *)a_, b = *(const int *)b_;
+  return a < b ? -1 : a > b;
+}
+
+static int cmp_sort_item(const void *a_, const void *b_) {
+  const sort_item_t *a = a_, *b = b_;
+  if (a->key != b->key) return a->key < b->key ? -1 : 1;
+  return a->seq < b->seq ? -1 : a->seq > b->seq;
+}
+
+// Inputs that defeat naive pivot choices, `m` bounds the number of distinct values
+static int make_pattern(int pattern, size_t i, size_t n, size_t m, uint64_t *seed) {
+  switch (pattern) {
+  case 0: return (int)(test_rand(seed) % m);
+  case 1: return (int)i;
+  case 2: return (int)(n - i);
+  case 3: return (int)(i < n / 2 ? i : n - i);
+  case 4: return (int)(i % m);
+  case 5: return (int)(i % 2 ? i : n - i);
+  case 6: return (int)(i + 1 == n ? 0 : i);
+  default: return 7;
+  }
+}
+
+static int check_sort_inline(int pattern, size_t n, size_t m) {
+  vec_int_t v, expect;
+  vec_sort_item_t items, expect_items;
+  uint64_t seed = 0x2545f4914f6cdd1dull + n;
+  int ok = 1;
+  vec_init(&v);
+  vec_init(&expect);
+  vec_init(&items);
+  vec_init(&expect_items);
+  for (size_t i = 0; i < n; ++i) {
+    sort_item_t item;
+    int x = make_pattern(pattern, i, n, m, &seed);
+    vec_push(&v, x);
+    vec_push(&expect, x);
+    memset(&item, 0, sizeof(item));
+    item.key = x;
+    item.seq = (int)(test_rand(&seed) % 1000);
+    vec_push(&items, item);
+    vec_push(&expect_items, item);
+  }
+  // qsort requires a non-null array even when empty
+  if (n > 0) {
+    vec_sort(&expect, cmp_sort_int);
+    vec_sort(&expect_items, cmp_sort_item);
+  }
+  vec_sort_inline(&v, sort_int);
+  vec_sort_inline(&items, sort_item);
+  for (size_t i = 0; i < n; ++i) {
+    ok &= v.data[i] == expect.data[i];
+    ok &= 0 == cmp_sort_item(&items.data[i], &expect_items.data[i]);
+  }
+  vec_deinit(&v);
+  vec_deinit(&expect);
+  vec_deinit(&items);
+  vec_deinit(&expect_items);
+  return ok;
+}
+
+static int cmp_sort_item_key(const void *a_, const void *b_) {
+  const sort_item_t *a = a_, *b = b_;
+  return a->key < b->key ? -1 : a->key > b->key;
+}
+
+// Every bound agrees with a linear scan for keys below, between, on and above the values
+static int check_bounds(size_t n) {
+  vec_int_t v;
+  vec_sort_item_t items;
+  int ok = 1;
+  vec_init(&v);
+  vec_init(&items);
+  for (size_t i = 0; i < n; ++i) {
+    sort_item_t item;
+    memset(&item, 0, sizeof(item));
+    item.key = (int)(i / 3) * 2;
+    vec_push(&v, item.key);
+    vec_push(&items, item);
+  }
+  for (int key = -1; key <= (int)(n / 3) * 2 + 1; ++key) {
+    vec_size_t lower = 0, upper = 0, first, last, idx;
+    sort_item_t probe;
+    while (lower < n && v.data[lower] < key) ++lower;
+    upper = lower;
+    while (upper < n && v.data[upper] == key) ++upper;
+
+    vec_lower_bound(&v, key, idx);
+    ok &= idx == lower;
+    vec_upper_bound(&v, key, idx);
+    ok &= idx == upper;
+    vec_equal_range(&v, key, first, last);
+    ok &= first == lower && last == upper;
+    ok &= vec_int_lower_bound(&v, key) == lower;
+    ok &= vec_int_upper_bound(&v, key) == upper;
+
+    probe.key = key;
+    vec_lower_bound_cmp(&items, &probe, idx, cmp_sort_item_key);
+    ok &= idx == lower;
+    vec_upper_bound_cmp(&items, &probe, idx, cmp_sort_item_key);
+    ok &= idx == upper;
+    vec_equal_range_cmp(&items, &probe, first, last, cmp_sort_item_key);
+    ok &= first == lower && last == upper;
+  }
+  vec_deinit(&v);
+  vec_deinit(&items);
+  return ok;
+}
+
+// Every probe in the Eytzinger layout lands on the lower bound of the sorted vector
+static int check_eytzinger(size_t n) {
+  vec_int_t v, e, back;
+  vec_sort_item_t items, eitems;
+  int ok = 1;
+  vec_init(&v);
+  vec_init(&e);
+  vec_init(&back);
+  vec_init(&items);
+  vec_init(&eitems);
+  for (size_t i = 0; i < n; ++i) {
+    sort_item_t item;
+    memset(&item, 0, sizeof(item));
+    item.key = (int)(i / 3) * 2;
+    item.seq = (int)i;
+    vec_push(&v, item.key);
+    vec_push(&items, item);
+  }
+  ok &= VEC_OK == vec_eytzinger_build(&e, &v);
+  ok &= VEC_OK == vec_eytzinger_build(&eitems, &items);
+  ok &= e.length == n && eitems.length == n;
+  for (size_t k = 2; k <= n; ++k) {
+    // parents order their children
+    ok &= k & 1 ? e.data[k / 2 - 1] <= e.data[k - 1] : e.data[k - 1] <= e.data[k / 2 - 1];
+  }
+  for (int key = -1; key <= (int)(n / 3) * 2 + 1; ++key) {
+    vec_size_t lower = 0, idx;
+    sort_item_t probe;
+    while (lower < n && v.data[lower] < key) ++lower;
+
+    vec_eytzinger_search(&e, key, idx);
+    ok &= lower == n ? idx == VEC_NOT_FOUND : idx < n && e.data[idx] == v.data[lower];
+
+    probe.key = key;
+    vec_eytzinger_search_cmp(&eitems, &probe, idx, cmp_sort_item_key);
+    ok &= lower == n ? idx == VEC_NOT_FOUND : idx < n && eitems.data[idx].seq == (int)lower;
+  }
+  ok &= VEC_OK == vec_eytzinger_sorted(&back, &e);
+  ok &= back.length == n && (n == 0 || 0 == memcmp(back.data, v.data, n * sizeof(int)));
+  vec_deinit(&v);
+  vec_deinit(&e);
+  vec_deinit(&back);
+  vec_deinit(&items);
+  vec_deinit(&eitems);
+  return ok;
+}
+
+// Batches of random and of sorted keys find the first index of each present key
+static int check_bsearch_batch(size_t n, size_t nkeys, int sorted_keys) {
+  vec_int_t v;
+  int *keys = malloc((nkeys + 1) * sizeof(int));
+  vec_size_t *out = malloc((nkeys + 1) * sizeof(vec_size_t));
+  vec_size_t found = 0;
+  uint64_t seed = n * 31 + nkeys;
+  int ok = keys != NULL && out != NULL;
+  vec_init(&v);
+  for (size_t i = 0; i < n; ++i) vec_push(&v, (int)(i / 3) * 2);
+  for (size_t i = 0; ok && i < nkeys; ++i) {
+    keys[i] = (int)(test_rand(&seed) % (2 * (n / 3) + 4)) - 1;
+  }
+  if (ok && sorted_keys && nkeys > 0) qsort(keys, nkeys, sizeof(int), cmp_sort_int);
+  if (ok) {
+    vec_size_t hits = vec_bsearch_batch(&v, keys, nkeys, out, cmp_sort_int);
+    for (size_t i = 0; i < nkeys; ++i) {
+      vec_size_t lower = 0;
+      while (lower < n && v.data[lower] < keys[i]) ++lower;
+      if (lower < n && v.data[lower] == keys[i]) {
+        ok &= out[i] == lower;
+        found++;
+      } else {
+        ok &= out[i] == VEC_NOT_FOUND;
+      }
+    }
+    ok &= hits == found;
+  }
+  vec_deinit(&v);
+  free(keys);
+  free(out);
+  return ok;
+}
+
+// Haystacks above VEC_BSEARCH_LOCKSTEP_BYTES with too few keys to merge take the lockstep
+// search, the values are distinct so it agrees with vec_bsearch
+static int check_bsearch_batch_lockstep(size_t n, size_t nkeys) {
+  vec_int_t v;
+  int *keys = malloc((nkeys + 1) * sizeof(int));
+  vec_size_t *out = malloc((nkeys + 1) * sizeof(vec_size_t));
+  vec_size_t found = 0;
+  uint64_t seed = n * 17 + nkeys;
+  int ok = keys != NULL && out != NULL;
+  vec_init(&v);
+  ok &= VEC_OK == vec_reserve(&v, n);
+  for (size_t i = 0; ok && i < n; ++i) vec_push(&v, (int)i * 2);
+  for (size_t i = 0; ok && i < nkeys; ++i) {
+    keys[i] = (int)(test_rand(&seed) % (2 * n + 2)) - 1;
+  }
+  if (ok) {
+    vec_size_t hits = vec_bsearch_batch(&v, keys, nkeys, out, cmp_sort_int);
+    for (size_t i = 0; i < nkeys; ++i) {
+      vec_size_t idx;
+      vec_bsearch(&v, &keys[i], &idx, cmp_sort_int);
+      ok &= out[i] == idx;
+      found += idx != VEC_NOT_FOUND;
+    }
+    ok &= hits == found && found > 0 && found < nkeys;
+  }
+  vec_deinit(&v);
+  free(keys);
+  free(out);
+  return ok;
+}
+
+int test_vec_sort() {
+  { test_section("vec_sort_radix");
+    test_assert(check_radix_lengths_u8());
+    test_assert(check_radix_lengths_char());
+    test_assert(check_radix_lengths_int());
+    test_assert(check_radix_lengths_i32());
+    test_assert(check_radix_lengths_u32());
+    test_assert(check_radix_lengths_i64());
+    test_assert(check_radix_lengths_u64());
+    test_assert(check_radix_lengths_f32());
+    test_assert(check_radix_lengths_f64());
+  }
+
+  { test_section("vec_sort_radix_float_order");
+    vec_double_t v;
+    vec_init(&v);
+    for (int i = 0; i < 20; ++i) {
+      vec_push(&v, 1.0 / (i - 10));
+      vec_push(&v, -0.0);
+      vec_push(&v, 0.0);
+    }
+    test_assert(VEC_OK == vec_sort_radix(&v));
+    test_assert(v.data[0] == -1.0);
+    test_assert(v.data[v.length - 1] == 1.0 / 0.0);
+    int ordered = 1;
+    for (size_t i = 1; i < v.length; ++i) {
+      ordered &= v.data[i - 1] <= v.data[i];
+      // -0.0 sorts before 0.0
+      ordered &= !(v.data[i - 1] == 0.0 && v.data[i] == 0.0 &&
+                   1.0 / v.data[i - 1] > 0.0 && 1.0 / v.data[i] < 0.0);
+    }
+    test_assert(ordered);
+    vec_deinit(&v);
+  }
+
+  { test_section("vec_sort_inline");
+    static const size_t lengths[] = { 0, 1, 2, 3, 24, 25, 129, 1000, 10007 };
+    int ok = 1;
+    for (int pattern = 0; pattern < 8; ++pattern) {
+      for (size_t i = 0; i < vec_countof(lengths); ++i) {
+        ok &= check_sort_inline(pattern, lengths[i], 1000000);
+        ok &= check_sort_inline(pattern, lengths[i], 3);
+      }
+    }
+    test_assert(ok);
+  }
+
+  { test_section("vec_sort_inline_heap");
+    // the worst case fallback on its own
+    int values[1000];
+    uint64_t seed = 7;
+    int ordered = 1;
+    for (int i = 0; i < 1000; ++i) values[i] = (int)(test_rand(&seed) % 100);
+    sort_int_sort_heap_(values, vec_countof(values));
+    for (int i = 1; i < 1000; ++i) ordered &= values[i - 1] <= values[i];
+    test_assert(ordered);
+  }
+
+  { test_section("vec_lower_bound");
+    int ok = 1;
+    for (size_t n = 0; n < 70; ++n) ok &= check_bounds(n);
+    ok &= check_bounds(1000);
+    ok &= check_bounds(4097);
+    test_assert(ok);
+  }
+
+  { test_section("vec_lower_bound_insert");
+    // the lower bound keeps the vector sorted without a second scan
+    vec_int_t v;
+    vec_size_t idx;
+    uint64_t seed = 11;
+    int ordered = 1;
+    vec_init(&v);
+    for (int i = 0; i < 500; ++i) {
+      int x = (int)(test_rand(&seed) % 200);
+      vec_lower_bound(&v, x, idx);
+      vec_insert(&v, idx, x);
+    }
+    for (size_t i = 1; i < v.length; ++i) ordered &= v.data[i - 1] <= v.data[i];
+    test_assert(ordered);
+    test_assert(v.length == 500);
+    vec_deinit(&v);
+  }
+
+  { test_section("vec_eytzinger");
+    int ok = 1;
+    for (size_t n = 0; n < 70; ++n) ok &= check_eytzinger(n);
+    ok &= check_eytzinger(1000);
+    ok &= check_eytzinger(4097);
+    test_assert(ok);
+  }
+
+  { test_section("vec_eytzinger_bytes");
+    // one byte elements round trip through the layout
+    vec_uint8_t v, e, back;
+    vec_size_t idx;
+    vec_init(&v);
+    vec_init(&e);
+    vec_init(&back);
+    for (int i = 0; i < 200; ++i) vec_push(&v, (uint8_t)i);
+    test_assert(VEC_OK == vec_eytzinger_build(&e, &v));
+    test_assert(e.data[0] == 127);
+    vec_eytzinger_search(&e, 42, idx);
+    test_assert(idx != VEC_NOT_FOUND && e.data[idx] == 42);
+    vec_eytzinger_search(&e, 255, idx);
+    test_assert(idx == VEC_NOT_FOUND);
+    test_assert(VEC_OK == vec_eytzinger_sorted(&back, &e));
+    test_assert(back.length == 200 && 0 == memcmp(back.data, v.data, 200));
+    vec_deinit(&v);
+    vec_deinit(&e);
+    vec_deinit(&back);
+  }
+
+  { test_section("vec_bsearch_batch");
+    int ok = 1;
+    for (size_t n = 0; n < 40; ++n) {
+      ok &= check_bsearch_batch(n, 37, 0);
+      ok &= check_bsearch_batch(n, 37, 1);
+    }
+    ok &= check_bsearch_batch(1000, 0, 0);
+    ok &= check_bsearch_batch(1000, 1, 0);
+    ok &= check_bsearch_batch(1000, 500, 0);
+    ok &= check_bsearch_batch(1000, 500, 1);
+    ok &= check_bsearch_batch(100000, 100, 1);
+    ok &= check_bsearch_batch(5000, 20000, 1);
+    test_assert(ok);
+    test_assert(check_bsearch_batch_lockstep(300000, 1000));
+    test_assert(check_bsearch_batch_lockstep(300001, 37));
+  }
+
+  { test_section("vec_bsearch_batch_struct");
+    vec_sort_item_t items;
+    sort_item_t keys[3];
+    vec_size_t out[3];
+    vec_init(&items);
+    for (int i = 0; i < 100; ++i) {
+      sort_item_t item;
+      memset(&item, 0, sizeof(item));
+      item.key = i / 2;
+      item.seq = i;
+      vec_push(&items, item);
+    }
+    memset(keys, 0, sizeof(keys));
+    keys[0].key = 30;
+    keys[1].key = 7;
+    keys[2].key = 60;
+    test_assert(2 == vec_bsearch_batch(&items, keys, 3, out, cmp_sort_item_key));
+    test_assert(out[0] == 60 && out[1] == 14 && out[2] == VEC_NOT_FOUND);
+    vec_deinit(&items);
+  }
+
+  { test_section("vec_sort_radix_scratch");
+    vec_int_t v;
+    test_stats_t stats = *stats_;
+    vec_init(&v);
+    vec_reserve(&v, 2000);
+    for (int i = 0; i < 1000; ++i) vec_push(&v, 1000 - i);
+    // the spare capacity is large enough, no allocation
+    test_assert(VEC_OK == vec_sort_radix(&v));
+    test_assert(stats_->malloc_count == stats.malloc_count + 1);
+    test_assert(v.data[0] == 1 && v.data[999] == 1000);
+    vec_deinit(&v);
+  }
+
+  return 0;
+}
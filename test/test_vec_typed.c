@@ -0,0 +1,150 @@
+/**
+ * Copyright (c) 2014 rxi (https://github.com/rxi/vec)
+ *
+ * v0.3.x modifications (c) 2022 Jacob Repp (https://github.com/jrepp/vec)
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the MIT license. See https://github.com/rxi/vec/LICENSE for details.
+ */
+
+#include "test_help.h"
+
+typedef struct {
+  int a;
+  int b;
+} pair_t;
+
+// Struct elements have no `==` so only the general functions are generated
+VEC_DECLARE_TYPE(pair_t, vec_pair)
+VEC_DEFINE_TYPE(pair_t, vec_pair)
+
+static int32_t twice(int32_t x) {
+  return x * 2;
+}
+
+static int32_t add(int32_t acc, int32_t x) {
+  return acc + x;
+}
+
+int test_vec_typed() {
+  { test_section("typed_push");
+    vec_int32_t v;
+    vec_init(&v);
+    for (int32_t i = 0; i < 1000; i++) vec_int32_push(&v, i * 2);
+    test_assert(vec_length(&v) == 1000);
+    test_assert(v.data[1] == 2);
+    test_assert(v.data[999] == 999 * 2);
+    test_assert(vec_int32_push(&v, 10) == VEC_OK);
+    vec_deinit(&v);
+    test_assert(stats_->memory == 0);
+  }
+
+  { test_section("typed_push_fixed");
+    int32_t arr[4];
+    vec_int32_t v;
+    vec_init_with_fixed(&v, arr, vec_countof(arr));
+    for (int32_t i = 0; i < 4; i++) test_assert(vec_int32_push(&v, i) == VEC_OK);
+    test_assert(vec_int32_push(&v, 4) == VEC_ERR);
+    test_assert(vec_length(&v) == 4);
+    vec_deinit(&v);
+  }
+
+  { test_section("typed_insert");
+    vec_int32_t v;
+    vec_init(&v);
+    for (int32_t i = 0; i < 100; i++) vec_int32_insert(&v, 0, i);
+    test_assert(v.data[0] == 99);
+    test_assert(v.data[v.length - 1] == 0);
+    vec_int32_insert(&v, 10, 123);
+    test_assert(v.data[10] == 123 && v.data[11] == 89);
+    vec_int32_insert(&v, v.length, 789);
+    test_assert(vec_last(&v) == 789);
+    test_assert(v.length == 102);
+    vec_deinit(&v);
+  }
+
+  { test_section("typed_splice");
+    vec_int32_t v;
+    vec_init(&v);
+    for (int32_t i = 0; i < 100; i++) vec_int32_push(&v, i);
+    vec_int32_splice(&v, 0, 10);
+    test_assert(v.data[0] == 10 && v.length == 90);
+    vec_int32_swapsplice(&v, 0, 3);
+    test_assert(v.data[0] == 97 && v.data[1] == 98 && v.data[2] == 99);
+    test_assert(v.length == 87);
+    vec_deinit(&v);
+  }
+
+  { test_section("typed_swap_reverse");
+    vec_double_t v;
+    vec_init(&v);
+    for (int i = 0; i < 5; i++) vec_double_push(&v, i);
+    vec_double_swap(&v, 0, 4);
+    test_assert(v.data[0] == 4 && v.data[4] == 0);
+    vec_double_reverse(&v);
+    test_assert(v.data[0] == 0 && v.data[1] == 3 && v.data[2] == 2 &&
+                v.data[3] == 1 && v.data[4] == 4);
+    vec_deinit(&v);
+  }
+
+  { test_section("typed_pusharr_extend");
+    int32_t a[5] = { 5, 6, 7, 8, 9 };
+    vec_int32_t v, v2;
+    vec_init(&v);
+    vec_init(&v2);
+    test_assert(vec_int32_pusharr(&v, a, 5) == VEC_OK);
+    test_assert(vec_int32_extend(&v2, &v) == VEC_OK);
+    test_assert(vec_int32_extend(&v2, &v2) == VEC_OK);
+    test_assert(v2.length == 10);
+    test_assert(v2.data[0] == 5 && v2.data[4] == 9 && v2.data[5] == 5 && v2.data[9] == 9);
+    // arr may point into the vector, also when the growth moves it
+    test_assert(vec_compact(&v) == VEC_OK && vec_capacity(&v) == 5);
+    test_assert(vec_int32_pusharr(&v, v.data + 1, 3) == VEC_OK);
+    test_assert(v.length == 8 && v.data[5] == 6 && v.data[7] == 8);
+    vec_deinit(&v);
+    vec_deinit(&v2);
+  }
+
+  { test_section("typed_map_fold");
+    vec_int32_t v, v2;
+    vec_init(&v);
+    vec_init(&v2);
+    for (int32_t i = 0; i < 32; i++) vec_int32_push(&v, i);
+    test_assert(vec_int32_map(&v2, &v, twice) == VEC_OK);
+    test_assert(v2.length == 32 && v2.data[31] == 62);
+    test_assert(vec_int32_fold(&v, 0, add) == 496);
+    test_assert(vec_int32_fold(&v2, 0, add) == 992);
+    vec_deinit(&v);
+    vec_deinit(&v2);
+  }
+
+  { test_section("typed_find");
+    vec_char_t v;
+    vec_init(&v);
+    for (int i = 0; i < 26; i++) vec_char_push(&v, (char)('a' + i));
+    vec_char_push(&v, 'a');
+    test_assert(vec_char_find(&v, 'a') == 0);
+    test_assert(vec_char_rfind(&v, 'a') == 26);
+    test_assert(vec_char_find(&v, 'z') == 25);
+    test_assert(vec_char_find(&v, '_') == VEC_NOT_FOUND);
+    test_assert(vec_char_rfind(&v, '_') == VEC_NOT_FOUND);
+    vec_deinit(&v);
+  }
+
+  { test_section("typed_struct");
+    vec_pair_t v;
+    vec_init(&v);
+    for (int i = 0; i < 10; i++) {
+      pair_t p = { i, -i };
+      vec_pair_push(&v, p);
+    }
+    vec_pair_reverse(&v);
+    test_assert(v.data[0].a == 9 && v.data[0].b == -9);
+    vec_pair_splice(&v, 0, 1);
+    test_assert(v.data[0].a == 8 && v.length == 9);
+    vec_deinit(&v);
+    test_assert(stats_->memory == 0);
+  }
+
+  return 0;
+}